@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "aac.h"
+#include "graph.h"
+#include "graphdb.h"
+#include "gmext.h"
+#include "beam_extension.h"
+#include "exact_extension.h"
+#include "timing.h"
+
+struct AacGraph {
+    Graph* graph;
+    pthread_mutex_t lock;       // serialises the lazy preparation below
+    PreparedPattern* pattern;   // built on first use as G, then read-only
+    PreparedHost* host;         // built on first use as H, then read-only
+};
+
+struct AacContext {
+    AacConfig config;
+    MatchScratch match;         // subgraph test buffers, reused across calls
+    int (*edges)[2];            // last extension's edges (AacResult.edges)
+    int edgeCap;
+};
+
+static const struct {
+    const char* name;
+    AacAlgorithm alg;
+} AAC_ALGORITHMS[] = {
+    { "subiso",    AAC_ALG_SUBISO },
+    { "greedy",    AAC_ALG_GREEDY },
+    { "greedy+ls", AAC_ALG_GREEDY_LS },
+    { "beam",      AAC_ALG_BEAM },
+    { "exact",     AAC_ALG_EXACT },
+};
+#define AAC_ALGORITHM_COUNT ((int)(sizeof(AAC_ALGORITHMS) / sizeof(AAC_ALGORITHMS[0])))
+
+int aacAlgorithmFromName(const char* name, AacAlgorithm* alg) {
+    if (!name || !alg) return AAC_ERR_INVALID;
+    for (int i = 0; i < AAC_ALGORITHM_COUNT; i++) {
+        if (strcmp(name, AAC_ALGORITHMS[i].name) == 0) {
+            *alg = AAC_ALGORITHMS[i].alg;
+            return AAC_OK;
+        }
+    }
+    return AAC_ERR_INVALID;
+}
+
+const char* aacAlgorithmName(AacAlgorithm alg) {
+    for (int i = 0; i < AAC_ALGORITHM_COUNT; i++) {
+        if (AAC_ALGORITHMS[i].alg == alg) return AAC_ALGORITHMS[i].name;
+    }
+    return "?";
+}
+
+const char* aacStatusString(int status) {
+    switch (status) {
+        case AAC_OK:              return "ok";
+        case AAC_ERR_INVALID:     return "invalid argument";
+        case AAC_ERR_NOMEM:       return "out of memory";
+        case AAC_ERR_NO_SOLUTION: return "no extension found";
+        default:                  return "unknown status";
+    }
+}
+
+// --- Contexts ---
+
+void aacConfigDefaults(AacConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->threads = 1;
+}
+
+AacContext* aacContextCreate(const AacConfig* config) {
+    AacContext* ctx = calloc(1, sizeof(AacContext));
+    if (!ctx) return NULL;
+    if (config) ctx->config = *config;
+    else aacConfigDefaults(&ctx->config);
+    return ctx;
+}
+
+void aacContextFree(AacContext* ctx) {
+    if (!ctx) return;
+    freeMatchScratch(&ctx->match);
+    free(ctx->edges);
+    free(ctx);
+}
+
+void aacContextGetConfig(const AacContext* ctx, AacConfig* config) {
+    *config = ctx->config;
+}
+
+void aacContextSetConfig(AacContext* ctx, const AacConfig* config) {
+    ctx->config = *config;
+}
+
+// --- Graphs ---
+
+static AacGraph* wrapGraph(Graph* graph) {
+    if (!graph) return NULL;
+    AacGraph* g = calloc(1, sizeof(AacGraph));
+    if (!g) {
+        freeGraph(graph);
+        return NULL;
+    }
+    g->graph = graph;
+    pthread_mutex_init(&g->lock, NULL);
+    return g;
+}
+
+// Fills adjacency lists from the matrix; returns -1 if memory runs out.
+static int buildAdjacency(Graph* g) {
+    for (int i = 0; i < g->n; i++) {
+        int degree = 0;
+        for (int j = 0; j < g->n; j++) degree += g->matrix[i][j] != 0;
+        g->adj[i] = degree > 0 ? malloc(degree * sizeof(int)) : NULL;
+        if (degree > 0 && !g->adj[i]) return -1;
+        for (int j = 0; j < g->n; j++) {
+            if (g->matrix[i][j]) g->adj[i][g->adjSize[i]++] = j;
+        }
+    }
+    return 0;
+}
+
+AacGraph* aacGraphFromEdges(int n, const int (*edges)[2], int m) {
+    if (n < 0 || m < 0 || (m > 0 && !edges)) return NULL;
+    for (int e = 0; e < m; e++) {
+        int u = edges[e][0], v = edges[e][1];
+        if (u < 0 || v < 0 || u >= n || v >= n || u == v) return NULL;
+    }
+
+    Graph* g = calloc(1, sizeof(Graph));
+    if (!g) return NULL;
+    g->n = n;
+    g->matrix = allocMatrix(n);
+    g->adj = calloc(n > 0 ? n : 1, sizeof(int*));
+    g->adjSize = calloc(n > 0 ? n : 1, sizeof(int));
+    if ((n > 0 && !g->matrix) || !g->adj || !g->adjSize) {
+        for (int i = 0; g->matrix && i < n; i++) free(g->matrix[i]);
+        free(g->matrix);
+        free(g->adj);
+        free(g->adjSize);
+        free(g);
+        return NULL;
+    }
+    for (int e = 0; e < m; e++) {
+        int u = edges[e][0], v = edges[e][1];
+        if (!g->matrix[u][v]) g->m++;
+        g->matrix[u][v] = g->matrix[v][u] = 1;
+    }
+    if (buildAdjacency(g) != 0) {
+        freeGraph(g);
+        return NULL;
+    }
+    return wrapGraph(g);
+}
+
+AacGraph* aacGraphParse(const char* text, size_t length) {
+    return wrapGraph(parseGraph(text, length));
+}
+
+AacGraph* aacGraphLoad(const char* path) {
+    return path ? wrapGraph(loadGraph(path)) : NULL;
+}
+
+void aacGraphFree(AacGraph* g) {
+    if (!g) return;
+    freePreparedPattern(g->pattern);
+    freePreparedHost(g->host);
+    pthread_mutex_destroy(&g->lock);
+    freeGraph(g->graph);
+    free(g);
+}
+
+int aacGraphVertices(const AacGraph* g) {
+    return g ? g->graph->n : 0;
+}
+
+int aacGraphEdges(const AacGraph* g) {
+    return g ? g->graph->m : 0;
+}
+
+// The prepared forms are published once with release semantics, so a
+// thread that sees the pointer also sees the finished structure.
+static const PreparedPattern* patternOf(const AacGraph* cg) {
+    AacGraph* g = (AacGraph*)cg;
+    PreparedPattern* p = __atomic_load_n(&g->pattern, __ATOMIC_ACQUIRE);
+    if (p) return p;
+    pthread_mutex_lock(&g->lock);
+    p = g->pattern;
+    if (!p) {
+        p = preparePattern(g->graph);
+        __atomic_store_n(&g->pattern, p, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&g->lock);
+    return p;
+}
+
+static const PreparedHost* hostOf(const AacGraph* cg) {
+    AacGraph* g = (AacGraph*)cg;
+    PreparedHost* h = __atomic_load_n(&g->host, __ATOMIC_ACQUIRE);
+    if (h) return h;
+    pthread_mutex_lock(&g->lock);
+    h = g->host;
+    if (!h) {
+        h = prepareHost(g->graph, NULL);
+        __atomic_store_n(&g->host, h, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&g->lock);
+    return h;
+}
+
+int aacGraphPrepareHost(const AacGraph* g) {
+    if (!g) return AAC_ERR_INVALID;
+    return hostOf(g) ? AAC_OK : AAC_ERR_NOMEM;
+}
+
+// --- Solving ---
+
+int aacContains(AacContext* ctx, const AacGraph* G, const AacGraph* H, bool* contains) {
+    if (!ctx || !G || !H || !contains) return AAC_ERR_INVALID;
+    const PreparedPattern* p = patternOf(G);
+    const PreparedHost* h = hostOf(H);
+    if (!p || !h) return AAC_ERR_NOMEM;
+    int found = preparedContainsWith(p, h, &ctx->match);
+    if (found < 0) return AAC_ERR_NOMEM;
+    *contains = found == 1;
+    return AAC_OK;
+}
+
+int aacCount(AacContext* ctx, const AacGraph* G, const AacGraph* H,
+             long long* count, bool* complete) {
+    if (!ctx || !G || !H || !count) return AAC_ERR_INVALID;
+    const PreparedPattern* p = patternOf(G);
+    const PreparedHost* h = hostOf(H);
+    if (!p || !h) return AAC_ERR_NOMEM;
+    long long found = preparedCountWith(p, h, &ctx->match, ctx->config.countLimit,
+                                        ctx->config.timeLimit, complete);
+    if (found < 0) return AAC_ERR_NOMEM;
+    *count = found;
+    return AAC_OK;
+}
+
+// Copies an extension's edges into the context's buffer.
+static int keepEdges(AacContext* ctx, AacResult* r, int newVertices, int (*edges)[2], int newEdges) {
+    if (newEdges > ctx->edgeCap) {
+        int (*grown)[2] = realloc(ctx->edges, newEdges * sizeof(*grown));
+        if (!grown) return AAC_ERR_NOMEM;
+        ctx->edges = grown;
+        ctx->edgeCap = newEdges;
+    }
+    if (newEdges > 0) memcpy(ctx->edges, edges, newEdges * sizeof(*edges));
+    r->solved = true;
+    r->newVertices = newVertices;
+    r->newEdges = newEdges;
+    r->edges = (const int (*)[2])ctx->edges;
+    return AAC_OK;
+}
+
+static int extend(AacContext* ctx, const Graph* G, const Graph* H, AacAlgorithm alg, AacResult* r) {
+    const AacConfig* c = &ctx->config;
+    int status = AAC_ERR_NO_SOLUTION;
+
+    if (alg == AAC_ALG_GREEDY || alg == AAC_ALG_GREEDY_LS) {
+        GreedyOptions gopts = {0};
+        gopts.restarts = c->restarts;
+        gopts.timeBudget = c->timeLimit;
+        gopts.threads = c->threads;
+        gopts.seed = c->seed;
+        gopts.assignmentSeed = c->assignmentSeed;
+        gopts.localSearch = alg == AAC_ALG_GREEDY_LS;
+        GreedyExtension* ext = greedy_extension_with_options((Graph*)G, (Graph*)H, &gopts);
+        if (ext) {
+            status = keepEdges(ctx, r, ext->newVertexCount, ext->newEdges, ext->newEdgeCount);
+            freeGreedyExtension(ext);
+        }
+    } else if (alg == AAC_ALG_BEAM) {
+        BeamOptions bopts = {0};
+        bopts.width = c->beamWidth;
+        bopts.threads = c->threads;
+        GreedyExtension* ext = beam_extension((Graph*)G, (Graph*)H, &bopts, NULL);
+        if (ext) {
+            status = keepEdges(ctx, r, ext->newVertexCount, ext->newEdges, ext->newEdgeCount);
+            freeGreedyExtension(ext);
+        }
+    } else if (c->timeLimit > 0) {
+        ExactOptions eopts = {0};
+        eopts.timeLimit = c->timeLimit;
+        eopts.isoCacheBytes = c->isoCacheBytes;
+        ExactAnytimeResult* res = exactMinimalExtensionAnytime(G, H, &eopts);
+        if (res && res->best) {
+            status = keepEdges(ctx, r, res->best->newVertexCount, res->best->newEdges,
+                               res->best->newEdgeCount);
+            r->lowerBound = res->lowerBound;
+            r->optimal = res->optimal;
+        }
+        freeExactAnytimeResult(res);
+    } else {
+        ExactOptions eopts = {0};
+        eopts.isoCacheBytes = c->isoCacheBytes;
+        Extension* ext = exactMinimalExtensionWithOptions(G, H, &eopts, NULL);
+        if (ext) {
+            status = keepEdges(ctx, r, ext->newVertexCount, ext->newEdges, ext->newEdgeCount);
+            r->optimal = true;
+            freeExtensionObject(ext);
+        }
+    }
+    return status;
+}
+
+int aacSolve(AacContext* ctx, const AacGraph* G, const AacGraph* H,
+             AacAlgorithm alg, AacResult* result) {
+    if (!ctx || !G || !H || !result) return AAC_ERR_INVALID;
+    if (alg < AAC_ALG_SUBISO || alg > AAC_ALG_EXACT) return AAC_ERR_INVALID;
+    double t0 = wallSeconds();
+    memset(result, 0, sizeof(*result));
+    result->lowerBound = -1;
+
+    int status = aacContains(ctx, G, H, &result->contains);
+    if (status == AAC_OK && result->contains) {
+        result->solved = true;
+        result->optimal = true;
+    } else if (status == AAC_OK && alg != AAC_ALG_SUBISO) {
+        status = extend(ctx, G->graph, H->graph, alg, result);
+    }
+    result->elapsed = wallSeconds() - t0;
+    return status;
+}
@@ -0,0 +1,138 @@
+#ifndef AAC_H
+#define AAC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * =============================================================================
+ * LIBAAC - EMBEDDING API
+ * =============================================================================
+ * The subgraph test and the extension solvers as a library (libaac.a /
+ * libaac.so), for programs that answer many requests in one process.
+ *
+ * Only this header is public. Graphs and contexts are opaque, and the
+ * structs below only grow at the end, so code compiled against an older
+ * version of this header keeps working (AAC_API_VERSION is bumped when
+ * something is added).
+ *
+ *   AacGraph   - an immutable graph. It may be shared between threads and
+ *                between contexts. The preprocessing the subgraph test
+ *                needs (matching order, CSR adjacency, bitsets, feature
+ *                counts) is built on first use and kept with the graph.
+ *   AacContext - solver settings plus scratch buffers that are reused from
+ *                call to call: the matcher's arrays and the buffer holding
+ *                the last extension. A context must not be used by two
+ *                threads at once; give each worker thread its own.
+ *
+ * Calls on different contexts are thread-safe and may run concurrently.
+ * The only process-wide state they share is the tracer (trace.h), which
+ * synchronizes itself: an atomic on/off flag, per-thread event buffers
+ * linked into a list by compare-and-swap, and an atexit flush. (The
+ * distance kernel is picked once under pthread_once and never changes;
+ * search counters are per thread.) Functions returning int return an
+ * AacStatus.
+ * =============================================================================
+ */
+
+#define AAC_API_VERSION 3
+
+#if defined(__GNUC__)
+#define AAC_API __attribute__((visibility("default")))
+#else
+#define AAC_API
+#endif
+
+typedef struct AacGraph AacGraph;
+typedef struct AacContext AacContext;
+
+typedef enum {
+    AAC_OK = 0,
+    AAC_ERR_INVALID = -1,      // NULL argument, bad vertex or unknown algorithm
+    AAC_ERR_NOMEM = -2,
+    AAC_ERR_NO_SOLUTION = -3   // the solver gave up (e.g. exact ran out of budget)
+} AacStatus;
+
+typedef enum {
+    AAC_ALG_SUBISO,            // subgraph test only
+    AAC_ALG_GREEDY,
+    AAC_ALG_GREEDY_LS,         // greedy + local search
+    AAC_ALG_BEAM,
+    AAC_ALG_EXACT
+} AacAlgorithm;
+
+typedef struct {
+    int threads;               // workers inside one call (greedy restarts, beam levels); <= 1 = caller's thread
+    double timeLimit;          // exact: anytime budget, greedy: restart budget, aacCount: cut-off; seconds (0 = none)
+    size_t isoCacheBytes;      // exact: verdict cache cap (0 = disabled)
+    int beamWidth;             // beam: partial mappings per level (0 = default)
+    int restarts;              // greedy: randomized restarts (0 = none)
+    unsigned long long seed;   // greedy: PRNG seed for restarts
+    long long countLimit;      // aacCount: stop after this many embeddings (0 = count all)
+    int assignmentSeed;        // greedy: also try the O(n^3) assignment-seeded mapping (0 = off)
+} AacConfig;
+
+typedef struct {
+    bool contains;             // G is already a subgraph of H
+    bool solved;               // an extension is reported (always when contains)
+    bool optimal;              // the extension is proven minimal
+    int lowerBound;            // exact with a time limit: proven lower bound (-1 otherwise)
+    int newVertices;           // added vertices, numbered n(H) .. n(H) + newVertices - 1
+    int newEdges;
+    const int (*edges)[2];     // the added edges; owned by the context, valid until its next call
+    double elapsed;            // wall-clock seconds
+} AacResult;
+
+/** Defaults: one thread, no budgets, no exact verdict cache, default beam width. */
+AAC_API void aacConfigDefaults(AacConfig* config);
+
+/** NULL config = aacConfigDefaults. Returns NULL if memory runs out. */
+AAC_API AacContext* aacContextCreate(const AacConfig* config);
+AAC_API void aacContextFree(AacContext* ctx);
+AAC_API void aacContextGetConfig(const AacContext* ctx, AacConfig* config);
+AAC_API void aacContextSetConfig(AacContext* ctx, const AacConfig* config);
+
+/**
+ * Graph constructors. FromEdges takes m undirected edges over vertices
+ * 0 .. n - 1 (duplicates are merged, self-loops rejected). Parse and Load
+ * read the adjacency-matrix text format of the command-line tool, from a
+ * buffer or a file. All return NULL on bad input or memory exhaustion.
+ */
+AAC_API AacGraph* aacGraphFromEdges(int n, const int (*edges)[2], int m);
+AAC_API AacGraph* aacGraphParse(const char* text, size_t length);
+AAC_API AacGraph* aacGraphLoad(const char* path);
+AAC_API void aacGraphFree(AacGraph* g);
+AAC_API int aacGraphVertices(const AacGraph* g);
+AAC_API int aacGraphEdges(const AacGraph* g);
+
+/**
+ * Builds g's host-side preprocessing now instead of on its first use as
+ * H, e.g. while a server starts up.
+ */
+AAC_API int aacGraphPrepareHost(const AacGraph* g);
+
+/** Non-induced subgraph test: *contains = G embeds in H. */
+AAC_API int aacContains(AacContext* ctx, const AacGraph* G, const AacGraph* H, bool* contains);
+
+/**
+ * Number of embeddings of G in H (injective maps from G's vertices to H's
+ * that preserve G's edges). Counting stops at config.countLimit or after
+ * config.timeLimit when those are set; *complete (may be NULL) is then
+ * false and *count holds the embeddings found so far.
+ */
+AAC_API int aacCount(AacContext* ctx, const AacGraph* G, const AacGraph* H,
+                     long long* count, bool* complete);
+
+/**
+ * Subgraph test, then (unless alg is AAC_ALG_SUBISO) the extension of H
+ * the algorithm finds when G does not embed.
+ */
+AAC_API int aacSolve(AacContext* ctx, const AacGraph* G, const AacGraph* H,
+                     AacAlgorithm alg, AacResult* result);
+
+/** Command-line spellings: "subiso", "greedy", "greedy+ls", "beam", "exact". */
+AAC_API int aacAlgorithmFromName(const char* name, AacAlgorithm* alg);
+AAC_API const char* aacAlgorithmName(AacAlgorithm alg);
+AAC_API const char* aacStatusString(int status);
+
+#endif // AAC_H
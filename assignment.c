@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "assignment.h"
+
+struct AssignmentWorkspace {
+    int row_cap;
+    int col_cap;
+    size_t cost_cap;
+    int* cost;          // optional caller-filled cost buffer
+    long long* u;       // row potentials
+    long long* v;       // column potentials
+    long long* shortest;  // shortest reduced path cost to each column
+    int* path;          // predecessor row of each column on the path
+    int* col4row;
+    int* row4col;
+    char* row_seen;
+    char* col_seen;
+};
+
+#define PATH_INF LLONG_MAX
+
+AssignmentWorkspace* assignmentWorkspaceCreate(void) {
+    return calloc(1, sizeof(AssignmentWorkspace));
+}
+
+void assignmentWorkspaceFree(AssignmentWorkspace* ws) {
+    if (!ws) return;
+    free(ws->cost);
+    free(ws->u);
+    free(ws->v);
+    free(ws->shortest);
+    free(ws->path);
+    free(ws->col4row);
+    free(ws->row4col);
+    free(ws->row_seen);
+    free(ws->col_seen);
+    free(ws);
+}
+
+// Grow `*p` to hold `count` elements of `size` bytes; 0 on success.
+static int growArray(void* p, size_t count, size_t size) {
+    void* grown = realloc(*(void**)p, (count > 0 ? count : 1) * size);
+    if (!grown) return -1;
+    *(void**)p = grown;
+    return 0;
+}
+
+static int reserve(AssignmentWorkspace* ws, int rows, int cols) {
+    if (rows > ws->row_cap) {
+        if (growArray(&ws->u, rows, sizeof(long long)) ||
+            growArray(&ws->col4row, rows, sizeof(int)) ||
+            growArray(&ws->row_seen, rows, sizeof(char))) return -1;
+        ws->row_cap = rows;
+    }
+    if (cols > ws->col_cap) {
+        if (growArray(&ws->v, cols, sizeof(long long)) ||
+            growArray(&ws->shortest, cols, sizeof(long long)) ||
+            growArray(&ws->path, cols, sizeof(int)) ||
+            growArray(&ws->row4col, cols, sizeof(int)) ||
+            growArray(&ws->col_seen, cols, sizeof(char))) return -1;
+        ws->col_cap = cols;
+    }
+    return 0;
+}
+
+int* assignmentCostBuffer(AssignmentWorkspace* ws, int rows, int cols) {
+    size_t cells = (size_t)rows * cols;
+    if (cells > ws->cost_cap || !ws->cost) {
+        if (growArray(&ws->cost, cells, sizeof(int))) return NULL;
+        ws->cost_cap = cells;
+    }
+    return ws->cost;
+}
+
+// Dijkstra over reduced costs from `start` to the nearest free column.
+// Returns that column and leaves the path length in *min_out, or -1.
+static int augmentingPath(AssignmentWorkspace* ws, int cols, const int* cost,
+                          int start, long long* min_out) {
+    long long min_val = 0;
+    int sink = -1;
+    int i = start;
+
+    memset(ws->row_seen, 0, ws->row_cap);
+    for (int j = 0; j < cols; j++) {
+        ws->col_seen[j] = 0;
+        ws->shortest[j] = PATH_INF;
+    }
+
+    while (sink == -1) {
+        int next = -1;
+        long long lowest = PATH_INF;
+        const int* row = cost + (size_t)i * cols;
+        long long ui = ws->u[i];
+        ws->row_seen[i] = 1;
+
+        // Ties go to the lowest column, as in the classic Hungarian scan
+        for (int j = 0; j < cols; j++) {
+            if (ws->col_seen[j]) continue;
+            long long r = min_val + row[j] - ui - ws->v[j];
+            if (r < ws->shortest[j]) {
+                ws->path[j] = i;
+                ws->shortest[j] = r;
+            }
+            if (ws->shortest[j] < lowest) {
+                lowest = ws->shortest[j];
+                next = j;
+            }
+        }
+
+        min_val = lowest;
+        if (next < 0 || min_val == PATH_INF) return -1;
+
+        if (ws->row4col[next] == -1) sink = next;
+        else i = ws->row4col[next];
+        ws->col_seen[next] = 1;
+    }
+
+    *min_out = min_val;
+    return sink;
+}
+
+int assignmentSolve(AssignmentWorkspace* ws, int rows, int cols,
+                    const int* cost, int* rowToCol, long long* total) {
+    *total = 0;
+    if (rows > cols || rows < 0) return -1;
+    if (rows == 0) return 0;
+    if (reserve(ws, rows, cols) != 0) return -1;
+
+    memset(ws->u, 0, rows * sizeof(long long));
+    memset(ws->v, 0, cols * sizeof(long long));
+    for (int i = 0; i < rows; i++) ws->col4row[i] = -1;
+    for (int j = 0; j < cols; j++) ws->row4col[j] = -1;
+
+    for (int cur = 0; cur < rows; cur++) {
+        long long min_val;
+        int sink = augmentingPath(ws, cols, cost, cur, &min_val);
+        if (sink < 0) return -1;
+
+        // Update the dual potentials
+        ws->u[cur] += min_val;
+        for (int i = 0; i < rows; i++) {
+            if (ws->row_seen[i] && i != cur) {
+                ws->u[i] += min_val - ws->shortest[ws->col4row[i]];
+            }
+        }
+        for (int j = 0; j < cols; j++) {
+            if (ws->col_seen[j]) ws->v[j] -= min_val - ws->shortest[j];
+        }
+
+        // Augment along the path back to the current row
+        int j = sink;
+        for (;;) {
+            int i = ws->path[j];
+            ws->row4col[j] = i;
+            int prev = ws->col4row[i];
+            ws->col4row[i] = j;
+            j = prev;
+            if (i == cur) break;
+        }
+    }
+
+    for (int i = 0; i < rows; i++) {
+        rowToCol[i] = ws->col4row[i];
+        *total += cost[(size_t)i * cols + ws->col4row[i]];
+    }
+    return 0;
+}
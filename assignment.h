@@ -0,0 +1,42 @@
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+/**
+ * =============================================================================
+ * LINEAR ASSIGNMENT ENGINE
+ * =============================================================================
+ * Minimum-cost assignment of `rows` rows to distinct columns of a
+ * rectangular integer cost matrix (rows <= cols), solved by shortest
+ * augmenting paths with dual potentials (the Jonker-Volgenant scheme in
+ * the rectangular form of Crouse, 2016). O(rows^2 * cols) time.
+ *
+ * Costs are read from a flat row-major buffer: cost[i * cols + j].
+ * All scratch memory lives in an AssignmentWorkspace that grows to the
+ * largest problem seen and is reused by later calls, so a workspace kept
+ * across calls makes repeated solves allocation-free. A workspace must not
+ * be shared between threads; separate workspaces are independent.
+ * =============================================================================
+ */
+
+typedef struct AssignmentWorkspace AssignmentWorkspace;
+
+AssignmentWorkspace* assignmentWorkspaceCreate(void);
+void assignmentWorkspaceFree(AssignmentWorkspace* ws);
+
+/**
+ * Returns the workspace's cost buffer sized for a rows x cols problem
+ * (contents unspecified), or NULL if memory runs out. Filling it and passing
+ * it to assignmentSolve avoids a separate allocation per problem.
+ */
+int* assignmentCostBuffer(AssignmentWorkspace* ws, int rows, int cols);
+
+/**
+ * Solves the rows x cols problem (rows <= cols) over `cost`, which may be
+ * the workspace's own cost buffer. Fills rowToCol[i] with the column given
+ * to row i and *total with the minimal total cost. Returns 0 on success,
+ * -1 if rows > cols or memory runs out.
+ */
+int assignmentSolve(AssignmentWorkspace* ws, int rows, int cols,
+                    const int* cost, int* rowToCol, long long* total);
+
+#endif // ASSIGNMENT_H
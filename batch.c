@@ -0,0 +1,554 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "graph.h"
+#include "subiso.h"
+#include "gmext.h"
+#include "beam_extension.h"
+#include "exact_extension.h"
+#include "timing.h"
+#include "resultcache.h"
+#include "stats.h"
+#include "trace.h"
+#include "batch.h"
+
+#define BATCH_LINE_MAX 4096
+#define BATCH_MAX_TOKENS 4
+
+typedef enum {
+    JOB_GREEDY,
+    JOB_GREEDY_LS,
+    JOB_BEAM,
+    JOB_EXACT,
+    JOB_SUBISO
+} JobAlgorithm;
+
+static const struct {
+    const char* name;
+    JobAlgorithm alg;
+} JOB_ALGORITHMS[] = {
+    { "greedy",    JOB_GREEDY },
+    { "greedy+ls", JOB_GREEDY_LS },
+    { "beam",      JOB_BEAM },
+    { "exact",     JOB_EXACT },
+    { "subiso",    JOB_SUBISO },
+};
+#define JOB_ALGORITHM_COUNT ((int)(sizeof(JOB_ALGORITHMS) / sizeof(JOB_ALGORITHMS[0])))
+
+typedef struct Job {
+    long index;           // position in the manifest
+    char input[BATCH_LINE_MAX];  // what the job reads, for the result record
+    JobAlgorithm alg;
+    Graph* G;
+    Graph* H;
+    double parseSeconds;
+    const char* error;    // set when the job could not be prepared
+    struct Job* next;
+} Job;
+
+/**
+ * Bounded FIFO between the reader and the workers. The reader blocks while
+ * `capacity` jobs are waiting, so at most that many parsed graph pairs are
+ * held in memory ahead of the workers.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    Job* head;
+    Job* tail;
+    int size;
+    int capacity;
+    int closed;           // reader finished: no more jobs will arrive
+
+    pthread_mutex_t outLock;
+    FILE* out;
+    long finished;
+    long failed;
+
+    FILE* manifest;
+    const BatchOptions* opts;
+    JobAlgorithm defaultAlg;
+    int readError;
+} BatchState;
+
+static int findAlgorithm(const char* name, JobAlgorithm* alg) {
+    for (int i = 0; i < JOB_ALGORITHM_COUNT; i++) {
+        if (strcmp(name, JOB_ALGORITHMS[i].name) == 0) {
+            *alg = JOB_ALGORITHMS[i].alg;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int isBatchAlgorithm(const char* name) {
+    JobAlgorithm alg;
+    return findAlgorithm(name, &alg) == 0;
+}
+
+static const char* algorithmName(JobAlgorithm alg) {
+    for (int i = 0; i < JOB_ALGORITHM_COUNT; i++) {
+        if (JOB_ALGORITHMS[i].alg == alg) return JOB_ALGORITHMS[i].name;
+    }
+    return "?";
+}
+
+// --- Queue ---
+
+static void pushJob(BatchState* st, Job* job) {
+    pthread_mutex_lock(&st->lock);
+    while (st->size >= st->capacity) pthread_cond_wait(&st->notFull, &st->lock);
+    job->next = NULL;
+    if (st->tail) st->tail->next = job;
+    else st->head = job;
+    st->tail = job;
+    st->size++;
+    pthread_cond_signal(&st->notEmpty);
+    pthread_mutex_unlock(&st->lock);
+}
+
+// Returns NULL once the reader is done and the queue is drained.
+static Job* popJob(BatchState* st) {
+    pthread_mutex_lock(&st->lock);
+    while (!st->head && !st->closed) pthread_cond_wait(&st->notEmpty, &st->lock);
+    Job* job = st->head;
+    if (job) {
+        st->head = job->next;
+        if (!st->head) st->tail = NULL;
+        st->size--;
+        pthread_cond_signal(&st->notFull);
+    }
+    pthread_mutex_unlock(&st->lock);
+    return job;
+}
+
+static void closeQueue(BatchState* st) {
+    pthread_mutex_lock(&st->lock);
+    st->closed = 1;
+    pthread_cond_broadcast(&st->notEmpty);
+    pthread_mutex_unlock(&st->lock);
+}
+
+// --- Reader ---
+
+static Job* newJob(long index, JobAlgorithm alg) {
+    Job* job = calloc(1, sizeof(Job));
+    if (job) {
+        job->index = index;
+        job->alg = alg;
+    }
+    return job;
+}
+
+// One job per consecutive (G, H) pair of the container file.
+static void readContainer(BatchState* st, const char* file, JobAlgorithm alg, long* index) {
+    double t0 = wallSeconds();
+    FILE* f = fopen(file, "r");
+    if (!f) {
+        Job* job = newJob((*index)++, alg);
+        if (!job) return;
+        snprintf(job->input, sizeof(job->input), "%s", file);
+        job->error = "cannot open container";
+        pushJob(st, job);
+        return;
+    }
+
+    for (int pair = 0; !graphFileAtEnd(f); pair++) {
+        Job* job = newJob((*index)++, alg);
+        if (!job) break;
+        snprintf(job->input, sizeof(job->input), "%s@%d", file, pair);
+        job->G = loadGraphFromFile(f);
+        job->H = job->G && !graphFileAtEnd(f) ? loadGraphFromFile(f) : NULL;
+        job->parseSeconds = wallSeconds() - t0;
+        traceEndArgs(t0, "load", "job", job->index, NULL, 0);
+        if (!job->G || !job->H) {
+            job->error = "malformed graph pair in container";
+            freeGraph(job->G);
+            job->G = NULL;
+            pushJob(st, job);
+            break;  // the stream position is lost after a parse error
+        }
+        pushJob(st, job);
+        t0 = wallSeconds();
+    }
+    fclose(f);
+}
+
+static void* readerThread(void* arg) {
+    BatchState* st = arg;
+    char line[BATCH_LINE_MAX];
+    long index = 0;
+    traceThreadName("batch reader");
+
+    while (fgets(line, sizeof(line), st->manifest)) {
+        char* tok[BATCH_MAX_TOKENS];
+        int ntok = 0;
+        char* save = NULL;
+        char* t = strtok_r(line, " \t\r\n", &save);
+        if (!t || t[0] == '#') continue;
+        while (t && ntok < BATCH_MAX_TOKENS) {
+            tok[ntok++] = t;
+            t = strtok_r(NULL, " \t\r\n", &save);
+        }
+
+        JobAlgorithm alg = st->defaultAlg;
+        double t0 = wallSeconds();
+
+        if (strcmp(tok[0], "@pairs") == 0) {
+            if (ntok < 2 || (ntok >= 3 && findAlgorithm(tok[2], &alg) != 0) || ntok > 3) {
+                Job* job = newJob(index++, alg);
+                if (!job) break;
+                snprintf(job->input, sizeof(job->input), "%s", ntok >= 2 ? tok[1] : "@pairs");
+                job->error = "usage: @pairs <container_file> [algorithm]";
+                pushJob(st, job);
+            } else {
+                readContainer(st, tok[1], alg, &index);
+            }
+            continue;
+        }
+
+        // Same rule as the command line: a second word that names an
+        // algorithm makes the first word a combined file.
+        int pair = ntok >= 2 && !isBatchAlgorithm(tok[1]);
+        int algTok = pair ? 2 : 1;
+        Job* job = newJob(index++, alg);
+        if (!job) break;
+
+        if (pair) snprintf(job->input, sizeof(job->input), "%s %s", tok[0], tok[1]);
+        else snprintf(job->input, sizeof(job->input), "%s", tok[0]);
+
+        if (ntok > algTok + 1) {
+            job->error = "too many fields";
+        } else if (ntok == algTok + 1 && findAlgorithm(tok[algTok], &job->alg) != 0) {
+            job->error = "unknown algorithm";
+        } else if (pair) {
+            job->G = loadGraph(tok[0]);
+            job->H = job->G ? loadGraph(tok[1]) : NULL;
+            if (!job->G || !job->H) job->error = "failed to load graphs";
+        } else if (loadBothGraphs(tok[0], &job->G, &job->H) != 0) {
+            job->G = job->H = NULL;
+            job->error = "failed to load graphs";
+        }
+        if (job->error) {
+            freeGraph(job->G);
+            freeGraph(job->H);
+            job->G = job->H = NULL;
+        }
+        job->parseSeconds = wallSeconds() - t0;
+        traceEndArgs(t0, "load", "job", job->index, NULL, 0);
+        pushJob(st, job);
+    }
+    if (ferror(st->manifest)) st->readError = 1;
+
+    closeQueue(st);
+    return NULL;
+}
+
+// --- Workers ---
+
+static void writeJsonString(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+typedef struct {
+    bool subiso;
+    bool solved;          // an extension was computed (or none was needed)
+    int newVertices;
+    int newEdges;
+    int lowerBound;       // exact anytime only (-1 otherwise)
+    bool optimal;
+    bool cached;          // answered from the result cache
+    double subisoSeconds;
+    double extensionSeconds;
+    SearchStats stats;    // filled when BatchOptions.stats is set
+} JobResult;
+
+// Copies an extension so that it can be stored in the result cache.
+static void keepEdges(CachedResult* record, int (*edges)[2], int count) {
+    if (!record) return;
+    record->newEdges = 0;
+    record->edges = count > 0 ? malloc(count * sizeof(*edges)) : NULL;
+    if (count > 0 && !record->edges) return;
+    if (count > 0) memcpy(record->edges, edges, count * sizeof(*edges));
+    record->newEdges = count;
+}
+
+static bool lookupJob(const BatchState* st, const Job* job, ResultKey* key, JobResult* r) {
+    ResultParams params = {0};
+    params.algorithm = algorithmName(job->alg);
+    params.timeLimit = st->opts->timeLimit;
+    params.restarts = st->opts->restarts;
+    params.seed = st->opts->seed;
+    params.rclSize = st->opts->rclSize;
+    params.candidates = st->opts->candidates;
+    params.assignmentSeed = st->opts->assignmentSeed;
+    params.lsIterations = st->opts->lsIterations;
+    params.lsTime = st->opts->lsTime;
+    params.beamWidth = st->opts->beamWidth;
+    resultKeyInit(key, job->G, job->H, &params);
+
+    CachedResult c;
+    if (!resultCacheLookup(st->opts->cache, key, &c)) return false;
+    r->subiso = c.subiso;
+    r->solved = c.subiso || job->alg != JOB_SUBISO;
+    r->optimal = c.optimal;
+    r->newVertices = c.newVertices;
+    r->newEdges = c.newEdges;
+    r->lowerBound = c.lowerBound;
+    r->cached = true;
+    free(c.edges);
+    return true;
+}
+
+static void extendJob(const BatchState* st, Job* job, JobResult* r, CachedResult* record) {
+    const BatchOptions* o = st->opts;
+    double t0 = wallSeconds();
+    r->subiso = isSubgraphIsomorphic(job->G, job->H);
+    r->subisoSeconds = wallSeconds() - t0;
+    traceEnd(t0, "subiso");
+    if (r->subiso) {
+        r->solved = true;
+        r->optimal = true;
+        return;
+    }
+    if (job->alg == JOB_SUBISO) return;
+
+    t0 = wallSeconds();
+    if (job->alg == JOB_GREEDY || job->alg == JOB_GREEDY_LS) {
+        GreedyOptions gopts = {0};
+        gopts.candidates = o->candidates;
+        gopts.restarts = o->restarts;
+        gopts.timeBudget = o->timeLimit;
+        gopts.seed = o->seed;
+        gopts.rclSize = o->rclSize;
+        gopts.assignmentSeed = o->assignmentSeed;
+        gopts.localSearch = job->alg == JOB_GREEDY_LS;
+        gopts.lsIterations = o->lsIterations;
+        gopts.lsTimeBudget = o->lsTime;
+        GreedyExtension* ext = greedy_extension_with_options(job->G, job->H, &gopts);
+        if (ext) {
+            r->solved = true;
+            r->newVertices = ext->newVertexCount;
+            r->newEdges = ext->newEdgeCount;
+            keepEdges(record, ext->newEdges, ext->newEdgeCount);
+            freeGreedyExtension(ext);
+        }
+    } else if (job->alg == JOB_BEAM) {
+        BeamOptions bopts = {0};
+        bopts.width = o->beamWidth;
+        GreedyExtension* ext = beam_extension(job->G, job->H, &bopts, NULL);
+        if (ext) {
+            r->solved = true;
+            r->newVertices = ext->newVertexCount;
+            r->newEdges = ext->newEdgeCount;
+            keepEdges(record, ext->newEdges, ext->newEdgeCount);
+            freeGreedyExtension(ext);
+        }
+    } else if (o->timeLimit > 0) {
+        ExactOptions eopts = {0};
+        eopts.timeLimit = o->timeLimit;
+        eopts.isoCacheBytes = o->isoCacheBytes;
+        ExactAnytimeResult* res = exactMinimalExtensionAnytime(job->G, job->H, &eopts);
+        if (res && res->best) {
+            r->solved = true;
+            r->newVertices = res->best->newVertexCount;
+            r->newEdges = res->best->newEdgeCount;
+            keepEdges(record, res->best->newEdges, res->best->newEdgeCount);
+            r->lowerBound = res->lowerBound;
+            r->optimal = res->optimal;
+        }
+        freeExactAnytimeResult(res);
+    } else {
+        ExactOptions eopts = {0};
+        eopts.isoCacheBytes = o->isoCacheBytes;
+        Extension* ext = exactMinimalExtensionWithOptions(job->G, job->H, &eopts, NULL);
+        if (ext) {
+            r->solved = true;
+            r->optimal = true;
+            r->newVertices = ext->newVertexCount;
+            r->newEdges = ext->newEdgeCount;
+            keepEdges(record, ext->newEdges, ext->newEdgeCount);
+            freeExtensionObject(ext);
+        }
+    }
+    r->extensionSeconds = wallSeconds() - t0;
+    traceEnd(t0, "extension");
+}
+
+static void solveJob(const BatchState* st, Job* job, JobResult* r) {
+    const BatchOptions* o = st->opts;
+    memset(r, 0, sizeof(*r));
+    r->lowerBound = -1;
+
+    ResultKey key;
+    if (o->cache && lookupJob(st, job, &key, r)) return;
+    CachedResult record = { false, false, -1, 0, 0, NULL };
+    if (o->stats) statsReset();
+    extendJob(st, job, r, o->cache ? &record : NULL);
+    if (o->stats) statsSnapshot(&r->stats);
+
+    // Exact keys ignore the time limit, so only proven optima are kept
+    if (o->cache && (r->solved || job->alg == JOB_SUBISO) &&
+        (job->alg != JOB_EXACT || r->optimal)) {
+        record.subiso = r->subiso;
+        record.optimal = r->optimal;
+        record.lowerBound = r->lowerBound;
+        record.newVertices = r->newVertices;
+        if (record.newEdges == r->newEdges) resultCacheStore(o->cache, &key, &record);
+    }
+    free(record.edges);
+}
+
+static void writeResult(BatchState* st, const Job* job, const JobResult* r, double solveSeconds) {
+    int failed = job->error || (job->alg != JOB_SUBISO && !r->solved);
+
+    pthread_mutex_lock(&st->outLock);
+    FILE* out = st->out;
+    fprintf(out, "{\"job\":%ld,\"input\":", job->index);
+    writeJsonString(out, job->input);
+    fprintf(out, ",\"alg\":\"%s\"", algorithmName(job->alg));
+    if (job->error) {
+        fprintf(out, ",\"status\":\"error\",\"error\":");
+        writeJsonString(out, job->error);
+    } else {
+        fprintf(out, ",\"status\":\"%s\"", failed ? "error" : "ok");
+        if (failed) fprintf(out, ",\"error\":\"no extension found\"");
+        fprintf(out, ",\"n_g\":%d,\"m_g\":%d,\"n_h\":%d,\"m_h\":%d,\"subiso\":%s",
+                job->G->n, job->G->m, job->H->n, job->H->m, r->subiso ? "true" : "false");
+        if (r->solved) {
+            fprintf(out, ",\"cost\":%d,\"new_vertices\":%d,\"new_edges\":%d",
+                    r->newVertices + r->newEdges, r->newVertices, r->newEdges);
+            if (job->alg == JOB_EXACT) {
+                fprintf(out, ",\"optimal\":%s", r->optimal ? "true" : "false");
+                if (r->lowerBound >= 0) fprintf(out, ",\"lower_bound\":%d", r->lowerBound);
+            }
+        }
+    }
+    if (r->cached) fprintf(out, ",\"cached\":true");
+    if (st->opts->stats && !job->error) {
+        fprintf(out, ",\"stats\":{\"subiso_ms\":%.3f,\"extension_ms\":%.3f,",
+                r->subisoSeconds * 1000.0, r->extensionSeconds * 1000.0);
+        statsWriteJson(out, &r->stats);
+        fputc('}', out);
+    }
+    fprintf(out, ",\"parse_ms\":%.3f,\"solve_ms\":%.3f}\n",
+            job->parseSeconds * 1000.0, solveSeconds * 1000.0);
+    fflush(out);
+    st->finished++;
+    if (failed) st->failed++;
+    pthread_mutex_unlock(&st->outLock);
+}
+
+static void* workerThread(void* arg) {
+    BatchState* st = arg;
+    Job* job;
+    traceThreadName("batch worker");
+    while ((job = popJob(st)) != NULL) {
+        JobResult r;
+        memset(&r, 0, sizeof(r));
+        double t0 = wallSeconds();
+        if (!job->error) solveJob(st, job, &r);
+        writeResult(st, job, &r, job->error ? 0.0 : wallSeconds() - t0);
+        traceEndArgs(t0, "batch job", "job", job->index, "cached", r.cached);
+
+        freeGraph(job->G);
+        freeGraph(job->H);
+        free(job);
+    }
+    return NULL;
+}
+
+int runBatch(const char* manifest, const BatchOptions* opts, FILE* out) {
+    BatchState st;
+    memset(&st, 0, sizeof(st));
+    st.opts = opts;
+    st.out = out;
+
+    const char* defaultAlg = opts->algorithm ? opts->algorithm : "greedy";
+    if (findAlgorithm(defaultAlg, &st.defaultAlg) != 0) {
+        fprintf(stderr, "batch: unknown algorithm '%s'\n", defaultAlg);
+        return -1;
+    }
+
+    st.manifest = strcmp(manifest, "-") == 0 ? stdin : fopen(manifest, "r");
+    if (!st.manifest) {
+        fprintf(stderr, "batch: cannot open manifest '%s'\n", manifest);
+        return -1;
+    }
+
+    int threads = opts->threads;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    st.capacity = 2 * threads + 2;
+
+    pthread_mutex_init(&st.lock, NULL);
+    pthread_cond_init(&st.notEmpty, NULL);
+    pthread_cond_init(&st.notFull, NULL);
+    pthread_mutex_init(&st.outLock, NULL);
+
+    double started = wallSeconds();
+    pthread_t reader;
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    int readerStarted = pthread_create(&reader, NULL, readerThread, &st) == 0;
+    int running = 0;
+    for (int t = 0; workers && t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, workerThread, &st) != 0) break;
+        running++;
+    }
+
+    if (!readerStarted) {
+        // Without a reader thread, parse everything up front (the queue
+        // must not block), then let the workers drain it.
+        st.capacity = 1 << 30;
+        readerThread(&st);
+    }
+    if (running == 0) {
+        // No worker could start: this thread drains the queue while the
+        // reader fills it, and returns once the reader has closed it.
+        workerThread(&st);
+        if (readerStarted) pthread_join(reader, NULL);
+    } else {
+        for (int t = 0; t < running; t++) pthread_join(workers[t], NULL);
+        if (readerStarted) pthread_join(reader, NULL);
+    }
+    double elapsed = wallSeconds() - started;
+
+    if (st.manifest != stdin) fclose(st.manifest);
+    free(workers);
+    pthread_mutex_destroy(&st.lock);
+    pthread_cond_destroy(&st.notEmpty);
+    pthread_cond_destroy(&st.notFull);
+    pthread_mutex_destroy(&st.outLock);
+
+    fprintf(stderr, "batch: %ld jobs (%ld failed) in %.3fs, %.1f jobs/s on %d worker%s\n",
+            st.finished, st.failed, elapsed, elapsed > 0 ? st.finished / elapsed : 0.0,
+            running > 0 ? running : 1, running > 1 ? "s" : "");
+    if (opts->cache) {
+        ResultCacheStats cs;
+        resultCacheGetStats(opts->cache, &cs);
+        fprintf(stderr, "batch: result cache: %ld hits, %ld misses, %ld stored, %ld entries (%.2f MB, %ld evicted)\n",
+                cs.hits, cs.misses, cs.stores, cs.entries, cs.bytes / (1024.0 * 1024.0), cs.evictions);
+    }
+    if (opts->stats) {
+        fprintf(stderr, "batch: peak memory %.1f MB%s\n", statsPeakRssKB() / 1024.0,
+                statsEnabled() ? "" : " (search counters not compiled in)");
+    }
+    if (st.readError) {
+        fprintf(stderr, "batch: error reading manifest '%s'\n", manifest);
+        return -1;
+    }
+    return st.failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "gmext.h"
+#include "resultcache.h"
+
+/**
+ * =============================================================================
+ * BATCH MODE
+ * =============================================================================
+ * Runs many (G, H, algorithm) jobs in one process. A manifest lists one job
+ * per line:
+ *
+ *     <graph_G_file> <graph_H_file> [algorithm]
+ *     <combined_file> [algorithm]
+ *     @pairs <container_file> [algorithm]
+ *
+ * Blank lines and lines starting with '#' are ignored. A combined file is
+ * told apart from a G/H pair the same way as on the command line: by
+ * whether the second word is an algorithm name. '@pairs' expands to one
+ * job per consecutive (G, H) pair of graphs stored back to back in the
+ * container file. Jobs without an algorithm use the batch default.
+ *
+ * A reader thread parses jobs and loads their graphs into a bounded queue
+ * while a fixed pool of workers solves them, so parsing is pipelined with
+ * solving. Each finished job is written as one JSON object per line (in
+ * completion order; "job" is the manifest order), and a throughput summary
+ * goes to stderr. With a result cache, jobs answered from it are marked
+ * "cached" and every new result is added to it. With `stats`, every record
+ * carries a "stats" object (time per phase and the stats.h counters of
+ * that job) and the summary reports the peak memory.
+ * =============================================================================
+ */
+
+typedef struct {
+    const char* algorithm;  // default for jobs without one (NULL = "greedy")
+    int threads;            // worker threads (<= 0 = available processors)
+    double timeLimit;       // exact: anytime budget per job, greedy: restart
+                            // budget per job (0 = none)
+    size_t isoCacheBytes;   // exact: verdict cache cap per job
+    int beamWidth;          // beam: width (0 = default)
+    GreedyCandidateMode candidates;  // greedy: candidate generation policy
+    int restarts;           // greedy: randomized restarts per job
+    unsigned long long seed;
+    int rclSize;            // greedy: restricted candidate list length (0 = default)
+    long lsIterations;      // greedy+ls: annealing moves (0 = default)
+    double lsTime;          // greedy+ls: refinement time cap in seconds (0 = none)
+    int assignmentSeed;     // greedy: also try the assignment-seeded mapping
+    ResultCache* cache;     // reuse and store results (NULL = none)
+    int stats;              // add per-job search counters and phase times
+} BatchOptions;
+
+/**
+ * Runs the jobs of `manifest` ("-" = stdin) and writes results to `out`.
+ * Returns 0 if every job succeeded, 1 if some failed, -1 if the manifest
+ * could not be read or the default algorithm is unknown.
+ */
+int runBatch(const char* manifest, const BatchOptions* opts, FILE* out);
+
+/**
+ * Returns 1 if `name` is an algorithm accepted by batch jobs.
+ */
+int isBatchAlgorithm(const char* name);
+
+#endif // BATCH_H
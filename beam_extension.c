@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "graph.h"
+#include "timing.h"
+#include "trace.h"
+#include "beam_extension.h"
+
+#define BEAM_DEFAULT_WIDTH 16
+#define BEAM_PARALLEL_MIN_WORK 4096  // children per level worth spawning threads for
+
+/**
+ * A child of a kept state: the parent's mapping extended by one image for
+ * the vertex of the current level. Children are ranked by (f, parent,
+ * image), a total order, so the kept set is independent of how the parents
+ * are split across threads.
+ */
+typedef struct {
+    int f;          // cost + bound
+    int parent;     // index of the parent state in the current beam
+    int image;      // H vertex, or H->n + parent's added count for a new vertex
+    int cost;       // added vertices + missing edges among mapped G vertices
+    int used_edges; // H edges with both endpoints in the image
+} BeamChild;
+
+/**
+ * Search state shared by the workers. Each kept state owns a row of
+ * `mapping` (G->n entries, the first `level` valid) and a row of `used`
+ * (H->n flags). Rows come in two generations of `width` rows each: the
+ * beam being expanded (`gen`) and the children kept from it.
+ */
+typedef struct {
+    Graph* G;
+    Graph* H;
+    int width;
+    int* order;        // pattern vertices in placement order
+    int* back_start;   // CSR: levels of the neighbours placed earlier, per level
+    int* back;
+    int* remaining;    // G edges still undecided after each level
+    int* mapping;      // 2 x width rows of G->n images, indexed by level
+    unsigned char* used;  // 2 x width rows of H->n
+    int* added;        // per row
+    int* cost;
+    int* used_edges;
+    int gen;           // generation holding the current beam (0 or 1)
+    int count;         // states in the beam
+    int level;         // level being expanded
+    int upper_bound;   // children with f above this are pruned
+} BeamSearch;
+
+typedef struct {
+    BeamSearch* search;
+    int id;
+    int stride;
+    BeamChild* heap;   // max-heap of the best `width` children seen
+    int heap_len;
+    long scored;
+    long pruned;
+} BeamWorker;
+
+static int childBefore(const BeamChild* a, const BeamChild* b) {
+    if (a->f != b->f) return a->f < b->f;
+    if (a->parent != b->parent) return a->parent < b->parent;
+    return a->image < b->image;
+}
+
+static int compareChildren(const void* a, const void* b) {
+    const BeamChild* ca = a;
+    const BeamChild* cb = b;
+    if (childBefore(ca, cb)) return -1;
+    if (childBefore(cb, ca)) return 1;
+    return 0;
+}
+
+// Keep `c` if it ranks among the best `width` children of this worker.
+static void offerChild(BeamWorker* w, const BeamChild* c) {
+    BeamChild* heap = w->heap;
+    int width = w->search->width;
+    int i;
+
+    if (w->heap_len < width) {
+        i = w->heap_len++;
+        while (i > 0 && childBefore(&heap[(i - 1) / 2], c)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = *c;
+        return;
+    }
+    if (!childBefore(c, &heap[0])) return;
+
+    // Replace the worst kept child and sift down
+    i = 0;
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, worst = i;
+        const BeamChild* at = c;
+        if (l < width && childBefore(at, &heap[l])) { worst = l; at = &heap[l]; }
+        if (r < width && childBefore(at, &heap[r])) { worst = r; }
+        if (worst == i) break;
+        heap[i] = heap[worst];
+        i = worst;
+    }
+    heap[i] = *c;
+}
+
+// Admissible bound on the cost still to come after `level` is placed.
+static int remainingBound(const BeamSearch* b, int level, int used_count, int used_edges) {
+    int unmapped = b->G->n - (level + 1);
+    int unused = b->H->n - used_count;
+    int bound = unmapped > unused ? unmapped - unused : 0;
+    int free_edges = b->H->m - used_edges;
+    if (b->remaining[level] > free_edges) bound += b->remaining[level] - free_edges;
+    return bound;
+}
+
+static void expandState(BeamWorker* w, int p) {
+    BeamSearch* b = w->search;
+    Graph* G = b->G;
+    Graph* H = b->H;
+    int level = b->level;
+    int row = b->gen * b->width + p;
+    const int* mapping = b->mapping + (size_t)row * G->n;
+    const unsigned char* used = b->used + (size_t)row * H->n;
+    int nback = b->back_start[level + 1] - b->back_start[level];
+    const int* back = b->back + b->back_start[level];
+    int used_count = level - b->added[row];
+    long scored = 0, pruned = 0;  // local: worker structs share cache lines
+    BeamChild c;
+
+    c.parent = p;
+    for (int h = 0; h < H->n; h++) {
+        if (used[h]) continue;
+
+        int preserved = 0;
+        for (int i = 0; i < nback; i++) {
+            int img = mapping[back[i]];
+            if (img < H->n && H->matrix[img][h]) preserved++;
+        }
+        int inside = 0;
+        for (int i = 0; i < H->adjSize[h]; i++) {
+            if (used[H->adj[h][i]]) inside++;
+        }
+
+        c.image = h;
+        c.cost = b->cost[row] + nback - preserved;
+        c.used_edges = b->used_edges[row] + inside;
+        c.f = c.cost + remainingBound(b, level, used_count + 1, c.used_edges);
+        scored++;
+        if (c.f > b->upper_bound) {
+            pruned++;
+            continue;
+        }
+        offerChild(w, &c);
+    }
+
+    // New vertex: every edge to an earlier neighbour is missing
+    c.image = H->n + b->added[row];
+    c.cost = b->cost[row] + 1 + nback;
+    c.used_edges = b->used_edges[row];
+    c.f = c.cost + remainingBound(b, level, used_count, c.used_edges);
+    scored++;
+    if (c.f > b->upper_bound) pruned++;
+    else offerChild(w, &c);
+    w->scored += scored;
+    w->pruned += pruned;
+}
+
+static void* beamWorker(void* arg) {
+    BeamWorker* w = arg;
+    if (w->id > 0) traceThreadName("beam worker");
+    double traceStart = traceBegin();
+    for (int p = w->id; p < w->search->count; p += w->stride) {
+        expandState(w, p);
+    }
+    traceEndArgs(traceStart, "beam worker", "level", w->search->level, "worker", w->id);
+    return NULL;
+}
+
+// BFS order from the highest-degree vertex, neighbours by descending degree;
+// further components start from their highest-degree vertex.
+static void placementOrder(Graph* G, int* order) {
+    int* visited = calloc(G->n, sizeof(int));
+    int placed = 0;
+
+    while (placed < G->n) {
+        int start = -1;
+        for (int v = 0; v < G->n; v++) {
+            if (!visited[v] && (start < 0 || G->adjSize[v] > G->adjSize[start])) start = v;
+        }
+        int front = placed;
+        order[placed++] = start;
+        visited[start] = 1;
+
+        while (front < placed) {
+            int v = order[front++];
+            int first = placed;
+            for (int i = 0; i < G->adjSize[v]; i++) {
+                int nb = G->adj[v][i];
+                if (visited[nb]) continue;
+                visited[nb] = 1;
+                // insertion by descending degree among this vertex's children
+                int j = placed++;
+                while (j > first && G->adjSize[order[j - 1]] < G->adjSize[nb]) {
+                    order[j] = order[j - 1];
+                    j--;
+                }
+                order[j] = nb;
+            }
+        }
+    }
+    free(visited);
+}
+
+static int beamSearchInit(BeamSearch* b, Graph* G, Graph* H, int width) {
+    memset(b, 0, sizeof(*b));
+    b->G = G;
+    b->H = H;
+    b->width = width;
+
+    int n = G->n > 0 ? G->n : 1;
+    b->order = malloc(n * sizeof(int));
+    b->back_start = malloc((n + 1) * sizeof(int));
+    b->back = malloc((G->m > 0 ? G->m : 1) * sizeof(int));
+    b->remaining = malloc(n * sizeof(int));
+    int* pos = malloc(n * sizeof(int));
+    b->mapping = malloc(2 * (size_t)width * n * sizeof(int));
+    b->used = malloc(2 * (size_t)width * (H->n > 0 ? H->n : 1));
+    b->added = malloc(2 * width * sizeof(int));
+    b->cost = malloc(2 * width * sizeof(int));
+    b->used_edges = malloc(2 * width * sizeof(int));
+    if (!b->order || !b->back_start || !b->back || !b->remaining || !pos ||
+        !b->mapping || !b->used || !b->added || !b->cost || !b->used_edges) {
+        free(pos);
+        return -1;
+    }
+
+    placementOrder(G, b->order);
+    for (int i = 0; i < G->n; i++) pos[b->order[i]] = i;
+
+    int k = 0, decided = 0;
+    for (int i = 0; i < G->n; i++) {
+        int v = b->order[i];
+        b->back_start[i] = k;
+        for (int j = 0; j < G->adjSize[v]; j++) {
+            if (pos[G->adj[v][j]] < i) b->back[k++] = pos[G->adj[v][j]];
+        }
+        decided += k - b->back_start[i];
+        b->remaining[i] = G->m - decided;
+    }
+    b->back_start[G->n] = k;
+    free(pos);
+    return 0;
+}
+
+static void beamSearchFree(BeamSearch* b) {
+    free(b->order);
+    free(b->back_start);
+    free(b->back);
+    free(b->remaining);
+    free(b->mapping);
+    free(b->used);
+    free(b->added);
+    free(b->cost);
+    free(b->used_edges);
+}
+
+static int seedCost(const GreedyExtension* ext) {
+    return ext->newVertexCount + ext->newEdgeCount;
+}
+
+GreedyExtension* beam_extension(Graph* G, Graph* H, const BeamOptions* opts, BeamStats* stats) {
+    double started = wallSeconds();
+    int width = (opts && opts->width > 0) ? opts->width : BEAM_DEFAULT_WIDTH;
+    int threads = (opts && opts->threads > 1) ? opts->threads : 1;
+    BeamStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    stats->width = width;
+
+    GreedyExtension* seed = greedy_extension(G, H);
+    if (!seed) return NULL;
+    stats->seedCost = seedCost(seed);
+    stats->fromSeed = 1;
+
+    BeamSearch b;
+    if (beamSearchInit(&b, G, H, width) != 0) {
+        beamSearchFree(&b);
+        stats->elapsed = wallSeconds() - started;
+        return seed;
+    }
+    b.upper_bound = stats->seedCost;
+
+    int root = G->n > H->n ? G->n - H->n : 0;
+    if (G->m > H->m) root += G->m - H->m;
+    stats->rootBound = root;
+
+    // The greedy mapping is already optimal when it meets the root bound
+    if (G->n == 0 || stats->seedCost <= root) {
+        beamSearchFree(&b);
+        stats->elapsed = wallSeconds() - started;
+        return seed;
+    }
+
+    BeamWorker* workers = calloc(threads, sizeof(BeamWorker));
+    pthread_t* tids = malloc(threads * sizeof(pthread_t));
+    BeamChild* merged = malloc((size_t)threads * width * sizeof(BeamChild));
+    int ok = workers && tids && merged;
+    for (int t = 0; ok && t < threads; t++) {
+        workers[t].search = &b;
+        workers[t].id = t;
+        workers[t].stride = threads;
+        workers[t].heap = malloc(width * sizeof(BeamChild));
+        if (!workers[t].heap) ok = 0;
+    }
+
+    // Generation 0 holds the empty mapping
+    b.gen = 0;
+    b.count = ok ? 1 : 0;
+    b.added[0] = 0;
+    b.cost[0] = 0;
+    b.used_edges[0] = 0;
+    memset(b.used, 0, H->n);
+
+    for (int level = 0; ok && level < G->n && b.count > 0; level++) {
+        b.level = level;
+        for (int t = 0; t < threads; t++) workers[t].heap_len = 0;
+        double traceStart = traceBegin();
+
+        int spawned = 0;
+        long work = (long)b.count * (H->n + 1);
+        for (int t = 1; t < threads && t < b.count && work >= BEAM_PARALLEL_MIN_WORK; t++) {
+            if (pthread_create(&tids[t], NULL, beamWorker, &workers[t]) != 0) break;
+            spawned = t;
+        }
+        // Parents of workers that were not started are taken by the caller
+        for (int t = spawned + 1; t < threads; t++) {
+            for (int p = t; p < b.count; p += threads) expandState(&workers[t], p);
+        }
+        beamWorker(&workers[0]);
+        for (int t = 1; t <= spawned; t++) pthread_join(tids[t], NULL);
+
+        int total = 0;
+        for (int t = 0; t < threads; t++) {
+            memcpy(merged + total, workers[t].heap, workers[t].heap_len * sizeof(BeamChild));
+            total += workers[t].heap_len;
+        }
+        qsort(merged, total, sizeof(BeamChild), compareChildren);
+        if (total > width) total = width;
+        stats->statesExpanded += b.count;
+
+        // Materialize the kept children into the other generation
+        int next = 1 - b.gen;
+        for (int i = 0; i < total; i++) {
+            const BeamChild* c = &merged[i];
+            int from = b.gen * width + c->parent;
+            int to = next * width + i;
+            int* map = b.mapping + (size_t)to * G->n;
+            unsigned char* used = b.used + (size_t)to * H->n;
+
+            memcpy(map, b.mapping + (size_t)from * G->n, level * sizeof(int));
+            memcpy(used, b.used + (size_t)from * H->n, H->n);
+            map[level] = c->image;
+            b.added[to] = b.added[from];
+            if (c->image < H->n) used[c->image] = 1;
+            else b.added[to]++;
+            b.cost[to] = c->cost;
+            b.used_edges[to] = c->used_edges;
+        }
+        b.count = total;
+        b.gen = next;
+        stats->levels = level + 1;
+        traceEndArgs(traceStart, "beam level", "level", level, "threads", spawned + 1);
+    }
+
+    for (int t = 0; t < threads && workers; t++) {
+        stats->candidatesScored += workers[t].scored;
+        stats->candidatesPruned += workers[t].pruned;
+        free(workers[t].heap);
+    }
+
+    // After the last level the children are ranked by final cost
+    GreedyExtension* result = seed;
+    int best = b.gen * width;
+    if (ok && stats->levels == G->n && b.count > 0 && b.cost[best] < stats->seedCost) {
+        int* mapping = malloc(G->n * sizeof(int));
+        if (mapping) {
+            const int* row = b.mapping + (size_t)best * G->n;
+            for (int i = 0; i < G->n; i++) mapping[b.order[i]] = row[i];
+            result = greedyExtensionFromMapping(G, H, mapping, b.added[best]);
+            if (result) {
+                freeGreedyExtension(seed);
+                stats->fromSeed = 0;
+            } else {
+                result = seed;
+            }
+        }
+    }
+    if (result) {
+        result->candidatesScored = stats->candidatesScored;
+        result->fullScanCandidates = stats->candidatesScored;
+    }
+
+    beamSearchFree(&b);
+    free(workers);
+    free(tids);
+    free(merged);
+    stats->elapsed = wallSeconds() - started;
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef BEAM_EXTENSION_H
+#define BEAM_EXTENSION_H
+
+#include "graph.h"
+#include "gmext.h"
+
+/**
+ * Options for beam_extension. Zero-initialised options use the defaults.
+ *
+ * width   - partial mappings kept per level (0 = default of 16). Width 1
+ *           behaves like a single greedy ordering; larger widths move the
+ *           result towards the exact optimum at proportional cost
+ * threads - worker threads expanding each level (<= 1 = calling thread).
+ *           The result does not depend on the thread count
+ */
+typedef struct {
+    int width;
+    int threads;
+} BeamOptions;
+
+/**
+ * Counters filled by beam_extension.
+ */
+typedef struct {
+    int width;              // effective beam width
+    int levels;             // levels expanded (pattern vertices placed)
+    long statesExpanded;    // partial mappings whose children were generated
+    long candidatesScored;  // children evaluated (H vertex or new vertex)
+    long candidatesPruned;  // children dropped by the greedy upper bound
+    int rootBound;          // admissible lower bound of the empty mapping
+    int seedCost;           // cost of the greedy mapping used as upper bound
+    int fromSeed;           // 1 when no beam state beat the greedy seed
+    double elapsed;         // wall-clock seconds
+} BeamStats;
+
+/**
+ * Beam search for a minimal extension of H containing G.
+ *
+ * Pattern vertices are placed one level at a time (BFS order from the
+ * highest-degree vertex). Each level expands every kept partial mapping
+ * by all unused H vertices plus one new vertex, and keeps the `width`
+ * children with the lowest cost so far plus an admissible bound on the
+ * cost still to come:
+ *
+ *   missing vertices - unmapped G vertices beyond the unused H vertices
+ *   missing edges    - undecided G edges beyond the H edges not yet
+ *                      inside the image
+ *
+ * The plain greedy mapping seeds an upper bound: children whose bound
+ * exceeds it are pruned, and it is returned if the beam does not beat it.
+ *
+ * @param G The pattern graph.
+ * @param H The host graph.
+ * @param opts Options (NULL = defaults).
+ * @param stats Optional counters (may be NULL).
+ * @return GreedyExtension with the extension details, or NULL on failure.
+ */
+GreedyExtension* beam_extension(Graph* G, Graph* H, const BeamOptions* opts, BeamStats* stats);
+
+#endif // BEAM_EXTENSION_H
@@ -0,0 +1,593 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "graph.h"
+#include "subiso.h"
+#include "gmext.h"
+#include "exact_extension.h"
+#include "timing.h"
+
+/**
+ * =============================================================================
+ * BENCHMARK SUITE (make bench)
+ * =============================================================================
+ * Generates parameterised graph families with graphgen (path, cycle,
+ * complete and random graphs at increasing n and density, always from the
+ * same seed), then times load, distance, subiso, greedy and exact on them,
+ * plus microbenchmarks of the kernels those phases spend their time in.
+ *
+ * Every case is run `reps` times. A run repeats the operation until it
+ * took at least BENCH_MIN_RUN_SECONDS, so fast cases are not lost in
+ * clock resolution; its time is the mean per operation. A case reports
+ * the median over its runs, the median absolute deviation, min and max.
+ *
+ * Results go to stdout as one JSON object per case and a table goes to
+ * stderr. With a baseline (an earlier stdout), a case whose median is more
+ * than `threshold` percent above the baseline's, by more than three times
+ * the two runs' combined deviation, is a regression and the exit status
+ * is 1.
+ * =============================================================================
+ */
+
+#define BENCH_MIN_RUN_SECONDS 0.05
+#define BENCH_MAX_INNER 1000000
+#define BENCH_SEED 20240917u
+// Differences below this are timer noise, whatever the ratio.
+#define BENCH_NOISE_FLOOR_MS 0.002
+
+typedef struct {
+    const char* graphgen;
+    const char* dir;
+    int reps;
+    double threshold;    // percent
+    const char* baseline;
+    const char* only;    // run cases whose name contains this (NULL = all)
+} BenchConfig;
+
+typedef struct {
+    char name[128];
+    double median;       // milliseconds per operation
+    double mad;
+} BaselineEntry;
+
+typedef struct {
+    BaselineEntry* entries;
+    int count;
+    int regressions;
+    int compared;
+} Baseline;
+
+typedef void (*BenchOp)(void* arg);
+
+// --- Graph families ---
+
+// Returns the graph graphgen produced for (type, n, k), generating it the
+// first time. k is the edge count of random graphs, 0 otherwise.
+static Graph* familyGraph(const BenchConfig* cfg, const char* type, int n, int k,
+                          char* path, size_t pathSize) {
+    if (k > 0) snprintf(path, pathSize, "%s/%s-%d-%d.txt", cfg->dir, type, n, k);
+    else snprintf(path, pathSize, "%s/%s-%d.txt", cfg->dir, type, n);
+
+    if (access(path, R_OK) != 0) {
+        char cmd[1024];
+        char count[16] = "";
+        if (k > 0) snprintf(count, sizeof(count), " %d", k);
+        snprintf(cmd, sizeof(cmd), "GRAPHGEN_SEED=%u '%s' single %s '%s' %d%s > /dev/null",
+                 BENCH_SEED, cfg->graphgen, type, path, n, count);
+        if (system(cmd) != 0) {
+            fprintf(stderr, "bench: graphgen failed: %s\n", cmd);
+            return NULL;
+        }
+    }
+    Graph* g = loadGraph(path);
+    if (!g) fprintf(stderr, "bench: cannot load %s\n", path);
+    return g;
+}
+
+static int randomEdges(int n, double density) {
+    int k = (int)(density * n * (n - 1) / 2);
+    return k < n - 1 ? n - 1 : k;
+}
+
+// A family member: "random" graphs take a density, the others only n.
+static Graph* member(const BenchConfig* cfg, const char* type, int n, double density) {
+    char path[512];
+    int k = strcmp(type, "random") == 0 ? randomEdges(n, density) : 0;
+    return familyGraph(cfg, type, n, k, path, sizeof(path));
+}
+
+// --- Measurement ---
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double* v, int n) {
+    qsort(v, n, sizeof(double), compareDoubles);
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+typedef struct {
+    double median;
+    double mad;
+    double min;
+    double max;
+    long inner;          // operations per run
+} Summary;
+
+static void measure(BenchOp op, void* arg, int reps, Summary* out) {
+    // Calibrate: one operation (also a warm-up), then enough per run
+    double t0 = wallSeconds();
+    op(arg);
+    double once = wallSeconds() - t0;
+    long inner = once > 0 ? (long)(BENCH_MIN_RUN_SECONDS / once) + 1 : BENCH_MAX_INNER;
+    if (inner > BENCH_MAX_INNER) inner = BENCH_MAX_INNER;
+
+    double* runs = malloc(reps * sizeof(double));
+    double* dev = malloc(reps * sizeof(double));
+    if (!runs || !dev) {
+        free(runs);
+        free(dev);
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    for (int r = 0; r < reps; r++) {
+        t0 = wallSeconds();
+        for (long i = 0; i < inner; i++) op(arg);
+        runs[r] = (wallSeconds() - t0) * 1000.0 / inner;
+    }
+    out->median = median(runs, reps);
+    out->min = runs[0];
+    out->max = runs[reps - 1];
+    for (int r = 0; r < reps; r++) {
+        dev[r] = runs[r] > out->median ? runs[r] - out->median : out->median - runs[r];
+    }
+    out->mad = median(dev, reps);
+    out->inner = inner;
+    free(runs);
+    free(dev);
+}
+
+// --- Baseline ---
+
+static void loadBaseline(const char* path, Baseline* b) {
+    memset(b, 0, sizeof(*b));
+    FILE* f = path ? fopen(path, "r") : NULL;
+    if (!f) return;
+    char line[1024];
+    int cap = 0;
+    while (fgets(line, sizeof(line), f)) {
+        const char* name = strstr(line, "\"name\":\"");
+        const char* med = strstr(line, "\"median_ms\":");
+        const char* mad = strstr(line, "\"mad_ms\":");
+        if (!name || !med || !mad) continue;
+        if (b->count == cap) {
+            cap = cap ? 2 * cap : 64;
+            BaselineEntry* e = realloc(b->entries, cap * sizeof(BaselineEntry));
+            if (!e) break;
+            b->entries = e;
+        }
+        BaselineEntry* e = &b->entries[b->count];
+        name += strlen("\"name\":\"");
+        size_t len = strcspn(name, "\"");
+        if (len >= sizeof(e->name)) continue;
+        memcpy(e->name, name, len);
+        e->name[len] = '\0';
+        if (sscanf(med + strlen("\"median_ms\":"), "%lf", &e->median) == 1 &&
+            sscanf(mad + strlen("\"mad_ms\":"), "%lf", &e->mad) == 1) {
+            b->count++;
+        }
+    }
+    fclose(f);
+}
+
+static const BaselineEntry* findBaseline(const Baseline* b, const char* name) {
+    for (int i = 0; i < b->count; i++) {
+        if (strcmp(b->entries[i].name, name) == 0) return &b->entries[i];
+    }
+    return NULL;
+}
+
+// --- Reporting ---
+
+typedef struct {
+    const char* bench;   // load, distance, subiso, greedy, exact, kernel
+    const char* family;
+    int n;
+    int m;
+    long long units;     // work items per operation (0 = not a per-unit kernel)
+    const char* unit;
+} CaseInfo;
+
+static bool selected(const BenchConfig* cfg, const char* name) {
+    return !cfg->only || strstr(name, cfg->only);
+}
+
+static void report(const BenchConfig* cfg, Baseline* base, const char* name,
+                   const CaseInfo* info, const Summary* s) {
+    printf("{\"name\":\"%s\",\"bench\":\"%s\",\"family\":\"%s\",\"n\":%d,\"m\":%d,"
+           "\"reps\":%d,\"inner\":%ld,\"median_ms\":%.6f,\"mad_ms\":%.6f,"
+           "\"min_ms\":%.6f,\"max_ms\":%.6f",
+           name, info->bench, info->family, info->n, info->m, cfg->reps, s->inner,
+           s->median, s->mad, s->min, s->max);
+    if (info->units > 0) {
+        printf(",\"units\":%lld,\"unit\":\"%s\",\"ns_per_unit\":%.3f", info->units, info->unit,
+               s->median * 1e6 / info->units);
+    }
+
+    const BaselineEntry* e = findBaseline(base, name);
+    const char* verdict = "";
+    if (e) {
+        double change = e->median > 0 ? 100.0 * (s->median - e->median) / e->median : 0.0;
+        double gap = s->median - e->median;
+        bool regressed = change > cfg->threshold && gap > BENCH_NOISE_FLOOR_MS &&
+                         gap > 3.0 * (s->mad + e->mad);
+        printf(",\"baseline_ms\":%.6f,\"change_pct\":%.1f,\"regression\":%s",
+               e->median, change, regressed ? "true" : "false");
+        base->compared++;
+        if (regressed) {
+            base->regressions++;
+            verdict = "  REGRESSION";
+        }
+    }
+    printf("}\n");
+    fflush(stdout);
+
+    fprintf(stderr, "  %-44s %11.4f ms  +/- %-9.4f [%.4f .. %.4f]",
+            name, s->median, s->mad, s->min, s->max);
+    if (info->units > 0) fprintf(stderr, "  %.1f ns/%s", s->median * 1e6 / info->units, info->unit);
+    if (e) fprintf(stderr, "  (%+.1f%%)%s", 100.0 * (s->median - e->median) / e->median, verdict);
+    fprintf(stderr, "\n");
+}
+
+// --- Operations ---
+
+typedef struct {
+    const Graph* G;
+    const Graph* H;
+    const char* path;
+} OpArgs;
+
+static void opLoad(void* arg) {
+    freeGraph(loadGraph(((OpArgs*)arg)->path));
+}
+
+static void opDistance(void* arg) {
+    OpArgs* a = arg;
+    GraphDistanceOptions opts = { DISTANCE_AUTO, 0, 1 };
+    graphDistanceWithOptions(a->G, a->H, &opts, NULL);
+}
+
+static void opSubiso(void* arg) {
+    OpArgs* a = arg;
+    isSubgraphIsomorphic(a->G, a->H);
+}
+
+static void opGreedy(void* arg) {
+    OpArgs* a = arg;
+    GreedyOptions opts = {0};
+    freeGreedyExtension(greedy_extension_with_options((Graph*)a->G, (Graph*)a->H, &opts));
+}
+
+static void opExact(void* arg) {
+    OpArgs* a = arg;
+    ExactOptions opts = {0};
+    freeExtensionObject(exactMinimalExtensionWithOptions(a->G, a->H, &opts, NULL));
+}
+
+typedef struct {
+    int n;
+    int** cost;
+    int* assignment;
+} HungarianArgs;
+
+static void opHungarian(void* arg) {
+    HungarianArgs* a = arg;
+    hungarianSolve(a->n, a->cost, a->assignment);
+}
+
+// One fixed search state: G vertex v is placed next, every unused H
+// vertex is a candidate.
+typedef struct {
+    const Graph* G;
+    const Graph* H;
+    int* map;
+    bool* usedH;
+    int v;
+    long long feasible;
+} CandidateArgs;
+
+static void opCandidateChecks(void* arg) {
+    CandidateArgs* a = arg;
+    for (int m = 0; m < a->H->n; m++) {
+        if (!a->usedH[m]) a->feasible += subisoCandidateFeasible(a->G, a->H, a->map, a->usedH, a->v, m);
+    }
+}
+
+// One fixed mapper state: the G vertices from `first` on are unmapped and
+// each is scored against every candidate, without being assigned.
+typedef struct {
+    GreedyMapper* mapper;
+    int first;
+    int n;
+    long scored;
+} ScoringArgs;
+
+static void opGreedyScoring(void* arg) {
+    ScoringArgs* a = arg;
+    for (int v = a->first; v < a->n; v++) greedyMapperSelect(a->mapper, v, &a->scored);
+}
+
+// --- Suites ---
+
+static const struct {
+    const char* type;
+    int n;
+    double density;      // random only
+} FAMILIES[] = {
+    { "path",     100, 0 }, { "path",     200, 0 }, { "path",     400, 0 }, { "path", 800, 0 },
+    { "cycle",    100, 0 }, { "cycle",    200, 0 }, { "cycle",    400, 0 }, { "cycle", 800, 0 },
+    { "complete",  25, 0 }, { "complete",  50, 0 }, { "complete", 100, 0 },
+    { "random",   100, 0.05 }, { "random", 200, 0.05 }, { "random", 400, 0.05 },
+    { "random",   100, 0.2 },  { "random", 200, 0.2 },  { "random", 400, 0.2 },
+};
+#define FAMILY_COUNT ((int)(sizeof(FAMILIES) / sizeof(FAMILIES[0])))
+
+// Distance is O(n^3); larger members only run load
+#define BENCH_DISTANCE_MAX_N 400
+
+static void familyName(char* buf, size_t size, const char* type, int n, double density) {
+    if (strcmp(type, "random") == 0) snprintf(buf, size, "%s-n%d-d%.2f", type, n, density);
+    else snprintf(buf, size, "%s-n%d", type, n);
+}
+
+static int runLoadAndDistance(const BenchConfig* cfg, Baseline* base) {
+    for (int i = 0; i < FAMILY_COUNT; i++) {
+        const char* type = FAMILIES[i].type;
+        int n = FAMILIES[i].n;
+        char path[512], fam[64], name[128];
+        int k = strcmp(type, "random") == 0 ? randomEdges(n, FAMILIES[i].density) : 0;
+        Graph* g = familyGraph(cfg, type, n, k, path, sizeof(path));
+        if (!g) return -1;
+        familyName(fam, sizeof(fam), type, n, FAMILIES[i].density);
+
+        OpArgs a = { g, NULL, path };
+        CaseInfo info = { "load", type, n, g->m, 0, NULL };
+        Summary s;
+        snprintf(name, sizeof(name), "load/%s", fam);
+        if (selected(cfg, name)) {
+            measure(opLoad, &a, cfg->reps, &s);
+            report(cfg, base, name, &info, &s);
+        }
+
+        // Against a sparse random graph of the same order
+        snprintf(name, sizeof(name), "distance/%s", fam);
+        if (n <= BENCH_DISTANCE_MAX_N && selected(cfg, name)) {
+            Graph* h = member(cfg, "random", n, 0.05);
+            if (!h) {
+                freeGraph(g);
+                return -1;
+            }
+            a.H = h;
+            info.bench = "distance";
+            measure(opDistance, &a, cfg->reps, &s);
+            report(cfg, base, name, &info, &s);
+            freeGraph(h);
+        }
+        freeGraph(g);
+    }
+    return 0;
+}
+
+// Pattern and host specs of the subiso, greedy and exact suites
+typedef struct {
+    const char* type;
+    int n;
+    double density;
+} Spec;
+
+static int runPairs(const BenchConfig* cfg, Baseline* base, const char* bench, BenchOp op,
+                    const Spec* patterns, int patternCount, const Spec* hosts, int hostCount) {
+    for (int p = 0; p < patternCount; p++) {
+        for (int h = 0; h < hostCount; h++) {
+            char pf[48], hf[48], name[128];
+            familyName(pf, sizeof(pf), patterns[p].type, patterns[p].n, patterns[p].density);
+            familyName(hf, sizeof(hf), hosts[h].type, hosts[h].n, hosts[h].density);
+            snprintf(name, sizeof(name), "%s/%s-in-%s", bench, pf, hf);
+            if (!selected(cfg, name)) continue;
+
+            Graph* G = member(cfg, patterns[p].type, patterns[p].n, patterns[p].density);
+            Graph* H = G ? member(cfg, hosts[h].type, hosts[h].n, hosts[h].density) : NULL;
+            if (!G || !H) {
+                freeGraph(G);
+                return -1;
+            }
+            OpArgs a = { G, H, NULL };
+            CaseInfo info = { bench, patterns[p].type, H->n, H->m, 0, NULL };
+            Summary s;
+            measure(op, &a, cfg->reps, &s);
+            report(cfg, base, name, &info, &s);
+            freeGraph(G);
+            freeGraph(H);
+        }
+    }
+    return 0;
+}
+
+static int runSolvers(const BenchConfig* cfg, Baseline* base) {
+    static const Spec subisoPatterns[] = {
+        { "path", 8, 0 }, { "cycle", 8, 0 }, { "complete", 4, 0 }, { "random", 8, 0.4 },
+    };
+    static const Spec subisoHosts[] = {
+        { "random", 100, 0.05 }, { "random", 200, 0.05 }, { "random", 400, 0.05 },
+    };
+    static const Spec greedyPatterns[] = {
+        { "path", 20, 0 }, { "cycle", 20, 0 }, { "complete", 10, 0 }, { "random", 20, 0.3 },
+    };
+    static const Spec greedyHosts[] = {
+        { "random", 40, 0.2 }, { "random", 80, 0.2 }, { "random", 160, 0.2 },
+    };
+    static const Spec exactPatterns[] = {
+        { "path", 6, 0 }, { "cycle", 6, 0 }, { "complete", 5, 0 }, { "random", 6, 0.6 },
+    };
+    static const Spec exactHosts[] = {
+        { "random", 6, 0.4 }, { "random", 7, 0.4 }, { "random", 8, 0.4 },
+    };
+#define SPECS(a) a, (int)(sizeof(a) / sizeof(a[0]))
+    if (runPairs(cfg, base, "subiso", opSubiso, SPECS(subisoPatterns), SPECS(subisoHosts)) != 0 ||
+        runPairs(cfg, base, "greedy", opGreedy, SPECS(greedyPatterns), SPECS(greedyHosts)) != 0 ||
+        runPairs(cfg, base, "exact", opExact, SPECS(exactPatterns), SPECS(exactHosts)) != 0) {
+        return -1;
+    }
+#undef SPECS
+    return 0;
+}
+
+static int runKernels(const BenchConfig* cfg, Baseline* base) {
+    static const int sizes[] = { 32, 64, 128 };
+    char name[128];
+    Summary s;
+
+    // hungarianSolve on pseudo-random costs
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+        int n = sizes[i];
+        snprintf(name, sizeof(name), "kernel/hungarian-n%d", n);
+        if (!selected(cfg, name)) continue;
+        HungarianArgs a = { n, allocMatrix(n), malloc(n * sizeof(int)) };
+        if (!a.cost || !a.assignment) {
+            free(a.assignment);
+            return -1;
+        }
+        unsigned int x = BENCH_SEED;
+        for (int r = 0; r < n; r++) {
+            for (int c = 0; c < n; c++) {
+                x = x * 1103515245u + 12345u;
+                a.cost[r][c] = (int)((x >> 8) % 1000);
+            }
+        }
+        CaseInfo info = { "kernel", "hungarian", n, 0, 0, NULL };
+        measure(opHungarian, &a, cfg->reps, &s);
+        report(cfg, base, name, &info, &s);
+        for (int r = 0; r < n; r++) free(a.cost[r]);
+        free(a.cost);
+        free(a.assignment);
+    }
+
+    // The greedy mapper's candidate scoring, per candidate scored: the
+    // first half of G is mapped greedily in id order, then every vertex of
+    // the second half is scored against that state
+    snprintf(name, sizeof(name), "kernel/greedy-score-random-n40-in-random-n160");
+    if (selected(cfg, name)) {
+        Graph* G = member(cfg, "random", 40, 0.3);
+        Graph* H = G ? member(cfg, "random", 160, 0.2) : NULL;
+        GreedyMapper* mapper = H ? greedyMapperCreate(G, H, GREEDY_CANDIDATES_FULL) : NULL;
+        if (!G || !H || !mapper) {
+            freeGraph(G);
+            freeGraph(H);
+            return -1;
+        }
+        ScoringArgs a = { mapper, G->n / 2, G->n, 0 };
+        for (int v = 0; v < a.first; v++) greedyMapperAssign(mapper, v, greedyMapperSelect(mapper, v, NULL));
+        opGreedyScoring(&a);
+        long perOp = a.scored;
+        measure(opGreedyScoring, &a, cfg->reps, &s);
+        CaseInfo info = { "kernel", "greedy-score", H->n, H->m, perOp, "candidate" };
+        report(cfg, base, name, &info, &s);
+        greedyMapperFree(mapper);
+        freeGraph(G);
+        freeGraph(H);
+    }
+
+    // subgraphRec's degree, adjacency and lookahead checks, per candidate:
+    // two vertices of K5 are mapped onto an edge at H's highest-degree
+    // vertex and the third is tried against every other H vertex
+    snprintf(name, sizeof(name), "kernel/subiso-candidates-complete-n5-in-random-n400");
+    if (selected(cfg, name)) {
+        Graph* G = member(cfg, "complete", 5, 0);
+        Graph* H = G ? member(cfg, "random", 400, 0.05) : NULL;
+        int* map = G ? malloc(G->n * sizeof(int)) : NULL;
+        bool* usedH = H ? calloc(H->n, sizeof(bool)) : NULL;
+        if (!G || !H || !map || !usedH) {
+            freeGraph(G);
+            freeGraph(H);
+            free(map);
+            free(usedH);
+            return -1;
+        }
+        int hub = 0;
+        for (int v = 1; v < H->n; v++) {
+            if (H->adjSize[v] > H->adjSize[hub]) hub = v;
+        }
+        for (int v = 0; v < G->n; v++) map[v] = -1;
+        map[0] = hub;
+        map[1] = H->adj[hub][0];
+        usedH[map[0]] = usedH[map[1]] = true;
+        CandidateArgs a = { G, H, map, usedH, 2, 0 };
+        measure(opCandidateChecks, &a, cfg->reps, &s);
+        CaseInfo info = { "kernel", "subiso-candidates", H->n, H->m, H->n - 2, "candidate" };
+        report(cfg, base, name, &info, &s);
+        freeGraph(G);
+        freeGraph(H);
+        free(map);
+        free(usedH);
+    }
+    return 0;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [options] > results.json\n", program);
+    fprintf(stderr, "  --graphgen <path>   graphgen executable (default ./graphgen)\n");
+    fprintf(stderr, "  --dir <dir>         where generated graphs are kept (default bench_data)\n");
+    fprintf(stderr, "  --reps <n>          runs per case (default 5)\n");
+    fprintf(stderr, "  --baseline <file>   compare against an earlier output\n");
+    fprintf(stderr, "  --threshold <pct>   allowed median slowdown (default 25)\n");
+    fprintf(stderr, "  --only <text>       run only cases whose name contains <text>\n");
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg = { "./graphgen", "bench_data", 5, 25.0, NULL, NULL };
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--graphgen") == 0 && value) cfg.graphgen = argv[++i];
+        else if (strcmp(argv[i], "--dir") == 0 && value) cfg.dir = argv[++i];
+        else if (strcmp(argv[i], "--reps") == 0 && value) cfg.reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--baseline") == 0 && value) cfg.baseline = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && value) cfg.threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--only") == 0 && value) cfg.only = argv[++i];
+        else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.reps < 1) cfg.reps = 1;
+    mkdir(cfg.dir, 0755);
+
+    Baseline base;
+    loadBaseline(cfg.baseline, &base);
+    if (cfg.baseline && base.count == 0) {
+        fprintf(stderr, "bench: no baseline in '%s' (make bench-baseline records one)\n",
+                cfg.baseline);
+    }
+
+    fprintf(stderr, "bench: %d runs per case, medians per operation\n", cfg.reps);
+    double started = wallSeconds();
+    int status = 0;
+    if (runLoadAndDistance(&cfg, &base) != 0 || runSolvers(&cfg, &base) != 0 ||
+        runKernels(&cfg, &base) != 0) {
+        status = 2;
+    }
+    fprintf(stderr, "bench: done in %.1fs", wallSeconds() - started);
+    if (base.count > 0) {
+        fprintf(stderr, ", %d of %d cases compared, %d regression%s over %.0f%%",
+                base.compared, base.count, base.regressions, base.regressions == 1 ? "" : "s",
+                cfg.threshold);
+        if (base.regressions > 0 && status == 0) status = 1;
+    }
+    fprintf(stderr, "\n");
+    free(base.entries);
+    return status;
+}
@@ -0,0 +1,514 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "dynamic.h"
+
+/**
+ * A matching order over the pattern: position -> pattern vertex, with the
+ * earlier adjacent positions of each position and the one whose image's
+ * neighbours supply the candidates (-1: every host vertex).
+ */
+typedef struct {
+    int* order;
+    int* source;
+    int* backStart;
+    int* back;
+} SearchOrder;
+
+/**
+ * Edges of H in an open-addressing hash set (linear probing, backward-shift
+ * deletion), so adjacency tests cost O(1) and memory stays O(m) however
+ * large H is. Key 0 marks an empty slot.
+ */
+typedef struct {
+    uint64_t* keys;
+    size_t mask;          // capacity - 1 (capacity is a power of two)
+    size_t count;
+} EdgeSet;
+
+struct DynamicMatcher {
+    DynamicMode mode;
+
+    // Pattern
+    int gn;
+    int gm;
+    int (*edges)[2];      // edges of G, u < v
+    int* gdegree;
+    SearchOrder global;   // unseeded order
+    SearchOrder* seeded;  // 2 * gm orders: 2e starts (u, v), 2e + 1 starts (v, u)
+
+    // Host
+    int n;
+    int* degree;
+    int** adj;
+    int* adjCap;
+    EdgeSet edgeSet;
+
+    // Search scratch, indexed by position
+    int* map;
+    int* cursor;
+    uint64_t* used;       // host vertices in use (bitset)
+
+    bool contains;
+    long long count;      // DYNAMIC_COUNT only
+    int* witness;         // DYNAMIC_VERDICT: pattern vertex -> host vertex
+    DynamicStats stats;
+};
+
+// --- Edge set ---
+
+static uint64_t edgeKey(int a, int b) {
+    if (a > b) { int t = a; a = b; b = t; }
+    return (((uint64_t)a << 32) | (uint32_t)b) + 1;
+}
+
+static size_t edgeSlot(const EdgeSet* s, uint64_t key) {
+    uint64_t x = key * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(x ^ (x >> 29)) & s->mask;
+}
+
+static bool edgeSetHas(const EdgeSet* s, int a, int b) {
+    uint64_t key = edgeKey(a, b);
+    for (size_t i = edgeSlot(s, key); s->keys[i]; i = (i + 1) & s->mask) {
+        if (s->keys[i] == key) return true;
+    }
+    return false;
+}
+
+static int edgeSetGrow(EdgeSet* s) {
+    size_t capacity = (s->mask + 1) * 2;
+    uint64_t* old = s->keys;
+    size_t oldCapacity = s->mask + 1;
+    s->keys = calloc(capacity, sizeof(uint64_t));
+    if (!s->keys) {
+        s->keys = old;
+        return -1;
+    }
+    s->mask = capacity - 1;
+    for (size_t j = 0; j < oldCapacity; j++) {
+        if (!old[j]) continue;
+        size_t i = edgeSlot(s, old[j]);
+        while (s->keys[i]) i = (i + 1) & s->mask;
+        s->keys[i] = old[j];
+    }
+    free(old);
+    return 0;
+}
+
+static int edgeSetAdd(EdgeSet* s, int a, int b) {
+    if (2 * (s->count + 1) > s->mask + 1 && edgeSetGrow(s) != 0) return -1;
+    uint64_t key = edgeKey(a, b);
+    size_t i = edgeSlot(s, key);
+    while (s->keys[i]) i = (i + 1) & s->mask;
+    s->keys[i] = key;
+    s->count++;
+    return 0;
+}
+
+static void edgeSetRemove(EdgeSet* s, int a, int b) {
+    uint64_t key = edgeKey(a, b);
+    size_t i = edgeSlot(s, key);
+    while (s->keys[i] != key) {
+        if (!s->keys[i]) return;
+        i = (i + 1) & s->mask;
+    }
+    // Shift later members of the probe run back into the hole
+    for (size_t j = (i + 1) & s->mask; s->keys[j]; j = (j + 1) & s->mask) {
+        size_t home = edgeSlot(s, s->keys[j]);
+        if (((j - home) & s->mask) >= ((j - i) & s->mask)) {
+            s->keys[i] = s->keys[j];
+            i = j;
+        }
+    }
+    s->keys[i] = 0;
+    s->count--;
+}
+
+// --- Orders ---
+
+static void freeOrder(SearchOrder* o) {
+    free(o->order);
+    free(o->source);
+    free(o->backStart);
+    free(o->back);
+}
+
+// Order starting with `first` and `second` (or none when first < 0); then
+// most neighbours already placed, then highest degree.
+static int buildOrder(const Graph* G, int first, int second, SearchOrder* o) {
+    int n = G->n;
+    int len = n > 0 ? n : 1;
+    o->order = malloc(len * sizeof(int));
+    o->source = malloc(len * sizeof(int));
+    o->backStart = malloc((n + 1) * sizeof(int));
+    o->back = malloc((2 * G->m > 0 ? 2 * G->m : 1) * sizeof(int));
+    int* pos = malloc(len * sizeof(int));
+    int* placedNeighbours = calloc(len, sizeof(int));
+    if (!o->order || !o->source || !o->backStart || !o->back || !pos || !placedNeighbours) {
+        free(pos);
+        free(placedNeighbours);
+        return -1;
+    }
+    for (int v = 0; v < n; v++) pos[v] = -1;
+
+    for (int i = 0; i < n; i++) {
+        int best = i == 0 ? first : i == 1 ? second : -1;
+        if (best < 0) {
+            for (int v = 0; v < n; v++) {
+                if (pos[v] >= 0) continue;
+                if (best < 0 || placedNeighbours[v] > placedNeighbours[best] ||
+                    (placedNeighbours[v] == placedNeighbours[best] && G->adjSize[v] > G->adjSize[best])) {
+                    best = v;
+                }
+            }
+        }
+        pos[best] = i;
+        o->order[i] = best;
+        for (int j = 0; j < G->adjSize[best]; j++) placedNeighbours[G->adj[best][j]]++;
+    }
+
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        int v = o->order[i];
+        o->backStart[i] = k;
+        o->source[i] = -1;
+        for (int j = 0; j < G->adjSize[v]; j++) {
+            int q = pos[G->adj[v][j]];
+            if (q >= i) continue;
+            o->back[k++] = q;
+            if (o->source[i] < 0 || G->adjSize[o->order[q]] < G->adjSize[o->order[o->source[i]]]) {
+                o->source[i] = q;
+            }
+        }
+    }
+    o->backStart[n] = k;
+    free(pos);
+    free(placedNeighbours);
+    return 0;
+}
+
+// --- Search ---
+
+static void markUsed(DynamicMatcher* dm, int v) { dm->used[v >> 6] |= 1ULL << (v & 63); }
+static void clearUsed(DynamicMatcher* dm, int v) { dm->used[v >> 6] &= ~(1ULL << (v & 63)); }
+static bool isUsed(const DynamicMatcher* dm, int v) { return dm->used[v >> 6] & (1ULL << (v & 63)); }
+
+static void saveWitness(DynamicMatcher* dm, const SearchOrder* o) {
+    for (int i = 0; i < dm->gn; i++) dm->witness[o->order[i]] = dm->map[i];
+}
+
+/**
+ * Extends the partial embedding map[0 .. start) along o. Returns the
+ * number of complete embeddings (at most 1 with stopAtFirst, which also
+ * stores the witness). Used bits of map[0 .. start) are left as they were.
+ */
+static long long extendEmbeddings(DynamicMatcher* dm, const SearchOrder* o, int start, bool stopAtFirst) {
+    int n = dm->gn;
+    int* map = dm->map;
+    int* cursor = dm->cursor;
+    if (start == n) {
+        if (stopAtFirst) saveWitness(dm, o);
+        return 1;
+    }
+
+    long long found = 0;
+    int level = start;
+    cursor[level] = 0;
+    while (level >= start) {
+        int v = o->order[level];
+        int source = o->source[level];
+        const int* cand = NULL;
+        int count = dm->n;
+        if (source >= 0) {
+            cand = dm->adj[map[source]];
+            count = dm->degree[map[source]];
+        }
+
+        int next = -1;
+        while (cursor[level] < count) {
+            int c = cand ? cand[cursor[level]] : cursor[level];
+            cursor[level]++;
+            if (isUsed(dm, c) || dm->degree[c] < dm->gdegree[v]) continue;
+            bool ok = true;
+            for (int e = o->backStart[level]; e < o->backStart[level + 1] && ok; e++) {
+                int q = o->back[e];
+                if (q != source) ok = edgeSetHas(&dm->edgeSet, c, map[q]);
+            }
+            if (ok) {
+                next = c;
+                break;
+            }
+        }
+
+        if (next < 0) {
+            if (--level >= start) clearUsed(dm, map[level]);
+            continue;
+        }
+        dm->stats.extensions++;
+        map[level] = next;
+        if (level + 1 < n) {
+            markUsed(dm, next);
+            cursor[++level] = 0;
+            continue;
+        }
+        found++;
+        if (stopAtFirst) {
+            saveWitness(dm, o);
+            for (int i = start; i < level; i++) clearUsed(dm, map[i]);
+            return found;
+        }
+    }
+    return found;
+}
+
+// Embeddings that map oriented pattern edge `oriented` onto (a, b).
+static long long seededEmbeddings(DynamicMatcher* dm, int oriented, int a, int b, bool stopAtFirst) {
+    const SearchOrder* o = &dm->seeded[oriented];
+    if (dm->degree[a] < dm->gdegree[o->order[0]] || dm->degree[b] < dm->gdegree[o->order[1]]) return 0;
+    dm->stats.seededSearches++;
+    dm->map[0] = a;
+    dm->map[1] = b;
+    markUsed(dm, a);
+    markUsed(dm, b);
+    long long found = extendEmbeddings(dm, o, 2, stopAtFirst);
+    clearUsed(dm, a);
+    clearUsed(dm, b);
+    return found;
+}
+
+// Embeddings that use host edge (a, b), which must be present.
+static long long embeddingsThrough(DynamicMatcher* dm, int a, int b, bool stopAtFirst) {
+    long long total = 0;
+    for (int k = 0; k < 2 * dm->gm; k++) {
+        total += seededEmbeddings(dm, k, a, b, stopAtFirst);
+        if (stopAtFirst && total > 0) break;
+    }
+    return total;
+}
+
+static long long globalEmbeddings(DynamicMatcher* dm, bool stopAtFirst) {
+    if (dm->gn > dm->n) return 0;
+    dm->stats.globalSearches++;
+    return extendEmbeddings(dm, &dm->global, 0, stopAtFirst);
+}
+
+static bool witnessUses(const DynamicMatcher* dm, int a, int b) {
+    for (int e = 0; e < dm->gm; e++) {
+        int x = dm->witness[dm->edges[e][0]], y = dm->witness[dm->edges[e][1]];
+        if ((x == a && y == b) || (x == b && y == a)) return true;
+    }
+    return false;
+}
+
+// After the witness lost host edge (a, b): look for an embedding that keeps
+// the pattern vertex on a (then the one on b) in place, seeded from each of
+// its pattern edges onto each host edge still at its image. This searches
+// next to the deleted edge only; false means a global search is needed.
+static bool reseedNearWitness(DynamicMatcher* dm, int a, int b) {
+    for (int side = 0; side < 2; side++) {
+        int h = side == 0 ? a : b;
+        int u = -1;
+        for (int v = 0; v < dm->gn && u < 0; v++) {
+            if (dm->witness[v] == h) u = v;
+        }
+        if (u < 0) continue;
+        for (int e = 0; e < dm->gm; e++) {
+            if (dm->edges[e][0] != u && dm->edges[e][1] != u) continue;
+            int oriented = dm->edges[e][0] == u ? 2 * e : 2 * e + 1;
+            for (int i = 0; i < dm->degree[h]; i++) {
+                if (seededEmbeddings(dm, oriented, h, dm->adj[h][i], true) > 0) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// --- Host updates ---
+
+static int addAdjacency(DynamicMatcher* dm, int a, int b) {
+    if (dm->degree[a] == dm->adjCap[a]) {
+        int capacity = dm->adjCap[a] ? 2 * dm->adjCap[a] : 4;
+        int* grown = realloc(dm->adj[a], capacity * sizeof(int));
+        if (!grown) return -1;
+        dm->adj[a] = grown;
+        dm->adjCap[a] = capacity;
+    }
+    dm->adj[a][dm->degree[a]++] = b;
+    return 0;
+}
+
+static void removeAdjacency(DynamicMatcher* dm, int a, int b) {
+    for (int i = 0; i < dm->degree[a]; i++) {
+        if (dm->adj[a][i] == b) {
+            dm->adj[a][i] = dm->adj[a][--dm->degree[a]];
+            return;
+        }
+    }
+}
+
+static int addEdge(DynamicMatcher* dm, int a, int b) {
+    if (edgeSetAdd(&dm->edgeSet, a, b) != 0) return -1;
+    if (addAdjacency(dm, a, b) != 0) {
+        edgeSetRemove(&dm->edgeSet, a, b);
+        return -1;
+    }
+    if (addAdjacency(dm, b, a) != 0) {
+        removeAdjacency(dm, a, b);
+        edgeSetRemove(&dm->edgeSet, a, b);
+        return -1;
+    }
+    return 0;
+}
+
+static void removeEdge(DynamicMatcher* dm, int a, int b) {
+    edgeSetRemove(&dm->edgeSet, a, b);
+    removeAdjacency(dm, a, b);
+    removeAdjacency(dm, b, a);
+}
+
+static bool validPair(const DynamicMatcher* dm, int a, int b) {
+    return a >= 0 && b >= 0 && a < dm->n && b < dm->n && a != b;
+}
+
+int dynamicInsertEdge(DynamicMatcher* dm, int a, int b) {
+    if (!validPair(dm, a, b)) return -1;
+    if (edgeSetHas(&dm->edgeSet, a, b)) {
+        dm->stats.ignored++;
+        return 0;
+    }
+    if (addEdge(dm, a, b) != 0) return -1;
+    dm->stats.updates++;
+
+    if (dm->mode == DYNAMIC_COUNT) {
+        dm->count += embeddingsThrough(dm, a, b, false);
+        dm->contains = dm->count > 0;
+    } else if (!dm->contains) {
+        dm->contains = embeddingsThrough(dm, a, b, true) > 0;
+    }
+    return 1;
+}
+
+int dynamicDeleteEdge(DynamicMatcher* dm, int a, int b) {
+    if (!validPair(dm, a, b)) return -1;
+    if (!edgeSetHas(&dm->edgeSet, a, b)) {
+        dm->stats.ignored++;
+        return 0;
+    }
+    dm->stats.updates++;
+
+    if (dm->mode == DYNAMIC_COUNT) {
+        dm->count -= embeddingsThrough(dm, a, b, false);  // counted while the edge exists
+        dm->contains = dm->count > 0;
+        removeEdge(dm, a, b);
+    } else {
+        removeEdge(dm, a, b);
+        if (dm->contains && witnessUses(dm, a, b)) {
+            dm->contains = reseedNearWitness(dm, a, b) || globalEmbeddings(dm, true) > 0;
+        }
+    }
+    return 1;
+}
+
+bool dynamicContains(const DynamicMatcher* dm) {
+    return dm->contains;
+}
+
+long long dynamicEmbeddingCount(const DynamicMatcher* dm) {
+    return dm->mode == DYNAMIC_COUNT ? dm->count : -1;
+}
+
+void dynamicGetStats(const DynamicMatcher* dm, DynamicStats* stats) {
+    *stats = dm->stats;
+}
+
+// --- Life cycle ---
+
+void dynamicMatcherFree(DynamicMatcher* dm) {
+    if (!dm) return;
+    free(dm->edges);
+    free(dm->gdegree);
+    freeOrder(&dm->global);
+    if (dm->seeded) {
+        for (int k = 0; k < 2 * dm->gm; k++) freeOrder(&dm->seeded[k]);
+    }
+    free(dm->seeded);
+    if (dm->adj) {
+        for (int v = 0; v < dm->n; v++) free(dm->adj[v]);
+    }
+    free(dm->adj);
+    free(dm->adjCap);
+    free(dm->degree);
+    free(dm->edgeSet.keys);
+    free(dm->map);
+    free(dm->cursor);
+    free(dm->used);
+    free(dm->witness);
+    free(dm);
+}
+
+DynamicMatcher* dynamicMatcherCreate(const Graph* G, const Graph* H, DynamicMode mode) {
+    DynamicMatcher* dm = calloc(1, sizeof(DynamicMatcher));
+    if (!dm) return NULL;
+    dm->mode = mode;
+    dm->gn = G->n;
+    dm->gm = G->m;
+    dm->n = H->n;
+    int glen = G->n > 0 ? G->n : 1;
+    int hlen = H->n > 0 ? H->n : 1;
+
+    dm->edges = malloc((G->m > 0 ? G->m : 1) * sizeof(*dm->edges));
+    dm->gdegree = malloc(glen * sizeof(int));
+    dm->seeded = calloc(2 * G->m > 0 ? 2 * G->m : 1, sizeof(SearchOrder));
+    dm->degree = calloc(hlen, sizeof(int));
+    dm->adj = calloc(hlen, sizeof(int*));
+    dm->adjCap = calloc(hlen, sizeof(int));
+    dm->map = malloc(glen * sizeof(int));
+    dm->cursor = malloc(glen * sizeof(int));
+    dm->used = calloc((hlen + 63) / 64, sizeof(uint64_t));
+    dm->witness = malloc(glen * sizeof(int));
+    size_t capacity = 16;
+    while (capacity < 2 * (size_t)H->m + 2) capacity *= 2;
+    dm->edgeSet.keys = calloc(capacity, sizeof(uint64_t));
+    dm->edgeSet.mask = capacity - 1;
+    if (!dm->edges || !dm->gdegree || !dm->seeded || !dm->degree || !dm->adj || !dm->adjCap ||
+        !dm->map || !dm->cursor || !dm->used || !dm->witness || !dm->edgeSet.keys) {
+        dynamicMatcherFree(dm);
+        return NULL;
+    }
+
+    int e = 0;
+    for (int u = 0; u < G->n; u++) {
+        dm->gdegree[u] = G->adjSize[u];
+        for (int j = 0; j < G->adjSize[u]; j++) {
+            int v = G->adj[u][j];
+            if (u < v) {
+                dm->edges[e][0] = u;
+                dm->edges[e][1] = v;
+                e++;
+            }
+        }
+    }
+    int status = buildOrder(G, -1, -1, &dm->global);
+    for (int k = 0; status == 0 && k < G->m; k++) {
+        status = buildOrder(G, dm->edges[k][0], dm->edges[k][1], &dm->seeded[2 * k]);
+        if (status == 0) status = buildOrder(G, dm->edges[k][1], dm->edges[k][0], &dm->seeded[2 * k + 1]);
+    }
+    for (int a = 0; status == 0 && a < H->n; a++) {
+        for (int j = 0; status == 0 && j < H->adjSize[a]; j++) {
+            int b = H->adj[a][j];
+            if (a < b) status = addEdge(dm, a, b);
+        }
+    }
+    if (status != 0) {
+        dynamicMatcherFree(dm);
+        return NULL;
+    }
+
+    if (mode == DYNAMIC_COUNT) {
+        dm->count = globalEmbeddings(dm, false);
+        dm->contains = dm->count > 0;
+    } else {
+        dm->contains = globalEmbeddings(dm, true) > 0;
+    }
+    return dm;
+}
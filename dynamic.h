@@ -0,0 +1,71 @@
+#ifndef DYNAMIC_H
+#define DYNAMIC_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+/**
+ * =============================================================================
+ * CONTINUOUS MATCHING UNDER EDGE UPDATES
+ * =============================================================================
+ * Keeps the answer to "does G embed in H?" (same non-induced semantics as
+ * isSubgraphIsomorphic) up to date while edges of H are inserted and
+ * deleted. H is loaded once; its vertex set is fixed.
+ *
+ * Every embedding that appears or disappears with an edge (a, b) maps some
+ * edge (u, v) of G onto it. For each oriented edge of G the matcher keeps a
+ * matching order that starts with u and v, so the embeddings through
+ * (a, b) are found by a search seeded at u -> a, v -> b that only grows
+ * outward from the changed edge.
+ *
+ *   DYNAMIC_VERDICT - keeps one witness embedding. An insertion while the
+ *                     answer is NO searches around the new edge. A deletion
+ *                     only matters if the witness used the edge; then a new
+ *                     witness is first searched for from the witness
+ *                     vertices at the deleted edge, and only if none is
+ *                     found there in the whole graph.
+ *   DYNAMIC_COUNT   - keeps the exact number of embeddings (injective maps
+ *                     V(G) -> V(H) preserving edges). Each update adds or
+ *                     subtracts the embeddings through the changed edge,
+ *                     so its cost depends only on those embeddings.
+ * =============================================================================
+ */
+
+typedef enum {
+    DYNAMIC_VERDICT,
+    DYNAMIC_COUNT
+} DynamicMode;
+
+typedef struct DynamicMatcher DynamicMatcher;
+
+typedef struct {
+    long updates;          // edge updates that changed H
+    long ignored;          // inserts of present / deletes of absent edges
+    long seededSearches;   // searches started at or next to a changed edge
+    long globalSearches;   // searches over all of H (start-up, lost witness)
+    long extensions;       // partial embeddings extended by one vertex
+} DynamicStats;
+
+/**
+ * Registers G against a private copy of H and computes the initial answer.
+ * Returns NULL if memory runs out.
+ */
+DynamicMatcher* dynamicMatcherCreate(const Graph* G, const Graph* H, DynamicMode mode);
+void dynamicMatcherFree(DynamicMatcher* dm);
+
+/**
+ * Applies one edge update. Returns 1 if H changed, 0 if the edge was
+ * already present (insert) or absent (delete), -1 for a vertex out of
+ * range, a self-loop or memory exhaustion.
+ */
+int dynamicInsertEdge(DynamicMatcher* dm, int a, int b);
+int dynamicDeleteEdge(DynamicMatcher* dm, int a, int b);
+
+bool dynamicContains(const DynamicMatcher* dm);
+
+/** Current number of embeddings (DYNAMIC_COUNT), or -1 in DYNAMIC_VERDICT mode. */
+long long dynamicEmbeddingCount(const DynamicMatcher* dm);
+
+void dynamicGetStats(const DynamicMatcher* dm, DynamicStats* stats);
+
+#endif // DYNAMIC_H
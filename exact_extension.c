@@ -3,6 +3,11 @@
 #include <string.h>
 #include "graph.h"
 #include "subiso.h"
+#include "gmext.h"
+#include "timing.h"
+#include "isocache.h"
+#include "stats.h"
+#include "trace.h"
 #include "exact_extension.h"
 
 
@@ -101,16 +106,47 @@ static void freeExtension(Extension* e) {
     free(e);
 }
 
+// State shared by one search. `deadline` is an absolute wallSeconds() value
+// (0 = no limit); once it passes, `timedOut` is set and every level of the
+// recursion unwinds without reporting a result. `cache`, when set, memoises
+// isomorphism verdicts across structurally identical H' graphs.
+typedef struct {
+    double deadline;
+    int timedOut;
+    IsoCache* cache;
+    long isoTests;
+} SearchControl;
+
+static int searchExpired(SearchControl* ctl) {
+    if (!ctl || ctl->deadline <= 0) return 0;
+    if (ctl->timedOut) return 1;
+    // Checked before every H' is built: a clock read is noise next to the
+    // clone and the isomorphism test, and the limit is overrun by one test.
+    if (wallSeconds() >= ctl->deadline) ctl->timedOut = 1;
+    return ctl->timedOut;
+}
+
 // Core try: build H' and test subgraph iso
 static Extension* tryExtension(const Graph* G, const Graph* H,
                                const int* newVertices, int kv,
-                               int (*edgeSet)[2], int ke) {
+                               int (*edgeSet)[2], int ke, SearchControl* ctl) {
     Graph* Hprime = cloneGraphWithExtraVertices(H, kv);
     if (!Hprime) return NULL;
 
     addEdgesToGraph(Hprime, edgeSet, ke);
 
-    bool iso = isSubgraphIsomorphic(G, Hprime);
+    bool iso;
+    uint64_t hash = 0;
+    STAT_INC(STAT_EXACT_TRIES);
+    if (ctl && ctl->cache && isoCacheLookup(ctl->cache, Hprime, &iso, &hash)) {
+        STAT_INC(STAT_EXACT_CACHE_HITS);
+    } else {
+        iso = isSubgraphIsomorphic(G, Hprime);
+        if (ctl) {
+            ctl->isoTests++;
+            if (ctl->cache) isoCacheInsert(ctl->cache, Hprime, hash, iso);
+        }
+    }
 
     Extension* ext = NULL;
     if (iso) {
@@ -142,9 +178,9 @@ static int generateAllPairs(const Graph* H, int* vertices, int total, int (*edge
 static void onEdgeCombination(int (*curr)[2], int k,
                               const Graph* G, const Graph* H,
                               int* newVertices, int kv,
-                              int* found, Extension** result) {
+                              int* found, Extension** result, SearchControl* ctl) {
     if (*found) return;
-    Extension* ext = tryExtension(G, H, newVertices, kv, curr, k);
+    Extension* ext = tryExtension(G, H, newVertices, kv, curr, k, ctl);
     if (ext) {
         *result = ext;
         *found = 1;
@@ -154,22 +190,25 @@ static void onEdgeCombination(int (*curr)[2], int k,
 static void combEdges(int (*edges)[2], int n, int k, int start, int depth,
                       int (*curr)[2], int* found,
                       const Graph* G, const Graph* H, int* newVertices, int kv,
-                      Extension** result) {
+                      Extension** result, SearchControl* ctl) {
     if (*found) return;
     if (depth == k) {
-        onEdgeCombination(curr, k, G, H, newVertices, kv, found, result);
+        if (searchExpired(ctl)) return;
+        onEdgeCombination(curr, k, G, H, newVertices, kv, found, result, ctl);
         return;
     }
     for (int i = start; i < n; i++) {
         curr[depth][0] = edges[i][0];
         curr[depth][1] = edges[i][1];
-        combEdges(edges, n, k, i + 1, depth + 1, curr, found, G, H, newVertices, kv, result);
+        combEdges(edges, n, k, i + 1, depth + 1, curr, found, G, H, newVertices, kv, result, ctl);
         if (*found) return;
+        if (ctl && ctl->timedOut) return;
     }
 }
 
 // Try a specific (kv, ke) combination
-static Extension* tryKVKE(const Graph* G, const Graph* H, int kv, int ke) {
+static Extension* tryKVKE(const Graph* G, const Graph* H, int kv, int ke,
+                          SearchControl* ctl) {
     int* newVertices = NULL;
     int* allVertices = NULL;
     int (*edges)[2] = NULL;
@@ -179,6 +218,10 @@ static Extension* tryKVKE(const Graph* G, const Graph* H, int kv, int ke) {
     if (ke > G->m) {
         return NULL;  // Can't possibly need more edges than G has
     }
+    if (H->m + ke < G->m) {
+        return NULL;  // H' would still have fewer edges than G
+    }
+    double traceStart = traceBegin();
 
     if (kv > 0) {
         newVertices = malloc(kv * sizeof(int));
@@ -194,42 +237,168 @@ static Extension* tryKVKE(const Graph* G, const Graph* H, int kv, int ke) {
     edges = malloc(maxEdges * sizeof(int[2]));
     int edgeCount = generateAllPairs(H, allVertices, totalV, edges);
 
+    long long triesBefore = STAT_GET(STAT_EXACT_TRIES);
+
     // Handle ke=0 case separately (no edges to add, just vertices)
     if (ke == 0) {
-        result = tryExtension(G, H, newVertices, kv, NULL, 0);
+        if (!searchExpired(ctl)) {
+            result = tryExtension(G, H, newVertices, kv, NULL, 0, ctl);
+        }
     } else if (ke <= edgeCount) {
         curr = malloc(ke * sizeof(int[2]));
         int found = 0;
-        combEdges(edges, edgeCount, ke, 0, 0, curr, &found, G, H, newVertices, kv, &result);
+        combEdges(edges, edgeCount, ke, 0, 0, curr, &found, G, H, newVertices, kv, &result, ctl);
     }
 
+    STAT_LEVEL(kv, ke, STAT_GET(STAT_EXACT_TRIES) - triesBefore);
+
     free(newVertices);
     free(allVertices);
     free(edges);
     free(curr);
 
+    traceEndArgs(traceStart, "exact split", "kv", kv, "ke", ke);
     return result;
 }
 
-// Public find
-Extension* findExtension(const Graph* G, const Graph* H, int maxSize) {
+static Extension* findExtensionControlled(const Graph* G, const Graph* H, int maxSize,
+                                          SearchControl* ctl) {
     int min_new_vertices = (G->n > H->n) ? (G->n - H->n) : 0;
 
     for (int kv = min_new_vertices; kv <= maxSize; kv++) {
         int ke = maxSize - kv;
-        Extension* ext = tryKVKE(G, H, kv, ke);
+        Extension* ext = tryKVKE(G, H, kv, ke, ctl);
         if (ext) return ext;
+        if (ctl && ctl->timedOut) return NULL;
     }
     return NULL;
 }
 
-Extension* exactMinimalExtension(const Graph* G, const Graph* H) {
+// Public find
+Extension* findExtension(const Graph* G, const Graph* H, int maxSize) {
+    return findExtensionControlled(G, H, maxSize, NULL);
+}
+
+// Cheapest cost any extension can have: H' needs at least |V(G)| vertices
+// and at least |E(G)| edges.
+static int trivialLowerBound(const Graph* G, const Graph* H) {
+    int kv = (G->n > H->n) ? (G->n - H->n) : 0;
+    int ke = (G->m > H->m) ? (G->m - H->m) : 0;
+    return kv + ke;
+}
+
+static void initSearchControl(SearchControl* ctl, const ExactOptions* opts) {
+    memset(ctl, 0, sizeof(*ctl));
+    if (opts && opts->isoCacheBytes > 0) ctl->cache = isoCacheCreate(opts->isoCacheBytes);
+}
+
+static void finishSearchControl(SearchControl* ctl, ExactSearchStats* stats) {
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+        stats->isoTests = ctl->isoTests;
+        isoCacheGetStats(ctl->cache, &stats->cache);
+    }
+    isoCacheFree(ctl->cache);
+    ctl->cache = NULL;
+}
+
+Extension* exactMinimalExtensionWithOptions(const Graph* G, const Graph* H,
+                                            const ExactOptions* opts,
+                                            ExactSearchStats* stats) {
+    SearchControl ctl;
+    initSearchControl(&ctl, opts);
+
+    Extension* ext = NULL;
     int maxSize = G->n + G->m;
-    for (int k = 0; k <= maxSize; k++) {
-        Extension* ext = findExtension(G, H, k);
-        if (ext) return ext;
+    for (int k = trivialLowerBound(G, H); k <= maxSize && !ext; k++) {
+        double traceStart = traceBegin();
+        ext = findExtensionControlled(G, H, k, &ctl);
+        traceEndArgs(traceStart, "exact level", "k", k, "found", ext != NULL);
     }
-    return NULL;
+
+    finishSearchControl(&ctl, stats);
+    return ext;
+}
+
+Extension* exactMinimalExtension(const Graph* G, const Graph* H) {
+    return exactMinimalExtensionWithOptions(G, H, NULL, NULL);
+}
+
+static Extension* extensionFromGreedy(const GreedyExtension* g) {
+    return buildExtension(g->newVertices, g->newVertexCount,
+                          g->newEdges, g->newEdgeCount);
+}
+
+static void reportProgress(const ExactOptions* opts, const char* event,
+                           int lowerBound, int upperBound, double start) {
+    if (opts && opts->progress) {
+        opts->progress(event, lowerBound, upperBound, wallSeconds() - start,
+                       opts->progressUser);
+    }
+}
+
+/**
+ * Anytime variant: the greedy mapping provides the first incumbent, then
+ * every cost level k is searched bottom-up. A level that is exhausted
+ * without a hit proves cost > k (the bound rises); a hit at level k is
+ * optimal because all cheaper levels were already refuted.
+ */
+ExactAnytimeResult* exactMinimalExtensionAnytime(const Graph* G, const Graph* H,
+                                                 const ExactOptions* opts) {
+    ExactAnytimeResult* res = calloc(1, sizeof(ExactAnytimeResult));
+    if (!res) return NULL;
+
+    double start = wallSeconds();
+    SearchControl ctl;
+    initSearchControl(&ctl, opts);
+    if (opts && opts->timeLimit > 0) ctl.deadline = start + opts->timeLimit;
+
+    res->lowerBound = trivialLowerBound(G, H);
+    res->upperBound = G->n + G->m;  // always feasible: add a disjoint copy of G
+
+    double traceStart = traceBegin();
+    GreedyExtension* seed = greedy_extension((Graph*)G, (Graph*)H);
+    if (seed) {
+        res->best = extensionFromGreedy(seed);
+        if (res->best) res->upperBound = seed->newVertexCount + seed->newEdgeCount;
+        freeGreedyExtension(seed);
+    }
+    reportProgress(opts, "incumbent", res->lowerBound, res->upperBound, start);
+    traceEndArgs(traceStart, "greedy incumbent", "cost", res->upperBound, NULL, 0);
+
+    int last = res->best ? res->upperBound - 1 : res->upperBound;
+    for (int k = res->lowerBound; k <= last; k++) {
+        traceStart = traceBegin();
+        Extension* ext = findExtensionControlled(G, H, k, &ctl);
+        traceEndArgs(traceStart, "exact level", "k", k, "found", ext != NULL);
+        if (ctl.timedOut) {
+            freeExtension(ext);
+            res->timedOut = 1;
+            break;
+        }
+        if (ext) {
+            freeExtension(res->best);
+            res->best = ext;
+            res->upperBound = k;
+            res->lowerBound = k;
+            reportProgress(opts, "incumbent", res->lowerBound, res->upperBound, start);
+            break;
+        }
+        res->lowerBound = k + 1;
+        reportProgress(opts, "bound", res->lowerBound, res->upperBound, start);
+    }
+
+    finishSearchControl(&ctl, &res->stats);
+    res->optimal = (res->best && res->lowerBound >= res->upperBound);
+    if (res->optimal) res->lowerBound = res->upperBound;
+    res->elapsed = wallSeconds() - start;
+    return res;
+}
+
+void freeExactAnytimeResult(ExactAnytimeResult* r) {
+    if (!r) return;
+    freeExtension(r->best);
+    free(r);
 }
 
 void freeExtensionObject(Extension* e) {
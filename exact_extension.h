@@ -2,6 +2,7 @@
 #define EXACT_EXTENSION_H
 
 #include "graph.h"
+#include "isocache.h"
 
 typedef struct {
     int* newVertices;
@@ -10,8 +11,59 @@ typedef struct {
     int newEdgeCount;
 } Extension;
 
+/**
+ * Options for the anytime exact search.
+ *
+ * timeLimit    - wall-clock budget in seconds (<= 0 means no limit)
+ * progress     - optional callback invoked whenever the incumbent or the
+ *                proven lower bound improves; `event` is "incumbent" or
+ *                "bound", `elapsed` is seconds since the search started
+ * progressUser - opaque pointer passed back to `progress`
+ * isoCacheBytes - memory cap for the subgraph-isomorphism verdict cache
+ *                (0 disables the cache)
+ */
+typedef struct {
+    double timeLimit;
+    void (*progress)(const char* event, int lowerBound, int upperBound,
+                     double elapsed, void* user);
+    void* progressUser;
+    size_t isoCacheBytes;
+} ExactOptions;
+
+/**
+ * Work done by one exact search: `isoTests` counts subgraph-isomorphism
+ * tests that actually ran, `cache` the verdict cache activity.
+ */
+typedef struct {
+    long isoTests;
+    IsoCacheStats cache;
+} ExactSearchStats;
+
+/**
+ * Result of the anytime exact search. `best` is the cheapest extension
+ * found (seeded by the greedy algorithm), `upperBound` its cost and
+ * `lowerBound` the cost below which no extension exists. The two are equal
+ * when `optimal` is set; otherwise their difference is the remaining gap.
+ */
+typedef struct {
+    Extension* best;
+    int lowerBound;
+    int upperBound;
+    int optimal;
+    int timedOut;
+    double elapsed;
+    ExactSearchStats stats;
+} ExactAnytimeResult;
+
 Extension* exactMinimalExtension(const Graph* G, const Graph* H);
+Extension* exactMinimalExtensionWithOptions(const Graph* G, const Graph* H,
+                                            const ExactOptions* opts,
+                                            ExactSearchStats* stats);
 Extension* findExtension(const Graph* G, const Graph* H, int maxSize);
 void freeExtensionObject(Extension* e);
 
+ExactAnytimeResult* exactMinimalExtensionAnytime(const Graph* G, const Graph* H,
+                                                 const ExactOptions* opts);
+void freeExactAnytimeResult(ExactAnytimeResult* r);
+
 #endif
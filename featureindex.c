@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <string.h>
+#include "featureindex.h"
+
+#define THRESHOLD_BITS 63   // thresholds 2^0 .. 2^62 cover any long long count
+
+static const char* FEATURE_NAMES[FEATURE_COUNT] = {
+    "vertices", "edges", "wedges", "paths3", "triangles", "stars3", "cycles4",
+    "degree>=2", "degree>=3", "degree>=4", "degree>=8", "degree>=16",
+};
+
+static const int SKETCH_DEGREES[] = { 2, 3, 4, 8, 16 };
+
+const char* featureName(FeatureKind f) {
+    return f >= 0 && f < FEATURE_COUNT ? FEATURE_NAMES[f] : "?";
+}
+
+int computeGraphFeatures(int n, const int* adjStart, const int* adj,
+                         const uint64_t* bits, int words, GraphFeatures* out) {
+    memset(out, 0, sizeof(*out));
+    long long* c = out->count;
+    c[FEATURE_VERTICES] = n;
+    c[FEATURE_EDGES] = adjStart[n] / 2;
+
+    long long closedWedges = 0;  // 3 x triangles
+    long long edgeProducts = 0;  // sum over edges of (d(u) - 1)(d(v) - 1)
+    for (int u = 0; u < n; u++) {
+        long long d = adjStart[u + 1] - adjStart[u];
+        c[FEATURE_WEDGES] += d * (d - 1) / 2;
+        c[FEATURE_STARS3] += d * (d - 1) * (d - 2) / 6;
+        for (int s = 0; s < (int)(sizeof(SKETCH_DEGREES) / sizeof(SKETCH_DEGREES[0])); s++) {
+            if (d >= SKETCH_DEGREES[s]) c[FEATURE_DEGREE_GE2 + s]++;
+        }
+
+        const uint64_t* ru = bits + (size_t)u * words;
+        for (int e = adjStart[u]; e < adjStart[u + 1]; e++) {
+            int v = adj[e];
+            if (v < u) continue;
+            const uint64_t* rv = bits + (size_t)v * words;
+            for (int w = 0; w < words; w++) closedWedges += __builtin_popcountll(ru[w] & rv[w]);
+            edgeProducts += (d - 1) * (adjStart[v + 1] - adjStart[v] - 1);
+        }
+    }
+    c[FEATURE_TRIANGLES] = closedWedges / 3;
+    c[FEATURE_PATHS3] = edgeProducts - 3 * c[FEATURE_TRIANGLES];
+
+    // 4-cycles: every pair {u, w} with k common neighbours closes C(k, 2)
+    // of them, and each cycle has two such diagonal pairs.
+    int* common = calloc(n > 0 ? n : 1, sizeof(int));
+    int* touched = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!common || !touched) {
+        free(common);
+        free(touched);
+        return -1;
+    }
+    long long diagonalPairs = 0;
+    for (int u = 0; u < n; u++) {
+        int t = 0;
+        for (int e = adjStart[u]; e < adjStart[u + 1]; e++) {
+            int v = adj[e];
+            for (int f = adjStart[v]; f < adjStart[v + 1]; f++) {
+                int w = adj[f];
+                if (w <= u) continue;
+                if (common[w]++ == 0) touched[t++] = w;
+            }
+        }
+        for (int i = 0; i < t; i++) {
+            long long k = common[touched[i]];
+            diagonalPairs += k * (k - 1) / 2;
+            common[touched[i]] = 0;
+        }
+    }
+    c[FEATURE_CYCLES4] = diagonalPairs / 2;
+
+    free(common);
+    free(touched);
+    return 0;
+}
+
+bool featuresDominate(const GraphFeatures* host, const GraphFeatures* pattern) {
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        if (host->count[f] < pattern->count[f]) return false;
+    }
+    return true;
+}
+
+// Index of the largest threshold 2^b <= count (count > 0)
+static int thresholdBit(long long count) {
+    return 63 - __builtin_clzll((unsigned long long)count);
+}
+
+struct FeatureIndex {
+    int hosts;
+    int words;                                      // allocated words per bitmap
+    uint64_t* bitmaps[FEATURE_COUNT][THRESHOLD_BITS]; // NULL until a host reaches it
+};
+
+FeatureIndex* featureIndexCreate(void) {
+    return calloc(1, sizeof(FeatureIndex));
+}
+
+void featureIndexFree(FeatureIndex* index) {
+    if (!index) return;
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        for (int b = 0; b < THRESHOLD_BITS; b++) free(index->bitmaps[f][b]);
+    }
+    free(index);
+}
+
+int featureIndexAdd(FeatureIndex* index, const GraphFeatures* host) {
+    int id = index->hosts;
+    if (id / 64 >= index->words) {
+        int words = index->words ? 2 * index->words : 4;
+        for (int f = 0; f < FEATURE_COUNT; f++) {
+            for (int b = 0; b < THRESHOLD_BITS; b++) {
+                if (!index->bitmaps[f][b]) continue;
+                uint64_t* grown = realloc(index->bitmaps[f][b], words * sizeof(uint64_t));
+                if (!grown) return -1;
+                memset(grown + index->words, 0, (words - index->words) * sizeof(uint64_t));
+                index->bitmaps[f][b] = grown;
+            }
+        }
+        index->words = words;
+    }
+
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        if (host->count[f] <= 0) continue;
+        int top = thresholdBit(host->count[f]);
+        for (int b = 0; b <= top; b++) {
+            if (!index->bitmaps[f][b]) {
+                index->bitmaps[f][b] = calloc(index->words, sizeof(uint64_t));
+                if (!index->bitmaps[f][b]) return -1;
+            }
+            index->bitmaps[f][b][id >> 6] |= 1ULL << (id & 63);
+        }
+    }
+    index->hosts++;
+    return 0;
+}
+
+int featureIndexCandidates(const FeatureIndex* index, const GraphFeatures* pattern, int* out) {
+    const uint64_t* required[FEATURE_COUNT];
+    int r = 0;
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        if (pattern->count[f] <= 0) continue;
+        const uint64_t* bitmap = index->bitmaps[f][thresholdBit(pattern->count[f])];
+        if (!bitmap) return 0;  // no host reaches this threshold
+        required[r++] = bitmap;
+    }
+
+    int count = 0;
+    int words = (index->hosts + 63) / 64;
+    for (int w = 0; w < words; w++) {
+        uint64_t x = w == words - 1 && index->hosts % 64 ? (1ULL << (index->hosts % 64)) - 1 : ~0ULL;
+        for (int i = 0; i < r && x; i++) x &= required[i][w];
+        while (x) {
+            out[count++] = w * 64 + __builtin_ctzll(x);
+            x &= x - 1;
+        }
+    }
+    return count;
+}
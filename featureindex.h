@@ -0,0 +1,73 @@
+#ifndef FEATUREINDEX_H
+#define FEATUREINDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * =============================================================================
+ * SUBGRAPH FEATURE FILTER
+ * =============================================================================
+ * Counts of small subgraphs that can only grow along an embedding: if G is
+ * a subgraph of H, every copy of a fixed small graph F in G maps to a
+ * distinct copy of F in H, so count_F(G) <= count_F(H). The counted shapes
+ * are edges, paths of two and three edges, triangles, 3-stars and 4-cycles,
+ * plus a degree sketch (vertices of degree >= d for a few thresholds d).
+ * A host whose counts do not all dominate G's cannot contain G.
+ *
+ * A FeatureIndex keeps, for every feature and power-of-two threshold 2^b,
+ * a bitmap of the hosts whose count reaches it. A query ANDs one bitmap per
+ * feature of G (the largest threshold G reaches), which leaves a superset
+ * of the hosts whose counts dominate G's without touching the others.
+ * =============================================================================
+ */
+
+typedef enum {
+    FEATURE_VERTICES,
+    FEATURE_EDGES,
+    FEATURE_WEDGES,       // paths with 2 edges
+    FEATURE_PATHS3,       // paths with 3 edges
+    FEATURE_TRIANGLES,
+    FEATURE_STARS3,       // a vertex with 3 neighbours
+    FEATURE_CYCLES4,
+    FEATURE_DEGREE_GE2,   // degree sketch: vertices of degree >= 2, 3, 4, 8, 16
+    FEATURE_DEGREE_GE3,
+    FEATURE_DEGREE_GE4,
+    FEATURE_DEGREE_GE8,
+    FEATURE_DEGREE_GE16,
+    FEATURE_COUNT
+} FeatureKind;
+
+typedef struct {
+    long long count[FEATURE_COUNT];
+} GraphFeatures;
+
+/**
+ * Computes the features of a graph given as CSR adjacency lists and packed
+ * adjacency bitsets (`words` 64-bit words per vertex). O(n + sum of deg^2
+ * + m * n / 64) time.
+ */
+int computeGraphFeatures(int n, const int* adjStart, const int* adj,
+                         const uint64_t* bits, int words, GraphFeatures* out);
+
+/** True if every count of `host` is at least the matching count of `pattern`. */
+bool featuresDominate(const GraphFeatures* host, const GraphFeatures* pattern);
+
+const char* featureName(FeatureKind f);
+
+typedef struct FeatureIndex FeatureIndex;
+
+FeatureIndex* featureIndexCreate(void);
+void featureIndexFree(FeatureIndex* index);
+
+/** Adds the next host (ids are assigned 0, 1, 2, ...). Returns 0 or -1. */
+int featureIndexAdd(FeatureIndex* index, const GraphFeatures* host);
+
+/**
+ * Writes to `out` the ids, ascending, of the hosts that pass every
+ * threshold bitmap of `pattern`, and returns how many there are. `out`
+ * must have room for all hosts of the index.
+ */
+int featureIndexCandidates(const FeatureIndex* index, const GraphFeatures* pattern, int* out);
+
+#endif // FEATUREINDEX_H
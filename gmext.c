@@ -1,10 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <math.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "graph.h"
+#include "timing.h"
+#include "assignment.h"
+#include "trace.h"
 #include "gmext.h"
 
+#define GREEDY_MAX_RCL 16
+#define GREEDY_DEFAULT_RCL 3
+
 // Helper struct for sorting
 typedef struct {
     int id;
@@ -18,86 +28,228 @@ static int compareVertices(const void* a, const void* b) {
     return vb->degree - va->degree;
 }
 
-// Count how many edges would be preserved if we map v_g to v_h
-static int countPreservedEdges(int v_g, int v_h, Graph* G, Graph* H, int* mapping) {
-    int preserved = 0;
-    
-    for (int i = 0; i < G->adjSize[v_g]; i++) {
-        int neighbor_g = G->adj[v_g][i];
-        
-        if (mapping[neighbor_g] != -1) {
-            int mapped_neighbor = mapping[neighbor_g];
-            
-            // Check if edge exists in H
-            if (mapped_neighbor < H->n && v_h < H->n) {
-                if (H->matrix[v_h][mapped_neighbor]) {
-                    preserved++;
-                }
-            }
-        }
+/**
+ * Per-ordering scratch state for tryMapping. Instead of rescanning adjacency
+ * lists for every (v_g, v_h) pair, the score inputs are kept as counters and
+ * updated only around each newly mapped pair:
+ *
+ *   avail_H[h]    - unused neighbours of H vertex h
+ *   unmapped_G[g] - unmapped neighbours of G vertex g
+ *   preserved[h]  - for the vertex being placed: mapped G neighbours whose
+ *                   image is adjacent to h (filled per step, reset via touched)
+ *
+ * Unused H vertices are indexed in buckets by degree (intrusive doubly
+ * linked lists in ascending id order), so the best candidate without
+ * preserved edges is found by walking buckets from the highest degree down
+ * and stopping as soon as no remaining bucket can beat the current best.
+ * Ties are broken towards the lowest H id, as in a plain scan of H.
+ */
+typedef struct {
+    int* mapping;
+    int* used_H;
+    int* avail_H;
+    int* unmapped_G;
+    int* preserved;
+    int* touched;
+    int* bucket_head;   // first unused H vertex of each degree, -1 if none
+    int* next;
+    int* prev;
+    int max_deg_H;
+    int unused_H;               // unused H vertices left in the buckets
+    GreedyCandidateMode mode;
+    long candidates_scored;     // candidates actually evaluated
+    long full_scan_candidates;  // candidates a scan of all unused H would evaluate
+    int rcl_size;               // restricted candidate list length (1 = pure greedy)
+    int rcl_len;
+    int rcl_id[GREEDY_MAX_RCL];
+    int rcl_score[GREEDY_MAX_RCL];
+} GreedyScratch;
+
+static int greedyScratchInit(GreedyScratch* s, Graph* G, Graph* H, GreedyCandidateMode mode) {
+    memset(s, 0, sizeof(*s));
+    s->mode = mode;
+    s->rcl_size = 1;
+    s->max_deg_H = 0;
+    for (int v = 0; v < H->n; v++) {
+        if (H->adjSize[v] > s->max_deg_H) s->max_deg_H = H->adjSize[v];
     }
-    return preserved;
+    int nG = G->n > 0 ? G->n : 1;
+    int nH = H->n > 0 ? H->n : 1;
+    s->mapping = malloc(nG * sizeof(int));
+    s->unmapped_G = malloc(nG * sizeof(int));
+    s->used_H = malloc(nH * sizeof(int));
+    s->avail_H = malloc(nH * sizeof(int));
+    s->preserved = calloc(nH, sizeof(int));
+    s->touched = malloc(nH * sizeof(int));
+    s->next = malloc(nH * sizeof(int));
+    s->prev = malloc(nH * sizeof(int));
+    s->bucket_head = malloc((s->max_deg_H + 1) * sizeof(int));
+    return (s->mapping && s->unmapped_G && s->used_H && s->avail_H && s->preserved &&
+            s->touched && s->next && s->prev && s->bucket_head) ? 0 : -1;
 }
 
-// Count how many potential edges could be preserved (for unmapped neighbors)
-static int countPotentialEdges(int v_g, int v_h, Graph* G, Graph* H, int* mapping, int* used_H) {
-    int potential = 0;
-    
-    for (int i = 0; i < G->adjSize[v_g]; i++) {
-        int neighbor_g = G->adj[v_g][i];
-        
-        if (mapping[neighbor_g] == -1) {
-            // Unmapped neighbor - check if v_h has available neighbors
-            for (int j = 0; j < H->adjSize[v_h]; j++) {
-                int h_neighbor = H->adj[v_h][j];
-                if (!used_H[h_neighbor]) {
-                    potential++;
-                    break; // Count each G neighbor only once
-                }
-            }
-        }
+static void greedyScratchFree(GreedyScratch* s) {
+    free(s->mapping);
+    free(s->unmapped_G);
+    free(s->used_H);
+    free(s->avail_H);
+    free(s->preserved);
+    free(s->touched);
+    free(s->next);
+    free(s->prev);
+    free(s->bucket_head);
+}
+
+// Reset counters and rebuild the degree buckets for a fresh ordering.
+static void greedyScratchReset(GreedyScratch* s, Graph* G, Graph* H) {
+    for (int i = 0; i < G->n; i++) {
+        s->mapping[i] = -1;
+        s->unmapped_G[i] = G->adjSize[i];
+    }
+    for (int d = 0; d <= s->max_deg_H; d++) s->bucket_head[d] = -1;
+    s->unused_H = H->n;
+    for (int v = H->n - 1; v >= 0; v--) {
+        int d = H->adjSize[v];
+        s->used_H[v] = 0;
+        s->avail_H[v] = d;
+        s->prev[v] = -1;
+        s->next[v] = s->bucket_head[d];
+        if (s->bucket_head[d] != -1) s->prev[s->bucket_head[d]] = v;
+        s->bucket_head[d] = v;
     }
-    return potential;
 }
 
-// Improved scoring function
-static int compute_improved_score(int v_g, int v_h, Graph* G, Graph* H, int* mapping, int* used_H) {
+// Record v_g -> v_h and update the counters of the touched neighbourhoods.
+static void greedyScratchAssign(GreedyScratch* s, Graph* G, Graph* H, int v_g, int v_h) {
+    s->mapping[v_g] = v_h;
+    for (int i = 0; i < G->adjSize[v_g]; i++) s->unmapped_G[G->adj[v_g][i]]--;
+    if (v_h >= H->n) return;
+
+    s->used_H[v_h] = 1;
+    s->unused_H--;
+    for (int i = 0; i < H->adjSize[v_h]; i++) s->avail_H[H->adj[v_h][i]]--;
+
+    int d = H->adjSize[v_h];
+    if (s->prev[v_h] != -1) s->next[s->prev[v_h]] = s->next[v_h];
+    else s->bucket_head[d] = s->next[v_h];
+    if (s->next[v_h] != -1) s->prev[s->next[v_h]] = s->prev[v_h];
+}
+
+// Term 3 of the score: degree compatibility.
+static int degreeScore(int deg_g, int deg_h) {
+    if (deg_h >= deg_g) return 10;   // Good: H vertex can accommodate all edges
+    return -(deg_g - deg_h) * 5;     // Penalty for degree deficit
+}
+
+// Term 2 + 4 of the score: potential for future edge preservation and
+// neighbourhood size matching. Never exceeds 20 * unmapped + 15.
+static int neighbourhoodScore(int unmapped, int avail) {
     int score = 0;
-    
-    // 1. Preserved edges (most important - each saves an edge addition)
-    int preserved = countPreservedEdges(v_g, v_h, G, H, mapping);
-    score += preserved * 100;
-    
-    // 2. Potential for future edge preservation
-    int potential = countPotentialEdges(v_g, v_h, G, H, mapping, used_H);
-    score += potential * 20;
-    
-    // 3. Degree compatibility (prefer H vertices with similar or higher degree)
-    int deg_g = G->adjSize[v_g];
-    int deg_h = H->adjSize[v_h];
-    
-    if (deg_h >= deg_g) {
-        score += 10; // Good: H vertex can accommodate all edges
+    if (avail > 0) score += unmapped * 20;
+    if (avail >= unmapped) score += 15;
+    return score;
+}
+
+// Improved scoring function, evaluated from the maintained counters:
+//   1. preserved edges (most important - each saves an edge addition)
+//   2. potential for future edge preservation
+//   3. degree compatibility
+//   4. neighbour count matching
+static int scoreCandidate(const GreedyScratch* s, Graph* G, Graph* H, int v_g, int v_h) {
+    return s->preserved[v_h] * 100
+         + neighbourhoodScore(s->unmapped_G[v_g], s->avail_H[v_h])
+         + degreeScore(G->adjSize[v_g], H->adjSize[v_h]);
+}
+
+// Candidate ranking: higher score first, lower H id on ties.
+static int ranksBefore(int score_a, int id_a, int score_b, int id_b) {
+    return score_a > score_b || (score_a == score_b && id_a < id_b);
+}
+
+// Insert a candidate into the restricted candidate list (kept sorted).
+static void offerCandidate(GreedyScratch* s, int v_h, int score) {
+    int k = s->rcl_len;
+    if (k == s->rcl_size) {
+        if (!ranksBefore(score, v_h, s->rcl_score[k - 1], s->rcl_id[k - 1])) return;
+        k--;
     } else {
-        score -= (deg_g - deg_h) * 5; // Penalty for degree deficit
+        s->rcl_len++;
     }
-    
-    // 4. Neighbor degree matching (prefer similar neighborhood structure)
-    int unmapped_g_neighbors = 0;
-    int available_h_neighbors = 0;
-    
+    while (k > 0 && ranksBefore(score, v_h, s->rcl_score[k - 1], s->rcl_id[k - 1])) {
+        s->rcl_score[k] = s->rcl_score[k - 1];
+        s->rcl_id[k] = s->rcl_id[k - 1];
+        k--;
+    }
+    s->rcl_score[k] = score;
+    s->rcl_id[k] = v_h;
+}
+
+// splitmix64: small, fast and good enough to drive randomized restarts.
+static uint64_t rngNext(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static int rngBelow(uint64_t* state, int n) {
+    return (int)(rngNext(state) % (uint64_t)n);
+}
+
+// Pick an unused H vertex for v_g, or -1 if H is exhausted. The best
+// `rcl_size` candidates are collected; without `rng` the best one is taken,
+// otherwise one of them uniformly at random (GRASP-style restarts).
+//
+// Candidates that preserve edges are exactly the unused neighbours of
+// images of v_g's mapped neighbours (the frontier); they are scored
+// explicitly. Every other candidate is bounded by its degree bucket.
+// In GREEDY_CANDIDATES_FRONTIER mode a non-empty frontier ends the search,
+// so the buckets are only consulted for disconnected picks.
+static int selectCandidate(GreedyScratch* s, Graph* G, Graph* H, int v_g, uint64_t* rng) {
+    int touched = 0;
     for (int i = 0; i < G->adjSize[v_g]; i++) {
-        if (mapping[G->adj[v_g][i]] == -1) unmapped_g_neighbors++;
+        int img = s->mapping[G->adj[v_g][i]];
+        if (img < 0 || img >= H->n) continue;
+        for (int j = 0; j < H->adjSize[img]; j++) {
+            int x = H->adj[img][j];
+            if (s->used_H[x]) continue;
+            if (s->preserved[x]++ == 0) s->touched[touched++] = x;
+        }
     }
-    for (int i = 0; i < H->adjSize[v_h]; i++) {
-        if (!used_H[H->adj[v_h][i]]) available_h_neighbors++;
+
+    s->rcl_len = 0;
+    for (int i = 0; i < touched; i++) {
+        int v_h = s->touched[i];
+        offerCandidate(s, v_h, scoreCandidate(s, G, H, v_g, v_h));
     }
-    
-    if (available_h_neighbors >= unmapped_g_neighbors) {
-        score += 15;
+    s->candidates_scored += touched;
+    s->full_scan_candidates += s->unused_H;
+
+    if (!(s->mode == GREEDY_CANDIDATES_FRONTIER && touched > 0)) {
+        int deg_g = G->adjSize[v_g];
+        int unmapped = s->unmapped_G[v_g];
+        int max_nb = neighbourhoodScore(unmapped, unmapped > 0 ? unmapped : 1);
+        for (int d = s->max_deg_H; d >= 0; d--) {
+            int bound = degreeScore(deg_g, d) + max_nb;
+            int full = (s->rcl_len == s->rcl_size);
+            if (full && bound < s->rcl_score[s->rcl_len - 1]) break;
+            // Ties go to the lowest id, so a bucket that can at most tie is
+            // only walked (in ascending id order) up to the worst kept id.
+            for (int v_h = s->bucket_head[d]; v_h != -1; v_h = s->next[v_h]) {
+                if (s->rcl_len == s->rcl_size &&
+                    bound == s->rcl_score[s->rcl_len - 1] &&
+                    v_h > s->rcl_id[s->rcl_len - 1]) break;
+                if (s->preserved[v_h]) continue;
+                offerCandidate(s, v_h, scoreCandidate(s, G, H, v_g, v_h));
+                s->candidates_scored++;
+            }
+        }
     }
-    
-    return score;
+
+    for (int i = 0; i < touched; i++) s->preserved[s->touched[i]] = 0;
+    if (s->rcl_len == 0) return -1;
+    if (!rng || s->rcl_len == 1) return s->rcl_id[0];
+    return s->rcl_id[rngBelow(rng, s->rcl_len)];
 }
 
 // Calculate total cost for a given mapping
@@ -124,13 +276,11 @@ static int calculateMappingCost(Graph* G, Graph* H, int* mapping, int added_vert
     return added_vertices + missing_edges;
 }
 
-// Try multiple starting orderings and keep the best result
-static void tryMapping(Graph* G, Graph* H, VertexInfo* order, int* best_mapping, 
-                       int* best_cost, int* best_added_vertices) {
-    int* mapping = malloc(G->n * sizeof(int));
-    int* used_H = calloc(H->n, sizeof(int));
-    
-    for (int i = 0; i < G->n; i++) mapping[i] = -1;
+// Map G in the given order and keep the result if it beats the best so far.
+// Returns 1 when the best was replaced.
+static int tryMapping(Graph* G, Graph* H, VertexInfo* order, GreedyScratch* s, uint64_t* rng,
+                      int* best_mapping, int* best_cost, int* best_added_vertices) {
+    greedyScratchReset(s, G, H);
     
     int added_vertices = 0;
     
@@ -138,58 +288,635 @@ static void tryMapping(Graph* G, Graph* H, VertexInfo* order, int* best_mapping,
     for (int i = 0; i < G->n; i++) {
         int v_g = order[i].id;
         
-        int best_v_h = -1;
-        int best_score = INT_MIN;
-        
-        for (int v_h = 0; v_h < H->n; v_h++) {
-            if (used_H[v_h]) continue;
-            
-            int score = compute_improved_score(v_g, v_h, G, H, mapping, used_H);
-            
-            if (score > best_score) {
-                best_score = score;
-                best_v_h = v_h;
-            }
-        }
+        int best_v_h = selectCandidate(s, G, H, v_g, rng);
         
         if (best_v_h != -1) {
-            mapping[v_g] = best_v_h;
-            used_H[best_v_h] = 1;
+            greedyScratchAssign(s, G, H, v_g, best_v_h);
         } else {
-            mapping[v_g] = H->n + added_vertices;
+            greedyScratchAssign(s, G, H, v_g, H->n + added_vertices);
             added_vertices++;
         }
     }
     
-    int cost = calculateMappingCost(G, H, mapping, added_vertices);
+    int cost = calculateMappingCost(G, H, s->mapping, added_vertices);
     
     if (cost < *best_cost) {
         *best_cost = cost;
         *best_added_vertices = added_vertices;
-        memcpy(best_mapping, mapping, G->n * sizeof(int));
+        memcpy(best_mapping, s->mapping, G->n * sizeof(int));
+        return 1;
     }
-    
-    free(mapping);
-    free(used_H);
+    return 0;
+}
+
+// Randomized BFS ordering: components are started from vertices in random
+// order and each vertex's neighbours are enqueued in a random order.
+static void randomOrder(Graph* G, uint64_t* rng, VertexInfo* order,
+                        int* visited, int* queue, int* perm) {
+    memset(visited, 0, G->n * sizeof(int));
+    for (int i = 0; i < G->n; i++) perm[i] = i;
+    for (int i = G->n - 1; i > 0; i--) {
+        int j = rngBelow(rng, i + 1);
+        int t = perm[i]; perm[i] = perm[j]; perm[j] = t;
+    }
+
+    int order_idx = 0;
+    for (int p = 0; p < G->n; p++) {
+        if (visited[perm[p]]) continue;
+        int front = 0, back = 0;
+        queue[back++] = perm[p];
+        visited[perm[p]] = 1;
+        while (front < back) {
+            int v = queue[front++];
+            order[order_idx].id = v;
+            order[order_idx].degree = G->adjSize[v];
+            order_idx++;
+
+            int first = back;
+            for (int i = 0; i < G->adjSize[v]; i++) {
+                int nb = G->adj[v][i];
+                if (!visited[nb]) {
+                    queue[back++] = nb;
+                    visited[nb] = 1;
+                }
+            }
+            for (int i = back - 1; i > first; i--) {
+                int j = first + rngBelow(rng, i - first + 1);
+                int t = queue[i]; queue[i] = queue[j]; queue[j] = t;
+            }
+        }
+    }
+}
+
+/**
+ * =============================================================================
+ * RANDOMIZED MULTI-START (GRASP)
+ * =============================================================================
+ * Restart i maps G along a randomized BFS ordering, picking each image from
+ * the restricted candidate list, with a PRNG seeded from (seed, i) alone.
+ * Restart indices are handed out from a shared counter; every worker owns
+ * its scratch buffers and keeps its own best. The final reduction compares
+ * (cost, restart index), so for a fixed restart count the result does not
+ * depend on the number of threads or on scheduling. A time budget stops
+ * handing out new restarts once it expires.
+ * =============================================================================
+ */
+typedef struct {
+    Graph* G;
+    Graph* H;
+    GreedyCandidateMode mode;
+    int rcl_size;
+    uint64_t seed;
+    long max_restarts;      // < 0: until the deadline
+    double deadline;        // 0: none
+    atomic_long next_restart;
+} RestartShared;
+
+typedef struct {
+    RestartShared* shared;
+    int* best_mapping;
+    int best_cost;
+    int best_added_vertices;
+    long best_restart;
+    long runs;
+    long candidates_scored;
+    long full_scan_candidates;
+    int spawned;            // runs on a thread of its own
+} RestartWorker;
+
+static void* restartWorker(void* arg) {
+    RestartWorker* w = arg;
+    RestartShared* sh = w->shared;
+    Graph* G = sh->G;
+    Graph* H = sh->H;
+
+    GreedyScratch scratch;
+    VertexInfo* order = malloc((G->n > 0 ? G->n : 1) * sizeof(VertexInfo));
+    int* visited = malloc((G->n > 0 ? G->n : 1) * sizeof(int));
+    int* queue = malloc((G->n > 0 ? G->n : 1) * sizeof(int));
+    int* perm = malloc((G->n > 0 ? G->n : 1) * sizeof(int));
+    if (w->spawned) traceThreadName("greedy restarts");
+    double traceTask = traceBegin();
+    if (greedyScratchInit(&scratch, G, H, sh->mode) == 0 && order && visited && queue && perm) {
+        scratch.rcl_size = sh->rcl_size;
+        for (;;) {
+            if (sh->deadline > 0 && wallSeconds() >= sh->deadline) break;
+            long idx = atomic_fetch_add(&sh->next_restart, 1);
+            if (sh->max_restarts >= 0 && idx >= sh->max_restarts) break;
+
+            double traceStart = traceBegin();
+            uint64_t rng = sh->seed ^ ((uint64_t)(idx + 1) * 0xd1b54a32d192ed03ULL);
+            rngNext(&rng);
+            randomOrder(G, &rng, order, visited, queue, perm);
+            // Indices grow within a worker, so a strict improvement keeps
+            // the lowest restart index among equal costs.
+            if (tryMapping(G, H, order, &scratch, &rng, w->best_mapping,
+                           &w->best_cost, &w->best_added_vertices)) {
+                w->best_restart = idx;
+            }
+            w->runs++;
+            traceEndArgs(traceStart, "greedy restart", "restart", idx, "best", w->best_cost);
+        }
+    }
+    traceEndArgs(traceTask, "restart worker", "runs", w->runs, NULL, 0);
+    w->candidates_scored = scratch.candidates_scored;
+    w->full_scan_candidates = scratch.full_scan_candidates;
+    greedyScratchFree(&scratch);
+    free(order);
+    free(visited);
+    free(queue);
+    free(perm);
+    return NULL;
+}
+
+// Run the configured restarts and fold the best into best_mapping.
+static void runRestarts(Graph* G, Graph* H, const GreedyOptions* opts, GreedyCandidateMode mode,
+                        int* best_mapping, int* best_cost, int* best_added_vertices,
+                        long* restarts_run, long* scored, long* full_scan) {
+    RestartShared sh;
+    sh.G = G;
+    sh.H = H;
+    sh.mode = mode;
+    sh.rcl_size = opts->rclSize > 0 ? opts->rclSize : GREEDY_DEFAULT_RCL;
+    if (sh.rcl_size > GREEDY_MAX_RCL) sh.rcl_size = GREEDY_MAX_RCL;
+    sh.seed = opts->seed;
+    sh.max_restarts = opts->restarts > 0 ? opts->restarts : -1;
+    sh.deadline = opts->timeBudget > 0 ? wallSeconds() + opts->timeBudget : 0;
+    atomic_init(&sh.next_restart, 0);
+
+    int threads = opts->threads > 1 ? opts->threads : 1;
+    RestartWorker* workers = calloc(threads, sizeof(RestartWorker));
+    pthread_t* tids = calloc(threads, sizeof(pthread_t));
+    if (!workers || !tids) {
+        free(workers);
+        free(tids);
+        return;
+    }
+
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].shared = &sh;
+        workers[t].best_cost = INT_MAX;
+        workers[t].best_restart = -1;
+        workers[t].spawned = t > 0;
+        workers[t].best_mapping = malloc((G->n > 0 ? G->n : 1) * sizeof(int));
+        if (!workers[t].best_mapping) break;
+        if (t > 0 && pthread_create(&tids[t], NULL, restartWorker, &workers[t]) != 0) {
+            free(workers[t].best_mapping);
+            workers[t].best_mapping = NULL;
+            break;
+        }
+        started++;
+    }
+    if (started > 0) restartWorker(&workers[0]);
+    for (int t = 1; t < started; t++) pthread_join(tids[t], NULL);
+
+    RestartWorker* winner = NULL;
+    for (int t = 0; t < started; t++) {
+        RestartWorker* w = &workers[t];
+        *restarts_run += w->runs;
+        *scored += w->candidates_scored;
+        *full_scan += w->full_scan_candidates;
+        if (w->best_restart < 0) continue;
+        if (!winner || w->best_cost < winner->best_cost ||
+            (w->best_cost == winner->best_cost && w->best_restart < winner->best_restart)) {
+            winner = w;
+        }
+    }
+    // The fixed strategies ran first, so they win ties against restarts.
+    if (winner && winner->best_cost < *best_cost) {
+        *best_cost = winner->best_cost;
+        *best_added_vertices = winner->best_added_vertices;
+        memcpy(best_mapping, winner->best_mapping, G->n * sizeof(int));
+    }
+
+    for (int t = 0; t < threads; t++) free(workers[t].best_mapping);
+    free(workers);
+    free(tids);
+}
+
+/**
+ * =============================================================================
+ * LOCAL SEARCH REFINEMENT
+ * =============================================================================
+ * Simulated annealing over complete mappings with two move types:
+ *
+ *   relocate - move one G vertex to an unused H vertex (this also retires
+ *              an added vertex when the G vertex sat on one)
+ *   swap     - exchange the images of two G vertices
+ *
+ * The cost is the one of calculateMappingCost (added vertices + missing
+ * edges). A move only changes the status of edges incident to the moved G
+ * vertices, so its delta is evaluated in O(deg) from the adjacency matrix.
+ * Images >= H->n are added vertices with no edges; they are renumbered
+ * consecutively once the search ends.
+ * =============================================================================
+ */
+#define LS_DEFAULT_ITERATIONS_PER_VERTEX 200
+#define LS_START_TEMPERATURE 2.0
+#define LS_END_TEMPERATURE 0.05
+
+static int hostEdge(Graph* H, int a, int b) {
+    return a < H->n && b < H->n && H->matrix[a][b];
+}
+
+// Change in missing edges when g's image moves from `from` to `to`.
+// `skip` names a G neighbour whose edge to g is ignored (used by swaps).
+static int relocateDelta(Graph* G, Graph* H, const int* mapping, int g, int from, int to, int skip) {
+    int delta = 0;
+    for (int i = 0; i < G->adjSize[g]; i++) {
+        int u = G->adj[g][i];
+        if (u == skip) continue;
+        delta += !hostEdge(H, to, mapping[u]) - !hostEdge(H, from, mapping[u]);
+    }
+    return delta;
+}
+
+static void refineMapping(Graph* G, Graph* H, int* mapping, int* added_vertices,
+                          const GreedyOptions* opts, long* moves_accepted) {
+    if (G->n == 0) return;
+
+    int* unused = malloc((H->n > 0 ? H->n : 1) * sizeof(int));   // unused H vertices
+    int* pos = malloc((H->n > 0 ? H->n : 1) * sizeof(int));      // index in unused, -1 if used
+    int* best = malloc(G->n * sizeof(int));
+    if (!unused || !pos || !best) {
+        free(unused); free(pos); free(best);
+        return;
+    }
+
+    for (int h = 0; h < H->n; h++) pos[h] = 0;
+    for (int g = 0; g < G->n; g++) if (mapping[g] < H->n) pos[mapping[g]] = -1;
+    int unused_count = 0;
+    for (int h = 0; h < H->n; h++) {
+        if (pos[h] == 0) {
+            pos[h] = unused_count;
+            unused[unused_count++] = h;
+        }
+    }
+
+    int cost = calculateMappingCost(G, H, mapping, *added_vertices);
+    int added = *added_vertices;
+    int best_cost = cost;
+    memcpy(best, mapping, G->n * sizeof(int));
+
+    long iterations = opts->lsIterations > 0 ? opts->lsIterations
+                                             : (long)LS_DEFAULT_ITERATIONS_PER_VERTEX * G->n;
+    double deadline = opts->lsTimeBudget > 0 ? wallSeconds() + opts->lsTimeBudget : 0;
+    double cooling = pow(LS_END_TEMPERATURE / LS_START_TEMPERATURE, 1.0 / (double)iterations);
+    double temperature = LS_START_TEMPERATURE;
+    uint64_t rng = opts->seed ^ 0x6c5f4c4f43414cULL;
+
+    for (long it = 0; it < iterations && best_cost > 0; it++, temperature *= cooling) {
+        if (deadline > 0 && (it & 255) == 0 && wallSeconds() >= deadline) break;
+
+        int g1 = rngBelow(&rng, G->n);
+        int relocate = unused_count > 0 && (G->n < 2 || (rngNext(&rng) & 1));
+        int g2 = -1, to = -1, delta;
+
+        if (relocate) {
+            // Half of the relocations target an unused H neighbour of the
+            // image of one of g1's neighbours, the only places where an edge
+            // can be gained; the rest sample all unused H vertices.
+            to = -1;
+            if (G->adjSize[g1] > 0 && (rngNext(&rng) & 1)) {
+                int img = mapping[G->adj[g1][rngBelow(&rng, G->adjSize[g1])]];
+                if (img < H->n && H->adjSize[img] > 0) {
+                    int x = H->adj[img][rngBelow(&rng, H->adjSize[img])];
+                    if (pos[x] >= 0) to = x;
+                }
+            }
+            if (to < 0) to = unused[rngBelow(&rng, unused_count)];
+            delta = relocateDelta(G, H, mapping, g1, mapping[g1], to, -1);
+            if (mapping[g1] >= H->n) delta -= 1;
+        } else {
+            if (G->n < 2) break;
+            g2 = rngBelow(&rng, G->n - 1);
+            if (g2 >= g1) g2++;
+            // The g1-g2 edge (if any) keeps its status under a swap.
+            delta = relocateDelta(G, H, mapping, g1, mapping[g1], mapping[g2], g2)
+                  + relocateDelta(G, H, mapping, g2, mapping[g2], mapping[g1], g1);
+        }
+
+        if (delta > 0 && (double)(rngNext(&rng) >> 11) / 9007199254740992.0 >= exp(-delta / temperature)) {
+            continue;
+        }
+
+        if (relocate) {
+            int from = mapping[g1];
+            int slot = pos[to];
+            if (from < H->n) {
+                unused[slot] = from;
+                pos[from] = slot;
+            } else {
+                unused[slot] = unused[--unused_count];
+                pos[unused[slot]] = slot;
+                added--;
+            }
+            pos[to] = -1;
+            mapping[g1] = to;
+        } else {
+            int t = mapping[g1];
+            mapping[g1] = mapping[g2];
+            mapping[g2] = t;
+        }
+        cost += delta;
+        (*moves_accepted)++;
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            memcpy(best, mapping, G->n * sizeof(int));
+        }
+    }
+
+    // Renumber added vertices consecutively after H's own vertices.
+    added = 0;
+    for (int g = 0; g < G->n; g++) {
+        mapping[g] = best[g] < H->n ? best[g] : H->n + added++;
+    }
+    *added_vertices = added;
+
+    free(unused);
+    free(pos);
+    free(best);
+}
+
+/**
+ * =============================================================================
+ * ASSIGNMENT-SEEDED MAPPING
+ * =============================================================================
+ * Builds a complete mapping in one shot by solving a linear assignment over
+ * a G x H matrix of vertex-signature costs. A signature is the vertex degree,
+ * the cumulative histogram of its neighbours' degrees (log2 buckets) and its
+ * local clustering coefficient. Costs are asymmetric: H only has to dominate
+ * G, so deficits are charged more than surpluses. If G has more vertices
+ * than H, padding columns stand for added vertices. The assignment ignores
+ * how images relate to each other, so the mapping is then improved greedily:
+ * each G vertex takes the best improving relocate/swap towards the unused
+ * neighbours of its neighbours' images, until a pass changes nothing. This
+ * gives a strong starting point on regular-ish hosts where degree orderings
+ * carry no information; it runs in O(max(n_G, n_H)^3), so it is opt-in
+ * (GreedyOptions.assignmentSeed) and skipped above GREEDY_ASSIGNMENT_MAX_N
+ * vertices.
+ * =============================================================================
+ */
+#define GREEDY_ASSIGNMENT_MAX_N 500
+#define GREEDY_ASSIGNMENT_MAX_PASSES 20
+#define SIGNATURE_BUCKETS 8
+
+typedef struct {
+    int degree;
+    int cumulative[SIGNATURE_BUCKETS];  // neighbours with degree >= 2^b
+    int clustering;                     // local clustering coefficient x 10
+} VertexSignature;
+
+static void computeSignatures(Graph* g, VertexSignature* sig) {
+    for (int v = 0; v < g->n; v++) {
+        VertexSignature* s = &sig[v];
+        memset(s, 0, sizeof(*s));
+        s->degree = g->adjSize[v];
+        for (int i = 0; i < g->adjSize[v]; i++) {
+            int d = g->adjSize[g->adj[v][i]];
+            for (int b = 0; b < SIGNATURE_BUCKETS && d >= (1 << b); b++) s->cumulative[b]++;
+        }
+        int triangles = 0;
+        for (int i = 0; i < g->adjSize[v]; i++) {
+            for (int j = i + 1; j < g->adjSize[v]; j++) {
+                triangles += g->matrix[g->adj[v][i]][g->adj[v][j]] ? 1 : 0;
+            }
+        }
+        int pairs = s->degree * (s->degree - 1) / 2;
+        s->clustering = pairs > 0 ? (10 * triangles + pairs / 2) / pairs : 0;
+    }
+}
+
+static int signatureCost(const VertexSignature* g, const VertexSignature* h) {
+    int cost = 0;
+    if (g->degree > h->degree) cost += 4 * (g->degree - h->degree);
+    else cost += h->degree - g->degree;
+    for (int b = 0; b < SIGNATURE_BUCKETS; b++) {
+        if (g->cumulative[b] > h->cumulative[b]) cost += 2 * (g->cumulative[b] - h->cumulative[b]);
+    }
+    cost += g->clustering > h->clustering ? g->clustering - h->clustering
+                                          : h->clustering - g->clustering;
+    return cost;
+}
+
+// Steepest-descent improvement of a complete mapping restricted to moves
+// that can gain an edge: g moves onto (or swaps with the owner of) an H
+// neighbour of one of its neighbours' images.
+static void improveMapping(Graph* G, Graph* H, int* mapping, int* added_vertices) {
+    int* owner = malloc((H->n > 0 ? H->n : 1) * sizeof(int));
+    if (!owner) return;
+    for (int h = 0; h < H->n; h++) owner[h] = -1;
+    for (int g = 0; g < G->n; g++) if (mapping[g] < H->n) owner[mapping[g]] = g;
+
+    for (int pass = 0; pass < GREEDY_ASSIGNMENT_MAX_PASSES; pass++) {
+        int improved = 0;
+        for (int g = 0; g < G->n; g++) {
+            int from = mapping[g];
+            int best_delta = 0, best_to = -1;
+            for (int i = 0; i < G->adjSize[g]; i++) {
+                int img = mapping[G->adj[g][i]];
+                if (img >= H->n) continue;
+                for (int j = 0; j < H->adjSize[img]; j++) {
+                    int to = H->adj[img][j];
+                    if (to == from) continue;
+                    int other = owner[to];
+                    int delta;
+                    if (other < 0) {
+                        delta = relocateDelta(G, H, mapping, g, from, to, -1) - (from >= H->n);
+                    } else {
+                        delta = relocateDelta(G, H, mapping, g, from, to, other)
+                              + relocateDelta(G, H, mapping, other, to, from, g);
+                    }
+                    if (delta < best_delta) {
+                        best_delta = delta;
+                        best_to = to;
+                    }
+                }
+            }
+            if (best_to < 0) continue;
+
+            int other = owner[best_to];
+            mapping[g] = best_to;
+            owner[best_to] = g;
+            if (other >= 0) {
+                mapping[other] = from;
+                if (from < H->n) owner[from] = other;
+            } else if (from < H->n) {
+                owner[from] = -1;
+            } else {
+                (*added_vertices)--;
+            }
+            improved = 1;
+        }
+        if (!improved) break;
+    }
+
+    // Renumber added vertices consecutively after H's own vertices.
+    int added = 0;
+    for (int g = 0; g < G->n; g++) {
+        if (mapping[g] >= H->n) mapping[g] = H->n + added++;
+    }
+    *added_vertices = added;
+    free(owner);
+}
+
+// Fills mapping/added_vertices from the assignment; returns -1 if skipped.
+static int assignmentMapping(Graph* G, Graph* H, int* mapping, int* added_vertices) {
+    int n = G->n > H->n ? G->n : H->n;
+    if (n == 0 || n > GREEDY_ASSIGNMENT_MAX_N) return -1;
+
+    VertexSignature* sigG = malloc(G->n * sizeof(VertexSignature));
+    VertexSignature* sigH = malloc((H->n > 0 ? H->n : 1) * sizeof(VertexSignature));
+    AssignmentWorkspace* ws = assignmentWorkspaceCreate();
+    int* cost = ws ? assignmentCostBuffer(ws, G->n, n) : NULL;
+    int* assignment = malloc(G->n * sizeof(int));
+    if (!sigG || !sigH || !cost || !assignment) {
+        free(sigG); free(sigH); free(assignment);
+        assignmentWorkspaceFree(ws);
+        return -1;
+    }
+    computeSignatures(G, sigG);
+    computeSignatures(H, sigH);
+
+    // One row per G vertex; columns past H->n are added vertices: one
+    // vertex plus every incident edge.
+    for (int i = 0; i < G->n; i++) {
+        int* row = cost + (size_t)i * n;
+        for (int j = 0; j < n; j++) {
+            row[j] = j < H->n ? signatureCost(&sigG[i], &sigH[j])
+                              : 4 * (sigG[i].degree + 1);
+        }
+    }
+    long long total;
+    int status = assignmentSolve(ws, G->n, n, cost, assignment, &total);
+    assignmentWorkspaceFree(ws);
+    if (status != 0) {
+        free(assignment); free(sigG); free(sigH);
+        return -1;
+    }
+
+    int added = 0;
+    for (int i = 0; i < G->n; i++) {
+        int j = assignment[i];
+        mapping[i] = (j >= 0 && j < H->n) ? j : H->n + added++;
+    }
+    *added_vertices = added;
+    improveMapping(G, H, mapping, added_vertices);
+
+    free(assignment);
+    free(sigG);
+    free(sigH);
+    return 0;
 }
 
 // --- Main Algorithm ---
+GreedyExtension* greedyExtensionFromMapping(Graph* G, Graph* H, int* best_mapping,
+                                            int best_added_vertices) {
+    // --- Build edge list from best mapping ---
+    int added_edges_capacity = G->m;
+    int (*added_edges)[2] = malloc(added_edges_capacity * sizeof(int[2]));
+    int added_edges_count = 0;
+    
+    for (int u = 0; u < G->n; u++) {
+        for (int i = 0; i < G->adjSize[u]; i++) {
+            int v = G->adj[u][i];
+            if (u < v) {
+                int f_u = best_mapping[u];
+                int f_v = best_mapping[v];
+                
+                int edge_exists = 0;
+                if (f_u < H->n && f_v < H->n) {
+                    edge_exists = H->matrix[f_u][f_v];
+                }
+                
+                if (!edge_exists) {
+                    if (added_edges_count >= added_edges_capacity) {
+                        added_edges_capacity *= 2;
+                        added_edges = realloc(added_edges, added_edges_capacity * sizeof(int[2]));
+                    }
+                    added_edges[added_edges_count][0] = f_u;
+                    added_edges[added_edges_count][1] = f_v;
+                    added_edges_count++;
+                }
+            }
+        }
+    }
+    
+    // --- Build Result Struct ---
+    GreedyExtension* result = malloc(sizeof(GreedyExtension));
+    if (!result) {
+        free(best_mapping);
+        free(added_edges);
+        return NULL;
+    }
+    
+    result->newVertexCount = best_added_vertices;
+    if (best_added_vertices > 0) {
+        result->newVertices = malloc(best_added_vertices * sizeof(int));
+        for (int i = 0; i < best_added_vertices; i++) {
+            result->newVertices[i] = H->n + i;
+        }
+    } else {
+        result->newVertices = NULL;
+    }
+    
+    result->newEdgeCount = added_edges_count;
+    if (added_edges_count > 0) {
+        result->newEdges = malloc(added_edges_count * sizeof(int[2]));
+        for (int i = 0; i < added_edges_count; i++) {
+            result->newEdges[i][0] = added_edges[i][0];
+            result->newEdges[i][1] = added_edges[i][1];
+        }
+    } else {
+        result->newEdges = NULL;
+    }
+    
+    result->mapping = best_mapping;
+    result->mappingSize = G->n;
+    result->candidatesScored = 0;
+    result->fullScanCandidates = 0;
+    result->restartsRun = 0;
+    result->costBeforeRefinement = best_added_vertices + added_edges_count;
+    result->refinementMoves = 0;
+    
+    free(added_edges);
+    
+    return result;
+}
+
 GreedyExtension* greedy_extension(Graph* G, Graph* H) {
+    return greedy_extension_with_options(G, H, NULL);
+}
+
+GreedyExtension* greedy_extension_with_options(Graph* G, Graph* H, const GreedyOptions* opts) {
+    GreedyCandidateMode mode = opts ? opts->candidates : GREEDY_CANDIDATES_FULL;
     
     int* best_mapping = malloc(G->n * sizeof(int));
     int best_cost = INT_MAX;
     int best_added_vertices = 0;
     
+    GreedyScratch scratch;
+    if (greedyScratchInit(&scratch, G, H, mode) != 0 || !best_mapping) {
+        greedyScratchFree(&scratch);
+        free(best_mapping);
+        return NULL;
+    }
+    
     // Strategy 1: Sort by degree descending
+    double traceStart = traceBegin();
     VertexInfo* order1 = malloc(G->n * sizeof(VertexInfo));
     for (int i = 0; i < G->n; i++) {
         order1[i].id = i;
         order1[i].degree = G->adjSize[i];
     }
     qsort(order1, G->n, sizeof(VertexInfo), compareVertices);
-    tryMapping(G, H, order1, best_mapping, &best_cost, &best_added_vertices);
+    tryMapping(G, H, order1, &scratch, NULL, best_mapping, &best_cost, &best_added_vertices);
+    traceEndArgs(traceStart, "greedy strategy", "strategy", 1, "best", best_cost);
     
     // Strategy 2: Start from highest degree vertex and expand by connectivity (BFS-like)
+    traceStart = traceBegin();
     VertexInfo* order2 = malloc(G->n * sizeof(VertexInfo));
     int* visited = calloc(G->n, sizeof(int));
     int order_idx = 0;
@@ -242,9 +969,11 @@ GreedyExtension* greedy_extension(Graph* G, Graph* H) {
         }
     }
     
-    tryMapping(G, H, order2, best_mapping, &best_cost, &best_added_vertices);
+    tryMapping(G, H, order2, &scratch, NULL, best_mapping, &best_cost, &best_added_vertices);
+    traceEndArgs(traceStart, "greedy strategy", "strategy", 2, "best", best_cost);
     
     // Strategy 3: Try a few random-ish permutations based on different starting vertices
+    traceStart = traceBegin();
     for (int start_v = 0; start_v < G->n && start_v < 5; start_v++) {
         memset(visited, 0, G->n * sizeof(int));
         order_idx = 0;
@@ -276,77 +1005,61 @@ GreedyExtension* greedy_extension(Graph* G, Graph* H) {
             }
         }
         
-        tryMapping(G, H, order2, best_mapping, &best_cost, &best_added_vertices);
+        tryMapping(G, H, order2, &scratch, NULL, best_mapping, &best_cost, &best_added_vertices);
     }
+    traceEndArgs(traceStart, "greedy strategy", "strategy", 3, "best", best_cost);
     
     free(order1);
     free(order2);
     free(visited);
     free(queue);
+    greedyScratchFree(&scratch);
     
-    // --- Build edge list from best mapping ---
-    int added_edges_capacity = G->m;
-    int (*added_edges)[2] = malloc(added_edges_capacity * sizeof(int[2]));
-    int added_edges_count = 0;
-    
-    for (int u = 0; u < G->n; u++) {
-        for (int i = 0; i < G->adjSize[u]; i++) {
-            int v = G->adj[u][i];
-            if (u < v) {
-                int f_u = best_mapping[u];
-                int f_v = best_mapping[v];
-                
-                int edge_exists = 0;
-                if (f_u < H->n && f_v < H->n) {
-                    edge_exists = H->matrix[f_u][f_v];
-                }
-                
-                if (!edge_exists) {
-                    if (added_edges_count >= added_edges_capacity) {
-                        added_edges_capacity *= 2;
-                        added_edges = realloc(added_edges, added_edges_capacity * sizeof(int[2]));
-                    }
-                    added_edges[added_edges_count][0] = f_u;
-                    added_edges[added_edges_count][1] = f_v;
-                    added_edges_count++;
-                }
+    // Strategy 4: full mapping from a linear assignment over vertex signatures
+    if (opts && opts->assignmentSeed) {
+        traceStart = traceBegin();
+        int* seeded = malloc(G->n * sizeof(int));
+        int seeded_added = 0;
+        if (seeded && assignmentMapping(G, H, seeded, &seeded_added) == 0) {
+            int cost = calculateMappingCost(G, H, seeded, seeded_added);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_added_vertices = seeded_added;
+                memcpy(best_mapping, seeded, G->n * sizeof(int));
             }
         }
+        free(seeded);
+        traceEndArgs(traceStart, "greedy strategy", "strategy", 4, "best", best_cost);
     }
     
-    // --- Build Result Struct ---
-    GreedyExtension* result = malloc(sizeof(GreedyExtension));
-    if (!result) {
-        free(best_mapping);
-        free(added_edges);
-        return NULL;
+    // Strategy 5: randomized multi-start, when a restart budget is given
+    long restarts_run = 0;
+    long scored = scratch.candidates_scored;
+    long full_scan = scratch.full_scan_candidates;
+    if (opts && (opts->restarts > 0 || opts->timeBudget > 0)) {
+        traceStart = traceBegin();
+        runRestarts(G, H, opts, mode, best_mapping, &best_cost, &best_added_vertices,
+                    &restarts_run, &scored, &full_scan);
+        traceEndArgs(traceStart, "greedy strategy", "strategy", 5, "best", best_cost);
     }
     
-    result->newVertexCount = best_added_vertices;
-    if (best_added_vertices > 0) {
-        result->newVertices = malloc(best_added_vertices * sizeof(int));
-        for (int i = 0; i < best_added_vertices; i++) {
-            result->newVertices[i] = H->n + i;
-        }
-    } else {
-        result->newVertices = NULL;
+    // Optional refinement of the best constructive mapping
+    int cost_before_refinement = best_cost;
+    long refinement_moves = 0;
+    if (opts && opts->localSearch) {
+        traceStart = traceBegin();
+        refineMapping(G, H, best_mapping, &best_added_vertices, opts, &refinement_moves);
+        traceEndArgs(traceStart, "local search", "moves", refinement_moves, NULL, 0);
     }
     
-    result->newEdgeCount = added_edges_count;
-    if (added_edges_count > 0) {
-        result->newEdges = malloc(added_edges_count * sizeof(int[2]));
-        for (int i = 0; i < added_edges_count; i++) {
-            result->newEdges[i][0] = added_edges[i][0];
-            result->newEdges[i][1] = added_edges[i][1];
-        }
-    } else {
-        result->newEdges = NULL;
-    }
-    
-    result->mapping = best_mapping;
-    result->mappingSize = G->n;
+    GreedyExtension* result = greedyExtensionFromMapping(G, H, best_mapping, best_added_vertices);
+    if (!result) return NULL;
     
-    free(added_edges);
+    result->candidatesScored = scored;
+    result->fullScanCandidates = full_scan;
+    result->restartsRun = restarts_run;
+    result->costBeforeRefinement = cost_before_refinement;
+    result->refinementMoves = refinement_moves;
     
     return result;
 }
@@ -357,4 +1070,42 @@ void freeGreedyExtension(GreedyExtension* ext) {
     free(ext->newEdges);
     free(ext->mapping);
     free(ext);
-}
\ No newline at end of file
+}
+
+struct GreedyMapper {
+    Graph* G;
+    Graph* H;
+    GreedyScratch s;
+};
+
+GreedyMapper* greedyMapperCreate(Graph* G, Graph* H, GreedyCandidateMode mode) {
+    if (!G || !H) return NULL;
+    GreedyMapper* m = malloc(sizeof(GreedyMapper));
+    if (!m) return NULL;
+    m->G = G;
+    m->H = H;
+    if (greedyScratchInit(&m->s, G, H, mode) != 0) {
+        greedyScratchFree(&m->s);
+        free(m);
+        return NULL;
+    }
+    greedyScratchReset(&m->s, G, H);
+    return m;
+}
+
+void greedyMapperAssign(GreedyMapper* m, int v_g, int v_h) {
+    greedyScratchAssign(&m->s, m->G, m->H, v_g, v_h);
+}
+
+int greedyMapperSelect(GreedyMapper* m, int v_g, long* scored) {
+    long before = m->s.candidates_scored;
+    int v_h = selectCandidate(&m->s, m->G, m->H, v_g, NULL);
+    if (scored) *scored += m->s.candidates_scored - before;
+    return v_h;
+}
+
+void greedyMapperFree(GreedyMapper* m) {
+    if (!m) return;
+    greedyScratchFree(&m->s);
+    free(m);
+}
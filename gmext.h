@@ -10,8 +10,68 @@ typedef struct {
     int newEdgeCount;
     int* mapping;      // mapping from G vertices to H vertices
     int mappingSize;
+    long candidatesScored;    // (v_g, v_h) pairs the mapper evaluated
+    long fullScanCandidates;  // pairs a scan of every unused H vertex would evaluate
+    long restartsRun;         // randomized restarts completed (0 when disabled)
+    int costBeforeRefinement; // cost of the constructive mapping before local search
+    long refinementMoves;     // local search moves accepted (0 when disabled)
 } GreedyExtension;
 
+/**
+ * Which H vertices the mapper considers for each pattern vertex.
+ *
+ * GREEDY_CANDIDATES_FULL     - every unused H vertex (pruned by degree
+ *                              bucket bounds; identical to a full scan)
+ * GREEDY_CANDIDATES_FRONTIER - only unused neighbours of the images of
+ *                              already-mapped G neighbours; the degree
+ *                              index is consulted only when that frontier is
+ *                              empty (disconnected picks). Work becomes
+ *                              proportional to the edges touched, at the cost
+ *                              of ignoring non-adjacent candidates.
+ */
+typedef enum {
+    GREEDY_CANDIDATES_FULL,
+    GREEDY_CANDIDATES_FRONTIER
+} GreedyCandidateMode;
+
+/**
+ * Options for greedy_extension_with_options. Zero-initialised options give
+ * the plain deterministic greedy: the three ordering strategies.
+ *
+ * candidates - candidate generation policy (see GreedyCandidateMode)
+ * restarts   - number of randomized GRASP restarts run after the fixed
+ *              strategies (0 = none unless timeBudget is set)
+ * timeBudget - wall-clock seconds for restarts; with restarts == 0 restarts
+ *              run until the budget is used up (0 = no time limit)
+ * threads    - worker threads sharing the restarts (<= 1 = calling thread)
+ * seed       - PRNG seed; a given (seed, restarts) pair always yields the
+ *              same mapping regardless of the thread count
+ * rclSize    - restricted candidate list length for restarts: each step
+ *              picks uniformly among the best rclSize candidates
+ *              (0 = default of 3, capped at 16)
+ * localSearch  - refine the best mapping with simulated annealing over
+ *                relocate/swap moves (the 'greedy+ls' algorithm)
+ * lsIterations - annealing moves to try (0 = 200 per G vertex)
+ * lsTimeBudget - wall-clock cap for the refinement in seconds (0 = none)
+ * assignmentSeed - also seed a full mapping from a linear assignment over
+ *                vertex signatures. It costs O(n^3) in the larger graph,
+ *                10-100x the plain greedy (about 2 ms at 100 vertices,
+ *                30 ms at 300, 0.13 s at 500), and is skipped above 500
+ *                vertices
+ */
+typedef struct {
+    GreedyCandidateMode candidates;
+    int restarts;
+    double timeBudget;
+    int threads;
+    unsigned long long seed;
+    int rclSize;
+    int localSearch;
+    long lsIterations;
+    double lsTimeBudget;
+    int assignmentSeed;
+} GreedyOptions;
+
 /**
  * Calculates the Minimal Extension Cost to embed Graph G into Graph H.
  * This algorithm uses a greedy heuristic to map vertices from G to H.
@@ -22,9 +82,37 @@ typedef struct {
  */
 GreedyExtension* greedy_extension(Graph* G, Graph* H);
 
+/**
+ * Same as greedy_extension, with explicit options (NULL = defaults).
+ */
+GreedyExtension* greedy_extension_with_options(Graph* G, Graph* H, const GreedyOptions* opts);
+
+/**
+ * Builds a GreedyExtension from a complete mapping of G into H, where images
+ * >= H->n denote the added vertices H->n .. H->n + added_vertices - 1.
+ * Takes ownership of mapping (also on failure). Statistics fields are zero
+ * except costBeforeRefinement, which is set to the mapping's cost.
+ */
+GreedyExtension* greedyExtensionFromMapping(Graph* G, Graph* H, int* mapping, int added_vertices);
+
 /**
  * Frees a GreedyExtension struct.
  */
 void freeGreedyExtension(GreedyExtension* ext);
 
+/**
+ * The mapper's incremental state, for timing its candidate scoring on its
+ * own (the kernel benchmark). greedyMapperAssign records v_g -> v_h
+ * (v_h < H->n); greedyMapperSelect scores the candidates for the unmapped
+ * G vertex v_g against the current state, adds the number scored to
+ * *scored and returns the H vertex the deterministic greedy would pick
+ * (-1 if H is exhausted). Selecting does not change the state.
+ */
+typedef struct GreedyMapper GreedyMapper;
+
+GreedyMapper* greedyMapperCreate(Graph* G, Graph* H, GreedyCandidateMode mode);
+void greedyMapperAssign(GreedyMapper* m, int v_g, int v_h);
+int greedyMapperSelect(GreedyMapper* m, int v_g, long* scored);
+void greedyMapperFree(GreedyMapper* m);
+
 #endif // GMEXT_H
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include "graph.h"
+#include "assignment.h"
+#include "hamming.h"
 
 int** allocMatrix(int n) {
     int** m = malloc(n * sizeof(int*));
@@ -17,20 +21,51 @@ int** allocMatrix(int n) {
     return m;
 }
 
-// Load a graph from an open file in adjacency matrix format
-// Format: first line is number of vertices, then n lines of adjacency matrix
-Graph* loadGraphFromFile(FILE* f) {
-    if (!f) return NULL;
+// Source of the integers of a graph: an open file or a text buffer
+typedef struct {
+    FILE* f;
+    const char* text;
+    size_t length;
+    size_t pos;
+} GraphReader;
+
+// Reads the next integer like fscanf's %d; returns 1, or 0 if there is none.
+static int readInt(GraphReader* r, int* value) {
+    if (r->f) return fscanf(r->f, "%d", value) == 1;
+
+    while (r->pos < r->length && isspace((unsigned char)r->text[r->pos])) r->pos++;
+    size_t p = r->pos;
+    int negative = 0;
+    if (p < r->length && (r->text[p] == '-' || r->text[p] == '+')) negative = r->text[p++] == '-';
+    if (p >= r->length || !isdigit((unsigned char)r->text[p])) return 0;
+    long long v = 0;
+    while (p < r->length && isdigit((unsigned char)r->text[p])) {
+        if (v <= INT_MAX) v = v * 10 + (r->text[p] - '0');
+        p++;
+    }
+    if (negative) v = -v;
+    *value = v > INT_MAX ? INT_MAX : v < INT_MIN ? INT_MIN : (int)v;
+    r->pos = p;
+    return 1;
+}
 
+// Load a graph in adjacency matrix format
+// Format: first line is number of vertices, then n lines of adjacency matrix
+static Graph* readGraph(GraphReader* r) {
     Graph* g = malloc(sizeof(Graph));
     if (!g) return NULL;
 
     // Read number of vertices
-    if (fscanf(f, "%d", &g->n) != 1) {
+    if (!readInt(r, &g->n)) {
         fprintf(stderr, "Error: could not read number of vertices from input.\n");
         free(g);
         return NULL;
     }
+    if (g->n < 0) {
+        fprintf(stderr, "Error: negative number of vertices (%d) in input.\n", g->n);
+        free(g);
+        return NULL;
+    }
 
     g->matrix = allocMatrix(g->n);
     if (!g->matrix) {
@@ -53,7 +88,7 @@ Graph* loadGraphFromFile(FILE* f) {
     int edgeCount = 0;
     for (int i = 0; i < g->n; i++) {
         for (int j = 0; j < g->n; j++) {
-            if (fscanf(f, "%d", &g->matrix[i][j]) != 1) {
+            if (!readInt(r, &g->matrix[i][j])) {
                 fprintf(stderr, "Error: could not read adjacency matrix element at row %d column %d.\n", i, j);
                 for (int k = 0; k < g->n; k++) free(g->matrix[k]);
                 free(g->matrix);
@@ -97,11 +132,13 @@ Graph* loadGraphFromFile(FILE* f) {
     }
     g->m = edgeCount;
 
-    // Count degrees for adjacency list allocation
+    // Count degrees for adjacency list allocation. Positive entries are
+    // edges; the matrix is stored as 0/1 so readers can test entries directly.
     int* deg = calloc(g->n, sizeof(int));
     for (int i = 0; i < g->n; i++) {
         for (int j = 0; j < g->n; j++) {
-            if (g->matrix[i][j] > 0) {
+            g->matrix[i][j] = g->matrix[i][j] > 0;
+            if (g->matrix[i][j]) {
                 deg[i]++;
             }
         }
@@ -120,7 +157,7 @@ Graph* loadGraphFromFile(FILE* f) {
     // Fill adjacency lists
     for (int i = 0; i < g->n; i++) {
         for (int j = 0; j < g->n; j++) {
-            if (g->matrix[i][j] > 0) {
+            if (g->matrix[i][j]) {
                 g->adj[i][g->adjSize[i]++] = j;
             }
         }
@@ -130,6 +167,18 @@ Graph* loadGraphFromFile(FILE* f) {
     return g;
 }
 
+Graph* loadGraphFromFile(FILE* f) {
+    if (!f) return NULL;
+    GraphReader r = { f, NULL, 0, 0 };
+    return readGraph(&r);
+}
+
+Graph* parseGraph(const char* text, size_t length) {
+    if (!text) return NULL;
+    GraphReader r = { NULL, text, length, 0 };
+    return readGraph(&r);
+}
+
 // Load both graphs from a single file
 int loadBothGraphs(const char* filename, Graph** G, Graph** H) {
     FILE* f = fopen(filename, "r");
@@ -153,6 +202,15 @@ int loadBothGraphs(const char* filename, Graph** G, Graph** H) {
     return 0;
 }
 
+// True if only whitespace is left in f
+int graphFileAtEnd(FILE* f) {
+    int c;
+    do c = fgetc(f); while (c != EOF && isspace(c));
+    if (c == EOF) return 1;
+    ungetc(c, f);
+    return 0;
+}
+
 // Load single graph from file (adjacency matrix format)
 Graph* loadGraph(const char* filename) {
     FILE* f = fopen(filename, "r");
@@ -175,6 +233,106 @@ void freeGraph(Graph* g) {
     free(g);
 }
 
+Graph* cloneGraph(const Graph* src) {
+    if (!src) return NULL;
+    Graph* g = malloc(sizeof(Graph));
+    if (!g) return NULL;
+
+    g->n = src->n;
+    g->m = src->m;
+    g->adj = malloc((src->n > 0 ? src->n : 1) * sizeof(int*));
+    g->adjSize = calloc(src->n > 0 ? src->n : 1, sizeof(int));
+    g->matrix = allocMatrix(src->n);
+    if (!g->adj || !g->adjSize || (src->n > 0 && !g->matrix)) {
+        if (g->matrix) {
+            for (int i = 0; i < src->n; i++) free(g->matrix[i]);
+            free(g->matrix);
+        }
+        free(g->adj);
+        free(g->adjSize);
+        free(g);
+        return NULL;
+    }
+
+    for (int i = 0; i < src->n; i++) {
+        g->adjSize[i] = src->adjSize[i];
+        if (src->adjSize[i] > 0) {
+            g->adj[i] = malloc(src->adjSize[i] * sizeof(int));
+            memcpy(g->adj[i], src->adj[i], src->adjSize[i] * sizeof(int));
+        } else {
+            g->adj[i] = NULL;
+        }
+        memcpy(g->matrix[i], src->matrix[i], src->n * sizeof(int));
+    }
+    return g;
+}
+
+// 64-bit finaliser (splitmix64); spreads colour values before they are
+// combined so that sums of neighbour colours do not collide trivially.
+static uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Weisfeiler-Lehman refinement: each round a vertex's colour becomes a hash
+// of its own colour and the multiset of its neighbours' colours. Multisets
+// are folded with order-independent sum/xor so no per-vertex sort is needed.
+uint64_t graphWLHash(const Graph* g, int rounds) {
+    if (!g) return 0;
+    uint64_t h = mix64((uint64_t)g->n) ^ mix64(((uint64_t)g->m << 32) | 0x5bd1e995ULL);
+    if (g->n == 0) return h;
+
+    uint64_t* color = malloc(g->n * sizeof(uint64_t));
+    uint64_t* next = malloc(g->n * sizeof(uint64_t));
+    if (!color || !next) {
+        free(color); free(next);
+        return h;
+    }
+    for (int v = 0; v < g->n; v++) color[v] = mix64((uint64_t)g->adjSize[v]);
+
+    for (int r = 0; r < rounds; r++) {
+        for (int v = 0; v < g->n; v++) {
+            uint64_t sum = 0, x = 0;
+            for (int i = 0; i < g->adjSize[v]; i++) {
+                uint64_t c = mix64(color[g->adj[v][i]]);
+                sum += c;
+                x ^= c * 0xff51afd7ed558ccdULL;
+            }
+            next[v] = mix64(color[v] ^ mix64(sum) ^ (x << 1 | x >> 63));
+        }
+        uint64_t* t = color; color = next; next = t;
+    }
+
+    uint64_t sum = 0, x = 0;
+    for (int v = 0; v < g->n; v++) {
+        uint64_t c = mix64(color[v]);
+        sum += c;
+        x ^= c * 0xc4ceb9fe1a85ec53ULL;
+    }
+    free(color);
+    free(next);
+    return mix64(h ^ sum) ^ x;
+}
+
+// Labelled edges are folded with two independent order-free sums, so the
+// adjacency list order does not matter but every vertex label does.
+void graphContentHash(const Graph* g, uint64_t out[2]) {
+    uint64_t a = mix64((uint64_t)g->n), b = mix64(((uint64_t)g->m << 32) ^ 0x2545f4914f6cdd1dULL);
+    for (int u = 0; u < g->n; u++) {
+        for (int i = 0; i < g->adjSize[u]; i++) {
+            int v = g->adj[u][i];
+            if (v <= u) continue;
+            uint64_t e = ((uint64_t)u << 32) | (uint32_t)v;
+            a += mix64(e);
+            b += mix64(e ^ 0xd6e8feb86659fd93ULL) * 0x9e3779b97f4a7c15ULL;
+        }
+    }
+    out[0] = mix64(a ^ ((uint64_t)g->n << 1));
+    out[1] = mix64(b + (uint64_t)g->m);
+}
+
 /**
  * =============================================================================
  * GRAPH SIZE IMPLEMENTATION
@@ -210,146 +368,235 @@ int extensionDistance(const Graph* G, const Graph* H, int newVertices, int newEd
     return newVertices + newEdges;
 }
 
-// Simple Hungarian (assignment) implementation for integer cost matrix.
-// Minimizes sum of assigned costs. Returns total minimal cost and fills
-// `assignment` where assignment[i] = column assigned to row i (0-based).
-static int hungarianSolve(int n, int** a, int* assignment) {
+// Square assignment over a jagged matrix, kept for existing callers; the
+// work is done by the flat-buffer engine in assignment.c.
+int hungarianSolve(int n, int** a, int* assignment) {
     const int INF = 1000000000;
-    int i, j, col;
-    int *u = calloc(n+1, sizeof(int));
-    int *v = calloc(n+1, sizeof(int));
-    int *p = calloc(n+1, sizeof(int));
-    int *way = calloc(n+1, sizeof(int));
-    if (!u || !v || !p || !way) {
-        free(u); free(v); free(p); free(way);
+    AssignmentWorkspace* ws = assignmentWorkspaceCreate();
+    int* cost = ws ? assignmentCostBuffer(ws, n, n) : NULL;
+    if (!cost) {
+        assignmentWorkspaceFree(ws);
         return INF;
     }
+    for (int i = 0; i < n; ++i) {
+        memcpy(cost + (size_t)i * n, a[i], n * sizeof(int));
+    }
+    long long total;
+    int status = assignmentSolve(ws, n, n, cost, assignment, &total);
+    assignmentWorkspaceFree(ws);
+    return status != 0 ? INF : (int)total;
+}
 
-    for (i = 1; i <= n; ++i) {
-        p[0] = i;
-        int j0 = 0;
-        int *minv = malloc((n+1) * sizeof(int));
-        char *used = calloc(n+1, sizeof(char));
-        if (!minv || !used) {
-            free(minv); free(used);
-            free(u); free(v); free(p); free(way);
-            return INF;
-        }
-        for (j = 0; j <= n; ++j) minv[j] = INF, used[j] = 0;
-        do {
-            used[j0] = 1;
-            int i0 = p[j0], delta = INF, j1 = 0;
-            for (j = 1; j <= n; ++j) if (!used[j]) {
-                int cur = a[i0-1][j-1] - u[i0] - v[j];
-                if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
-                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
-            }
-            for (j = 0; j <= n; ++j) {
-                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
-                else minv[j] -= delta;
-            }
-            j0 = j1;
-        } while (p[j0] != 0);
-        do {
-            int j1 = way[j0];
-            p[j0] = p[j1];
-            j0 = j1;
-        } while (j0 != 0);
-
-        free(minv); free(used);
+// Approximate graph distance using assignment (Hungarian) on adjacency rows.
+// This runs in polynomial time O(n^3) due to the assignment solver. The
+// cost matrix is built from bit-packed rows (see hamming.h). Cost
+// (i,j) is the Hamming distance between row i of G1 and row j of G2 after
+// padding to equal sizes. The final distance is (sum_assigned_row_distances
+// / 2) + |n1 - n2|, where division by 2 accounts for undirected
+// double-counting of edge mismatches and the vertex difference term charges
+// vertex add/del.
+//
+// Instead of padding the smaller graph with empty rows, the problem is
+// solved rectangular: an empty row matched to row j of the larger graph
+// costs the ones in row j, so charging every column its row weight up front
+// and giving it back when a real row takes column j yields the same optimum.
+// The costs are offset by the maximum row weight to stay non-negative.
+static int graphDistanceHungarian(const Graph* G1, const Graph* G2, int threads) {
+    if (G1->n > G2->n) {
+        const Graph* t = G1; G1 = G2; G2 = t;
+    }
+    int n1 = G1->n;
+    int n2 = G2->n;
+    if (n2 == 0) return 0;
+
+    AssignmentWorkspace* ws = assignmentWorkspaceCreate();
+    int* cost = ws ? assignmentCostBuffer(ws, n1, n2) : NULL;
+    int* assignment = malloc((n1 > 0 ? n1 : 1) * sizeof(int));
+    int* weight = malloc(n2 * sizeof(int));
+    PackedRows rows1 = {0}, rows2 = {0};
+    if (!cost || !assignment || !weight ||
+        packAdjacencyRows(G1, n2, &rows1) != 0 || packAdjacencyRows(G2, n2, &rows2) != 0) {
+        assignmentWorkspaceFree(ws);
+        free(assignment);
+        free(weight);
+        freePackedRows(&rows1);
+        freePackedRows(&rows2);
+        return -1;
     }
 
-    // Build assignment and compute cost
-    for (j = 1; j <= n; ++j) {
-        if (p[j] > 0) {
-            assignment[p[j]-1] = j-1;
-        }
+    int maxWeight = 0;
+    long long weightSum = 0;
+    for (int j = 0; j < n2; ++j) {
+        int w = 0;
+        for (int k = 0; k < n2; ++k) w += G2->matrix[j][k];
+        weight[j] = w;
+        weightSum += w;
+        if (w > maxWeight) maxWeight = w;
     }
 
-    int totalCost = 0;
-    for (i = 0; i < n; ++i) {
-        col = assignment[i];
-        if (col >= 0) totalCost += a[i][col];
+    // Row Hamming distances over the n2 columns; G1's rows are zero past n1
+    hammingMatrix(&rows1, &rows2, cost, threads);
+    freePackedRows(&rows1);
+    freePackedRows(&rows2);
+    for (int i = 0; i < n1; ++i) {
+        int* row = cost + (size_t)i * n2;
+        for (int j = 0; j < n2; ++j) row[j] += maxWeight - weight[j];
     }
 
-    free(u); free(v); free(p); free(way);
-    return totalCost;
+    long long solved;
+    int status = assignmentSolve(ws, n1, n2, cost, assignment, &solved);
+    assignmentWorkspaceFree(ws);
+    free(assignment);
+    free(weight);
+    if (status != 0) return -1;
+
+    long long total = solved - (long long)n1 * maxWeight + weightSum;
+
+    // For undirected graphs, each edge mismatch counted twice in row sums.
+    int edgeMismatches = (int)(total / 2);
+    int vertexDiff = n2 - n1;
+    return edgeMismatches + vertexDiff;
 }
 
-// Approximate graph distance using assignment (Hungarian) on adjacency rows.
-// This runs in polynomial time O(n^3) due to the Hungarian solver. It's a
-// simple and fast approximation: construct cost matrix where cost(i,j) is
-// the Hamming distance between row i of G1 and row j of G2 after padding
-// to equal sizes. The final distance is (sum_assigned_row_distances / 2)
-// + |n1 - n2|, where division by 2 accounts for undirected double-counting
-// of edge mismatches and the vertex difference term charges vertex add/del.
-static int graphDistanceHungarian(const Graph* G1, const Graph* G2) {
-    int n1 = G1 ? G1->n : 0;
-    int n2 = G2 ? G2->n : 0;
-    int n = n1 > n2 ? n1 : n2;
-    if (n == 0) return 0;
-
-    // allocate cost matrix
-    int** cost = allocMatrix(n);
-    if (!cost) return -1;
-
-    // build padded row-hamming costs
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < n; ++j) {
-            int h = 0;
-            for (int k = 0; k < n; ++k) {
-                int a = 0, b = 0;
-                if (i < n1 && k < n1) a = G1->matrix[i][k];
-                if (j < n2 && k < n2) b = G2->matrix[j][k];
-                if (a != b) h++;
-            }
-            cost[i][j] = h;
-        }
+// Vertices by descending degree, ties by ascending id (counting sort,
+// O(n + max degree)). Returns -1 if memory runs out.
+static int degreeOrder(const Graph* g, int* order) {
+    int maxDeg = 0;
+    for (int v = 0; v < g->n; v++) {
+        if (g->adjSize[v] > maxDeg) maxDeg = g->adjSize[v];
     }
+    int* start = calloc(maxDeg + 2, sizeof(int));
+    if (!start) return -1;
+    for (int v = 0; v < g->n; v++) start[maxDeg - g->adjSize[v] + 1]++;
+    for (int d = 1; d <= maxDeg + 1; d++) start[d] += start[d - 1];
+    for (int v = 0; v < g->n; v++) order[start[maxDeg - g->adjSize[v]]++] = v;
+    free(start);
+    return 0;
+}
 
-    int* assignment = malloc(n * sizeof(int));
-    if (!assignment) {
-        for (int i = 0; i < n; i++) free(cost[i]); free(cost);
-        return -1;
+// Vertex degrees in descending order, padded with zeros to `len` entries.
+static int sortedDegrees(const Graph* g, int len, int* out) {
+    if (degreeOrder(g, out) != 0) return -1;
+    for (int k = 0; k < g->n; k++) out[k] = g->adjSize[out[k]];
+    for (int k = g->n; k < len; k++) out[k] = 0;
+    return 0;
+}
+
+// Degree-sequence lower bound on the edit distance. Under any alignment a
+// vertex of degree a matched to one of degree b has at least |a - b|
+// mismatched incident edges and every edge has two endpoints, so at least
+// half the sorted degree-sequence difference must be edited; the edge
+// count difference is a second bound. O(n + max degree).
+static int distanceLowerBound(const Graph* G1, const Graph* G2) {
+    int n = G1->n > G2->n ? G1->n : G2->n;
+    int vertexDiff = G1->n > G2->n ? G1->n - G2->n : G2->n - G1->n;
+    int edgeDiff = G1->m > G2->m ? G1->m - G2->m : G2->m - G1->m;
+    int* d1 = malloc((n > 0 ? n : 1) * sizeof(int));
+    int* d2 = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!d1 || !d2 || sortedDegrees(G1, n, d1) != 0 || sortedDegrees(G2, n, d2) != 0) {
+        free(d1); free(d2);
+        return vertexDiff + edgeDiff;
     }
-    for (int i = 0; i < n; ++i) assignment[i] = -1;
+    long long diff = 0;
+    for (int i = 0; i < n; i++) diff += d1[i] > d2[i] ? d1[i] - d2[i] : d2[i] - d1[i];
+    free(d1); free(d2);
 
-    int total = hungarianSolve(n, cost, assignment);
+    int degreeBound = (int)((diff + 1) / 2);
+    return vertexDiff + (degreeBound > edgeDiff ? degreeBound : edgeDiff);
+}
 
-    // free cost
-    for (int i = 0; i < n; ++i) free(cost[i]); free(cost);
+// Upper bound from an explicit alignment: vertices of both graphs ranked by
+// degree and matched rank by rank. The cost of that alignment (unmatched
+// vertices plus edges present on only one side) is a valid edit script.
+// O(n + m).
+static int distanceUpperBound(const Graph* G1, const Graph* G2) {
+    int n1 = G1->n, n2 = G2->n;
+    int vertexDiff = n1 > n2 ? n1 - n2 : n2 - n1;
+    int* order1 = malloc((n1 > 0 ? n1 : 1) * sizeof(int));
+    int* order2 = malloc((n2 > 0 ? n2 : 1) * sizeof(int));
+    int* image = malloc((n1 > 0 ? n1 : 1) * sizeof(int));
+    if (!order1 || !order2 || !image ||
+        degreeOrder(G1, order1) != 0 || degreeOrder(G2, order2) != 0) {
+        free(order1); free(order2); free(image);
+        return vertexDiff + G1->m + G2->m;
+    }
 
-    if (total >= 1000000000) { free(assignment); return -1; }
+    for (int k = 0; k < n1; k++) image[order1[k]] = k < n2 ? order2[k] : -1;
 
-    // For undirected graphs, each edge mismatch counted twice in row sums.
-    int edgeMismatches = total / 2;
-    int vertexDiff = n1 > n2 ? n1 - n2 : n2 - n1;
-    int distance = edgeMismatches + vertexDiff;
+    int preserved = 0;
+    for (int u = 0; u < n1; u++) {
+        if (image[u] < 0) continue;
+        for (int i = 0; i < G1->adjSize[u]; i++) {
+            int v = G1->adj[u][i];
+            if (u < v && image[v] >= 0 && G2->matrix[image[u]][image[v]]) preserved++;
+        }
+    }
+    free(order1); free(order2); free(image);
+    return vertexDiff + G1->m + G2->m - 2 * preserved;
+}
 
-    free(assignment);
-    return distance;
+const char* distanceTierName(DistanceTier tier) {
+    switch (tier) {
+        case DISTANCE_TIER_LOWER_BOUND: return "degree lower bound";
+        case DISTANCE_TIER_UPPER_BOUND: return "greedy alignment upper bound";
+        case DISTANCE_TIER_ASSIGNMENT:  return "assignment estimate";
+    }
+    return "?";
 }
 
 /**
  * =============================================================================
  * GRAPH METRIC IMPLEMENTATION
  * =============================================================================
- * Computes an approximation of Graph Edit Distance between two graphs.
- * 
- * For small graphs, we use the exact structural difference.
- * For larger graphs, we use a heuristic based on size differences.
+ * Computes an approximation of Graph Edit Distance between two graphs in
+ * one of three tiers (see DistanceMode). The two bounds are always computed
+ * because they are cheap; the assignment estimate only when requested or
+ * below the size threshold.
  * 
  * The metric d(G1, G2) represents the minimum edit operations needed
  * to transform G1 into G2 (or vice versa, since it's symmetric).
  * =============================================================================
  */
-int graphDistance(const Graph* G1, const Graph* G2) {
-    // Use the polynomial-time Hungarian-based approximation.
-    // The function handles null graphs and returns an integer edit estimate.
-    if (!G1 && !G2) return 0;
-    if (!G1) return graphSize(G2);
-    if (!G2) return graphSize(G1);
+int graphDistanceWithOptions(const Graph* G1, const Graph* G2,
+                             const GraphDistanceOptions* opts, GraphDistanceResult* out) {
+    DistanceMode mode = opts ? opts->mode : DISTANCE_AUTO;
+    int maxN = (opts && opts->assignmentMaxN > 0) ? opts->assignmentMaxN
+                                                  : DISTANCE_ASSIGNMENT_MAX_N;
+    int threads = opts ? opts->threads : 1;
+    GraphDistanceResult local;
+    if (!out) out = &local;
+
+    if (!G1 || !G2) {
+        // Against a missing graph every vertex and edge is an edit
+        int size = !G1 && !G2 ? 0 : graphSize(G1 ? G1 : G2);
+        out->value = out->lowerBound = out->upperBound = size;
+        out->tier = DISTANCE_TIER_LOWER_BOUND;
+        return size;
+    }
+
+    out->lowerBound = distanceLowerBound(G1, G2);
+    out->upperBound = distanceUpperBound(G1, G2);
 
-    return graphDistanceHungarian(G1, G2);
+    int n = G1->n > G2->n ? G1->n : G2->n;
+    if (mode == DISTANCE_ASSIGNMENT || (mode == DISTANCE_AUTO && n <= maxN)) {
+        int estimate = graphDistanceHungarian(G1, G2, threads);
+        if (estimate >= 0) {
+            out->value = estimate;
+            out->tier = DISTANCE_TIER_ASSIGNMENT;
+            return estimate;
+        }
+    }
+    if (mode == DISTANCE_LOWER_BOUND) {
+        out->value = out->lowerBound;
+        out->tier = DISTANCE_TIER_LOWER_BOUND;
+    } else {
+        out->value = out->upperBound;
+        out->tier = DISTANCE_TIER_UPPER_BOUND;
+    }
+    return out->value;
+}
+
+int graphDistance(const Graph* G1, const Graph* G2) {
+    return graphDistanceWithOptions(G1, G2, NULL, NULL);
 }
 
@@ -2,6 +2,7 @@
 #define GRAPH_H
 
 #include <stdio.h>
+#include <stdint.h>
 
 typedef struct {
     int n;          // number of vertices
@@ -16,8 +17,24 @@ typedef struct {
 int** allocMatrix(int n);
 Graph* loadGraph(const char* filename);  // Load single graph from file (adjacency matrix format)
 Graph* loadGraphFromFile(FILE* f);  // Load one graph from an open file (adjacency matrix format)
+Graph* parseGraph(const char* text, size_t length);  // Same, from a text buffer (no NUL needed)
 int loadBothGraphs(const char* filename, Graph** G, Graph** H);  // Load both graphs from single file
+int graphFileAtEnd(FILE* f);  // True if only whitespace is left (no further graph to load)
 void freeGraph(Graph* g);
+Graph* cloneGraph(const Graph* g);  // Deep copy (adjacency lists and matrix)
+
+/**
+ * Isomorphism-invariant structural hash (Weisfeiler-Lehman colour
+ * refinement). Isomorphic graphs always hash equal; different hashes prove
+ * non-isomorphism, equal hashes do not prove isomorphism.
+ */
+uint64_t graphWLHash(const Graph* g, int rounds);
+
+/**
+ * 128-bit hash of the labelled graph: equal for equal vertex count and
+ * edge set, so unlike graphWLHash a relabelled copy hashes differently.
+ */
+void graphContentHash(const Graph* g, uint64_t out[2]);
 
 /**
  * =============================================================================
@@ -46,6 +63,63 @@ int graphSize(const Graph* g);
  */
 int graphDistance(const Graph* G1, const Graph* G2);
 
+/**
+ * Distance tiers, from cheapest to most expensive:
+ *
+ * DISTANCE_LOWER_BOUND - degree-sequence bound, O(n + max degree). No
+ *                        alignment can cost less.
+ * DISTANCE_UPPER_BOUND - cost of an explicit degree-rank alignment,
+ *                        O(n + m). Some edit script costs exactly this.
+ * DISTANCE_ASSIGNMENT  - assignment over adjacency-row Hamming distances,
+ *                        O(n^3). The closest estimate, but neither bound.
+ * DISTANCE_AUTO        - the assignment estimate up to assignmentMaxN
+ *                        vertices, the upper bound above it.
+ */
+typedef enum {
+    DISTANCE_AUTO,
+    DISTANCE_LOWER_BOUND,
+    DISTANCE_UPPER_BOUND,
+    DISTANCE_ASSIGNMENT
+} DistanceMode;
+
+typedef enum {
+    DISTANCE_TIER_LOWER_BOUND,
+    DISTANCE_TIER_UPPER_BOUND,
+    DISTANCE_TIER_ASSIGNMENT
+} DistanceTier;
+
+#define DISTANCE_ASSIGNMENT_MAX_N 2000
+
+typedef struct {
+    DistanceMode mode;
+    int assignmentMaxN;  // DISTANCE_AUTO threshold (0 = DISTANCE_ASSIGNMENT_MAX_N)
+    int threads;         // cost-matrix workers for the assignment (<= 1 = calling thread)
+} GraphDistanceOptions;
+
+typedef struct {
+    int value;          // the reported distance
+    DistanceTier tier;  // which tier produced value
+    int lowerBound;     // always computed
+    int upperBound;     // always computed
+} GraphDistanceResult;
+
+/**
+ * graphDistance with an explicit tier choice (NULL options = DISTANCE_AUTO).
+ * Fills *out (may be NULL) and returns out->value. If the assignment runs
+ * out of memory the upper bound is reported instead.
+ */
+int graphDistanceWithOptions(const Graph* G1, const Graph* G2,
+                             const GraphDistanceOptions* opts, GraphDistanceResult* out);
+
+const char* distanceTierName(DistanceTier tier);
+
+/**
+ * Solves the n x n linear assignment problem for an integer cost matrix
+ * (Hungarian method, O(n^3)). Fills assignment[i] with the column given to
+ * row i and returns the minimal total cost, or 1000000000 if memory runs out.
+ */
+int hungarianSolve(int n, int** a, int* assignment);
+
 /**
  * Computes the extension distance - the minimum number of operations
  * (vertex additions + edge additions) needed to make H contain G as a subgraph.
@@ -0,0 +1,648 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "graphdb.h"
+#include "timing.h"
+#include "stats.h"
+#include "trace.h"
+
+// File layout (native byte order): magic, host count, then per host the
+// name length and bytes, n, m, adjStart[n + 1] and adj[2m] as int32,
+// followed (version 2) by the FEATURE_COUNT feature counts as int64.
+// Version 1 files have no counts; they are recomputed on load.
+static const char DB_MAGIC[8] = { 'A', 'A', 'C', 'G', 'D', 'B', '0', '2' };
+static const char DB_MAGIC_V1[8] = { 'A', 'A', 'C', 'G', 'D', 'B', '0', '1' };
+// Prepared pattern files: magic, n, m, order[n], degree[n], parent[n],
+// backStart[n + 1] and back[backStart[n]] as int32, then the feature counts.
+static const char PATTERN_MAGIC[8] = { 'A', 'A', 'C', 'P', 'A', 'T', '0', '1' };
+#define DB_MAX_NAME 4096
+
+// Degrees in descending order by counting sort (degrees are < n).
+static void descendingDegrees(const int* degree, int n, int* out) {
+    int* count = calloc(n + 1, sizeof(int));
+    if (!count) {
+        // Fall back to insertion sort rather than fail
+        for (int i = 0; i < n; i++) {
+            int d = degree[i], j = i;
+            while (j > 0 && out[j - 1] < d) { out[j] = out[j - 1]; j--; }
+            out[j] = d;
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) count[degree[i]]++;
+    int k = 0;
+    for (int d = n; d >= 0; d--) {
+        for (int c = 0; c < count[d]; c++) out[k++] = d;
+    }
+    free(count);
+}
+
+// --- Pattern ---
+
+void freePreparedPattern(PreparedPattern* p) {
+    if (!p) return;
+    free(p->order);
+    free(p->degree);
+    free(p->parent);
+    free(p->backStart);
+    free(p->back);
+    free(p->sortedDegrees);
+    free(p);
+}
+
+PreparedPattern* preparePattern(const Graph* G) {
+    PreparedPattern* p = calloc(1, sizeof(PreparedPattern));
+    if (!p) return NULL;
+    int n = G->n;
+    int len = n > 0 ? n : 1;
+    p->n = n;
+    p->m = G->m;
+    p->order = malloc(len * sizeof(int));
+    p->degree = malloc(len * sizeof(int));
+    p->parent = malloc(len * sizeof(int));
+    p->backStart = malloc((n + 1) * sizeof(int));
+    p->back = malloc((2 * G->m > 0 ? 2 * G->m : 1) * sizeof(int));
+    p->sortedDegrees = malloc(len * sizeof(int));
+    int* pos = malloc(len * sizeof(int));
+    int* placedNeighbours = calloc(len, sizeof(int));
+    if (!p->order || !p->degree || !p->parent || !p->backStart || !p->back ||
+        !p->sortedDegrees || !pos || !placedNeighbours) {
+        free(pos);
+        free(placedNeighbours);
+        freePreparedPattern(p);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) pos[v] = -1;
+
+    // Next vertex: most neighbours already placed, then highest degree.
+    // A vertex with no placed neighbour starts a new component.
+    for (int i = 0; i < n; i++) {
+        int best = -1;
+        for (int v = 0; v < n; v++) {
+            if (pos[v] >= 0) continue;
+            if (best < 0 || placedNeighbours[v] > placedNeighbours[best] ||
+                (placedNeighbours[v] == placedNeighbours[best] && G->adjSize[v] > G->adjSize[best])) {
+                best = v;
+            }
+        }
+        pos[best] = i;
+        p->order[i] = best;
+        p->degree[i] = G->adjSize[best];
+        for (int j = 0; j < G->adjSize[best]; j++) placedNeighbours[G->adj[best][j]]++;
+    }
+
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        int v = p->order[i];
+        p->backStart[i] = k;
+        p->parent[i] = -1;
+        for (int j = 0; j < G->adjSize[v]; j++) {
+            int q = pos[G->adj[v][j]];
+            if (q >= i) continue;
+            p->back[k++] = q;
+            // Candidates come from the neighbours of the parent's image;
+            // the lowest-degree parent tends to have the fewest.
+            if (p->parent[i] < 0 || p->degree[q] < p->degree[p->parent[i]]) p->parent[i] = q;
+        }
+    }
+    p->backStart[n] = k;
+
+    descendingDegrees(p->degree, n, p->sortedDegrees);
+    free(pos);
+    free(placedNeighbours);
+
+    // Feature counts are computed on the host representation of G
+    PreparedHost* asHost = prepareHost(G, NULL);
+    if (!asHost) {
+        freePreparedPattern(p);
+        return NULL;
+    }
+    p->features = asHost->features;
+    freePreparedHost(asHost);
+    return p;
+}
+
+// --- Host ---
+
+void freePreparedHost(PreparedHost* h) {
+    if (!h) return;
+    free(h->name);
+    free(h->degree);
+    free(h->adjStart);
+    free(h->adj);
+    free(h->sortedDegrees);
+    free(h->bits);
+    free(h);
+}
+
+// Builds degree, sortedDegrees and bits from name/n/m/adjStart/adj.
+static int finishHost(PreparedHost* h) {
+    int len = h->n > 0 ? h->n : 1;
+    h->words = (h->n + 63) / 64;
+    h->degree = malloc(len * sizeof(int));
+    h->sortedDegrees = malloc(len * sizeof(int));
+    h->bits = calloc((size_t)len * (h->words > 0 ? h->words : 1), sizeof(uint64_t));
+    if (!h->degree || !h->sortedDegrees || !h->bits) return -1;
+
+    for (int v = 0; v < h->n; v++) {
+        h->degree[v] = h->adjStart[v + 1] - h->adjStart[v];
+        uint64_t* row = h->bits + (size_t)v * h->words;
+        for (int e = h->adjStart[v]; e < h->adjStart[v + 1]; e++) {
+            int u = h->adj[e];
+            row[u >> 6] |= 1ULL << (u & 63);
+        }
+    }
+    descendingDegrees(h->degree, h->n, h->sortedDegrees);
+    return 0;
+}
+
+PreparedHost* prepareHost(const Graph* H, const char* name) {
+    PreparedHost* h = calloc(1, sizeof(PreparedHost));
+    if (!h) return NULL;
+    h->n = H->n;
+    h->m = H->m;
+    h->name = strdup(name ? name : "");
+    h->adjStart = malloc((H->n + 1) * sizeof(int));
+    h->adj = malloc((2 * H->m > 0 ? 2 * H->m : 1) * sizeof(int));
+    if (!h->name || !h->adjStart || !h->adj) {
+        freePreparedHost(h);
+        return NULL;
+    }
+    int k = 0;
+    for (int v = 0; v < H->n; v++) {
+        h->adjStart[v] = k;
+        for (int j = 0; j < H->adjSize[v]; j++) h->adj[k++] = H->adj[v][j];
+    }
+    h->adjStart[H->n] = k;
+    if (finishHost(h) != 0 ||
+        computeGraphFeatures(h->n, h->adjStart, h->adj, h->bits, h->words, &h->features) != 0) {
+        freePreparedHost(h);
+        return NULL;
+    }
+    return h;
+}
+
+// --- Matching ---
+
+static int reserveScratch(MatchScratch* s, int patternN, int hostWords) {
+    if (patternN > s->patternCap) {
+        int* map = realloc(s->map, patternN * sizeof(int));
+        if (!map) return -1;
+        s->map = map;
+        int* cursor = realloc(s->cursor, patternN * sizeof(int));
+        if (!cursor) return -1;
+        s->cursor = cursor;
+        s->patternCap = patternN;
+    }
+    if (hostWords > s->usedWords) {
+        uint64_t* used = realloc(s->used, hostWords * sizeof(uint64_t));
+        if (!used) return -1;
+        s->used = used;
+        s->usedWords = hostWords;
+    }
+    return 0;
+}
+
+void freeMatchScratch(MatchScratch* s) {
+    free(s->map);
+    free(s->cursor);
+    free(s->used);
+    memset(s, 0, sizeof(*s));
+}
+
+// Feature counts and degree sequence: false proves G does not embed.
+bool preparedInvariantsAllow(const PreparedPattern* p, const PreparedHost* h) {
+    if (!featuresDominate(&h->features, &p->features)) return false;
+    for (int i = 0; i < p->n; i++) {
+        if (p->sortedDegrees[i] > h->sortedDegrees[i]) return false;
+    }
+    return true;
+}
+
+// Iterative backtracking over the pattern's fixed order. Every candidate
+// for position i must be unused, have enough degree and be adjacent to the
+// images of all earlier neighbours (one bitset probe each). Stops after
+// `limit` embeddings (<= 0 = all), or once wallSeconds() passes `deadline`
+// (0 = none; *expired is then set), and returns how many it found.
+static long long matchPrepared(const PreparedPattern* p, const PreparedHost* h,
+                               MatchScratch* s, long long limit,
+                               double deadline, bool* expired) {
+    int n = p->n;
+    STAT_INC(STAT_MATCH_CALLS);
+    if (n == 0) return 1;
+    long long found = 0;
+    int* map = s->map;
+    int* cursor = s->cursor;
+    uint64_t* used = s->used;
+    memset(used, 0, h->words * sizeof(uint64_t));
+
+    int level = 0;
+    unsigned steps = 0;
+    cursor[0] = 0;
+    while (level >= 0) {
+        // The clock is read every 1024 steps; a step scans one adjacency list
+        if (deadline > 0 && (++steps & 1023) == 0 && wallSeconds() >= deadline) {
+            *expired = true;
+            return found;
+        }
+        int parent = p->parent[level];
+        const int* cand = NULL;
+        int count = h->n;
+        if (parent >= 0) {
+            int img = map[parent];
+            cand = h->adj + h->adjStart[img];
+            count = h->adjStart[img + 1] - h->adjStart[img];
+        }
+
+        int next = -1;
+        while (cursor[level] < count) {
+            int c = cand ? cand[cursor[level]] : cursor[level];
+            cursor[level]++;
+            if (used[c >> 6] & (1ULL << (c & 63))) continue;
+            if (h->degree[c] < p->degree[level]) {
+                STAT_INC(STAT_MATCH_PRUNED);
+                continue;
+            }
+            const uint64_t* row = h->bits + (size_t)c * h->words;
+            bool ok = true;
+            for (int e = p->backStart[level]; e < p->backStart[level + 1]; e++) {
+                int img = map[p->back[e]];
+                if (!(row[img >> 6] & (1ULL << (img & 63)))) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok) {
+                next = c;
+                break;
+            }
+            STAT_INC(STAT_MATCH_PRUNED);
+        }
+
+        if (next < 0) {
+            if (--level >= 0) used[map[level] >> 6] &= ~(1ULL << (map[level] & 63));
+            continue;
+        }
+        STAT_INC(STAT_MATCH_NODES);
+        if (level + 1 == n) {
+            // Complete embedding; keep scanning the last position
+            if (++found == limit) return found;
+            continue;
+        }
+        map[level] = next;
+        used[next >> 6] |= 1ULL << (next & 63);
+        cursor[++level] = 0;
+    }
+    return found;
+}
+
+int preparedContainsWith(const PreparedPattern* p, const PreparedHost* h, MatchScratch* s) {
+    if (!preparedInvariantsAllow(p, h)) return 0;
+    if (reserveScratch(s, p->n > 0 ? p->n : 1, h->words > 0 ? h->words : 1) != 0) return -1;
+    return matchPrepared(p, h, s, 1, 0.0, NULL) > 0 ? 1 : 0;
+}
+
+long long preparedCountWith(const PreparedPattern* p, const PreparedHost* h,
+                            MatchScratch* s, long long limit, double timeLimit,
+                            bool* complete) {
+    if (complete) *complete = true;
+    if (!preparedInvariantsAllow(p, h)) return 0;
+    if (reserveScratch(s, p->n > 0 ? p->n : 1, h->words > 0 ? h->words : 1) != 0) return -1;
+    bool expired = false;
+    double deadline = timeLimit > 0 ? wallSeconds() + timeLimit : 0.0;
+    long long found = matchPrepared(p, h, s, limit, deadline, &expired);
+    if (complete) *complete = !expired && (limit <= 0 || found < limit);
+    return found;
+}
+
+bool preparedContains(const PreparedPattern* p, const PreparedHost* h) {
+    MatchScratch s = {0};
+    int result = preparedContainsWith(p, h, &s);
+    freeMatchScratch(&s);
+    return result == 1;
+}
+
+// --- Database ---
+
+GraphDb* graphDbCreate(void) {
+    GraphDb* db = calloc(1, sizeof(GraphDb));
+    if (!db) return NULL;
+    db->index = featureIndexCreate();
+    if (!db->index) {
+        free(db);
+        return NULL;
+    }
+    return db;
+}
+
+void graphDbFree(GraphDb* db) {
+    if (!db) return;
+    for (int i = 0; i < db->count; i++) freePreparedHost(db->hosts[i]);
+    free(db->hosts);
+    featureIndexFree(db->index);
+    free(db);
+}
+
+static int appendHost(GraphDb* db, PreparedHost* h) {
+    if (db->count == db->capacity) {
+        int capacity = db->capacity ? 2 * db->capacity : 16;
+        PreparedHost** hosts = realloc(db->hosts, capacity * sizeof(PreparedHost*));
+        if (!hosts) return -1;
+        db->hosts = hosts;
+        db->capacity = capacity;
+    }
+    if (featureIndexAdd(db->index, &h->features) != 0) return -1;
+    db->hosts[db->count++] = h;
+    return 0;
+}
+
+int graphDbAdd(GraphDb* db, const Graph* H, const char* name) {
+    PreparedHost* h = prepareHost(H, name);
+    if (!h) return -1;
+    if (appendHost(db, h) != 0) {
+        freePreparedHost(h);
+        return -1;
+    }
+    return 0;
+}
+
+static int writeInts(FILE* f, const int* v, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int32_t x = v[i];
+        if (fwrite(&x, sizeof(x), 1, f) != 1) return -1;
+    }
+    return 0;
+}
+
+static int writeCounts(FILE* f, const GraphFeatures* features) {
+    for (int i = 0; i < FEATURE_COUNT; i++) {
+        int64_t x = features->count[i];
+        if (fwrite(&x, sizeof(x), 1, f) != 1) return -1;
+    }
+    return 0;
+}
+
+static int readCounts(FILE* f, GraphFeatures* features) {
+    for (int i = 0; i < FEATURE_COUNT; i++) {
+        int64_t x;
+        if (fread(&x, sizeof(x), 1, f) != 1 || x < 0) return -1;
+        features->count[i] = x;
+    }
+    return 0;
+}
+
+static int readInts(FILE* f, int* v, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int32_t x;
+        if (fread(&x, sizeof(x), 1, f) != 1) return -1;
+        v[i] = x;
+    }
+    return 0;
+}
+
+int graphDbSave(const GraphDb* db, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    int ok = fwrite(DB_MAGIC, sizeof(DB_MAGIC), 1, f) == 1 && writeInts(f, &db->count, 1) == 0;
+    for (int i = 0; ok && i < db->count; i++) {
+        const PreparedHost* h = db->hosts[i];
+        int header[3] = { (int)strlen(h->name), h->n, h->m };
+        ok = writeInts(f, header, 1) == 0 &&
+             fwrite(h->name, 1, header[0], f) == (size_t)header[0] &&
+             writeInts(f, header + 1, 2) == 0 &&
+             writeInts(f, h->adjStart, h->n + 1) == 0 &&
+             writeInts(f, h->adj, 2 * (size_t)h->m) == 0 &&
+             writeCounts(f, &h->features) == 0;
+    }
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+static PreparedHost* readHost(FILE* f, int version) {
+    int nameLen, nm[2];
+    if (readInts(f, &nameLen, 1) != 0 || nameLen < 0 || nameLen > DB_MAX_NAME) return NULL;
+    PreparedHost* h = calloc(1, sizeof(PreparedHost));
+    if (!h) return NULL;
+    h->name = malloc(nameLen + 1);
+    if (!h->name || fread(h->name, 1, nameLen, f) != (size_t)nameLen ||
+        readInts(f, nm, 2) != 0 || nm[0] < 0 || nm[1] < 0 ||
+        (long long)nm[1] > (long long)nm[0] * (nm[0] - 1) / 2) {
+        freePreparedHost(h);
+        return NULL;
+    }
+    h->name[nameLen] = '\0';
+    h->n = nm[0];
+    h->m = nm[1];
+    h->adjStart = malloc((h->n + 1) * sizeof(int));
+    h->adj = malloc((2 * h->m > 0 ? 2 * h->m : 1) * sizeof(int));
+    if (!h->adjStart || !h->adj ||
+        readInts(f, h->adjStart, h->n + 1) != 0 || readInts(f, h->adj, 2 * (size_t)h->m) != 0) {
+        freePreparedHost(h);
+        return NULL;
+    }
+    // Reject corrupt adjacency before anything indexes with it
+    bool valid = h->adjStart[0] == 0 && h->adjStart[h->n] == 2 * h->m;
+    for (int v = 0; valid && v < h->n; v++) valid = h->adjStart[v] <= h->adjStart[v + 1];
+    for (int e = 0; valid && e < 2 * h->m; e++) valid = h->adj[e] >= 0 && h->adj[e] < h->n;
+    if (!valid || finishHost(h) != 0 ||
+        (version >= 2 ? readCounts(f, &h->features)
+                      : computeGraphFeatures(h->n, h->adjStart, h->adj, h->bits, h->words,
+                                             &h->features)) != 0) {
+        freePreparedHost(h);
+        return NULL;
+    }
+    return h;
+}
+
+GraphDb* graphDbLoad(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char magic[sizeof(DB_MAGIC)];
+    int count;
+    GraphDb* db = NULL;
+    int version = 0;
+    if (fread(magic, sizeof(magic), 1, f) == 1) {
+        if (memcmp(magic, DB_MAGIC, sizeof(magic)) == 0) version = 2;
+        else if (memcmp(magic, DB_MAGIC_V1, sizeof(magic)) == 0) version = 1;
+    }
+    if (version > 0 && readInts(f, &count, 1) == 0 && count >= 0) {
+        db = graphDbCreate();
+        for (int i = 0; db && i < count; i++) {
+            PreparedHost* h = readHost(f, version);
+            if (!h || appendHost(db, h) != 0) {
+                freePreparedHost(h);
+                graphDbFree(db);
+                db = NULL;
+            }
+        }
+    }
+    fclose(f);
+    return db;
+}
+
+int preparedPatternSave(const PreparedPattern* p, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    int nm[2] = { p->n, p->m };
+    int ok = fwrite(PATTERN_MAGIC, sizeof(PATTERN_MAGIC), 1, f) == 1 &&
+             writeInts(f, nm, 2) == 0 &&
+             writeInts(f, p->order, p->n) == 0 &&
+             writeInts(f, p->degree, p->n) == 0 &&
+             writeInts(f, p->parent, p->n) == 0 &&
+             writeInts(f, p->backStart, p->n + 1) == 0 &&
+             writeInts(f, p->back, p->backStart[p->n]) == 0 &&
+             writeCounts(f, &p->features) == 0;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+// The matcher indexes with these arrays unchecked: positions must be a
+// permutation, and parents and back edges must point to earlier positions.
+static bool validPattern(const PreparedPattern* p, bool* seen) {
+    if (p->backStart[0] != 0 || p->backStart[p->n] != p->m) return false;
+    for (int i = 0; i < p->n; i++) {
+        int v = p->order[i];
+        if (v < 0 || v >= p->n || seen[v]) return false;
+        seen[v] = true;
+        if (p->degree[i] < 0 || p->degree[i] >= p->n) return false;
+        if (p->backStart[i] > p->backStart[i + 1]) return false;
+        if (p->parent[i] < -1 || p->parent[i] >= i) return false;
+        if ((p->parent[i] < 0) != (p->backStart[i] == p->backStart[i + 1])) return false;
+        for (int e = p->backStart[i]; e < p->backStart[i + 1]; e++) {
+            if (p->back[e] < 0 || p->back[e] >= i) return false;
+        }
+    }
+    return true;
+}
+
+PreparedPattern* preparedPatternLoad(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char magic[sizeof(PATTERN_MAGIC)];
+    int nm[2];
+    if (fread(magic, sizeof(magic), 1, f) != 1 || memcmp(magic, PATTERN_MAGIC, sizeof(magic)) != 0 ||
+        readInts(f, nm, 2) != 0 || nm[0] < 0 || nm[1] < 0 ||
+        (long long)nm[1] > (long long)nm[0] * (nm[0] - 1) / 2) {
+        fclose(f);
+        return NULL;
+    }
+    PreparedPattern* p = calloc(1, sizeof(PreparedPattern));
+    int n = nm[0];
+    int len = n > 0 ? n : 1;
+    bool* seen = calloc(len, sizeof(bool));
+    if (p) {
+        p->n = n;
+        p->m = nm[1];
+        p->order = malloc(len * sizeof(int));
+        p->degree = malloc(len * sizeof(int));
+        p->parent = malloc(len * sizeof(int));
+        p->backStart = malloc((n + 1) * sizeof(int));
+        p->back = malloc((p->m > 0 ? p->m : 1) * sizeof(int));
+        p->sortedDegrees = malloc(len * sizeof(int));
+    }
+    bool ok = p && seen && p->order && p->degree && p->parent && p->backStart && p->back &&
+              p->sortedDegrees &&
+              readInts(f, p->order, n) == 0 && readInts(f, p->degree, n) == 0 &&
+              readInts(f, p->parent, n) == 0 && readInts(f, p->backStart, n + 1) == 0 &&
+              p->backStart[n] == p->m && readInts(f, p->back, p->m) == 0 &&
+              readCounts(f, &p->features) == 0 && validPattern(p, seen);
+    fclose(f);
+    free(seen);
+    if (!ok) {
+        freePreparedPattern(p);
+        return NULL;
+    }
+    descendingDegrees(p->degree, n, p->sortedDegrees);
+    return p;
+}
+
+// --- Parallel query ---
+
+typedef struct {
+    const GraphDb* db;
+    const PreparedPattern* p;
+    bool* contains;
+    const int* candidates;  // host ids passed by the feature index
+    int candidateCount;
+    int* next;            // shared cursor over candidates
+    int spawned;          // runs on a thread of its own
+    int rejected;
+    int searched;
+    int matches;
+    int failed;
+} QueryWorker;
+
+static void* queryWorker(void* arg) {
+    QueryWorker* w = arg;
+    MatchScratch s = {0};
+    int c;
+    if (w->spawned) traceThreadName("db query worker");
+    double traceStart = traceBegin();
+    // Hosts vary a lot in cost, so they are handed out one at a time
+    while ((c = __atomic_fetch_add(w->next, 1, __ATOMIC_RELAXED)) < w->candidateCount) {
+        int i = w->candidates[c];
+        const PreparedHost* h = w->db->hosts[i];
+        bool found = false;
+        if (!preparedInvariantsAllow(w->p, h)) {
+            w->rejected++;
+        } else if (reserveScratch(&s, w->p->n > 0 ? w->p->n : 1, h->words > 0 ? h->words : 1) != 0) {
+            w->failed = 1;
+        } else {
+            w->searched++;
+            found = matchPrepared(w->p, h, &s, 1, 0.0, NULL) > 0;
+        }
+        w->contains[i] = found;
+        if (found) w->matches++;
+    }
+    traceEndArgs(traceStart, "db query worker", "searched", w->searched, "matches", w->matches);
+    freeMatchScratch(&s);
+    return NULL;
+}
+
+int graphDbQuery(const GraphDb* db, const PreparedPattern* p, int threads,
+                 bool* contains, GraphDbQueryStats* stats) {
+    double t0 = wallSeconds();
+    int* candidates = malloc((db->count > 0 ? db->count : 1) * sizeof(int));
+    if (!candidates) return -1;
+    double traceStart = traceBegin();
+    int candidateCount = featureIndexCandidates(db->index, &p->features, candidates);
+    traceEndArgs(traceStart, "prefilter", "hosts", db->count, "candidates", candidateCount);
+    memset(contains, 0, db->count * sizeof(bool));
+
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > candidateCount) threads = candidateCount > 0 ? candidateCount : 1;
+
+    int next = 0;
+    QueryWorker workers[threads];
+    pthread_t tids[threads];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (QueryWorker){ db, p, contains, candidates, candidateCount, &next, t > 0,
+                                    0, 0, 0, 0 };
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, queryWorker, &workers[t]) != 0) break;
+        started = t;
+    }
+    queryWorker(&workers[0]);
+    for (int t = 1; t <= started; t++) pthread_join(tids[t], NULL);
+
+    free(candidates);
+
+    GraphDbQueryStats total = { db->count, candidateCount, 0, 0, 0, 0.0 };
+    int failed = 0;
+    for (int t = 0; t < threads; t++) {
+        total.rejected += workers[t].rejected;
+        total.searched += workers[t].searched;
+        total.matches += workers[t].matches;
+        failed |= workers[t].failed;
+    }
+    total.elapsed = wallSeconds() - t0;
+    if (stats) *stats = total;
+    return failed ? -1 : 0;
+}
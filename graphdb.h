@@ -0,0 +1,153 @@
+#ifndef GRAPHDB_H
+#define GRAPHDB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+#include "featureindex.h"
+
+/**
+ * =============================================================================
+ * HOST GRAPH DATABASE
+ * =============================================================================
+ * Answers "which hosts contain G as a subgraph?" over a stored set of host
+ * graphs, with the same (non-induced) semantics as isSubgraphIsomorphic.
+ *
+ * Both sides are preprocessed once and reused:
+ *   - a PreparedPattern holds G's matching order (connected, most
+ *     constrained vertices first), the earlier neighbours of each vertex in
+ *     that order and G's sorted degree sequence; one pattern is matched
+ *     against every host of a query;
+ *   - a PreparedHost holds H's degree table, CSR adjacency lists, packed
+ *     adjacency bitsets and sorted degree sequence; it is built when the
+ *     host is added and reused by every later query.
+ *
+ * Every host also carries its subgraph feature counts (see featureindex.h),
+ * and the database keeps a FeatureIndex over them. A query first takes the
+ * candidate hosts from the index, then drops those whose exact counts or
+ * sorted degree sequence do not dominate G's, and only searches the rest.
+ *
+ * Databases are saved to a binary file together with the feature counts;
+ * loading rebuilds the bitsets, degree tables and index from the stored
+ * adjacency lists and counts in O(n^2 / 64 + m) per host, without
+ * reparsing any adjacency matrix.
+ * =============================================================================
+ */
+
+typedef struct {
+    int n;
+    int m;
+    int* order;          // position -> G vertex
+    int* degree;         // degree of the vertex at each position
+    int* parent;         // earlier adjacent position whose image's neighbours are
+                         // the candidates, or -1 (first vertex of a component)
+    int* backStart;      // CSR over positions: earlier adjacent positions
+    int* back;
+    int* sortedDegrees;  // degrees in descending order
+    GraphFeatures features;
+} PreparedPattern;
+
+typedef struct {
+    char* name;
+    int n;
+    int m;
+    int* degree;
+    int* adjStart;       // CSR: neighbours of v are adj[adjStart[v] .. adjStart[v + 1])
+    int* adj;
+    int* sortedDegrees;  // degrees in descending order
+    int words;           // 64-bit words per bitset row
+    uint64_t* bits;      // n x words adjacency bitsets
+    GraphFeatures features;
+} PreparedHost;
+
+typedef struct {
+    int count;
+    int capacity;
+    PreparedHost** hosts;
+    FeatureIndex* index;  // feature thresholds of hosts[0 .. count)
+} GraphDb;
+
+typedef struct {
+    int hosts;            // hosts in the database
+    int candidates;       // hosts passed by the feature index
+    int rejected;         // candidates ruled out by exact feature counts or degrees
+    int searched;         // hosts that needed a backtracking search
+    int matches;          // hosts containing the pattern
+    double elapsed;       // wall-clock seconds
+} GraphDbQueryStats;
+
+PreparedPattern* preparePattern(const Graph* G);
+void freePreparedPattern(PreparedPattern* p);
+
+/**
+ * Writes a prepared pattern to `path` / reads it back, so that a pattern
+ * queried again and again is prepared once. Save returns 0 or -1; load
+ * returns NULL if the file is missing, truncated or not a prepared pattern.
+ */
+int preparedPatternSave(const PreparedPattern* p, const char* path);
+PreparedPattern* preparedPatternLoad(const char* path);
+
+PreparedHost* prepareHost(const Graph* H, const char* name);
+void freePreparedHost(PreparedHost* h);
+
+/**
+ * Cheap necessary condition: false when h's feature counts or sorted degree
+ * sequence do not dominate p's, which proves that p does not embed in h.
+ */
+bool preparedInvariantsAllow(const PreparedPattern* p, const PreparedHost* h);
+
+/**
+ * Subgraph test on prepared graphs. Returns the same verdict as
+ * isSubgraphIsomorphic(G, H) for the graphs they were prepared from.
+ */
+bool preparedContains(const PreparedPattern* p, const PreparedHost* h);
+
+/**
+ * Buffers for preparedContainsWith, grown on demand and kept between calls
+ * so that repeated tests do not allocate. Zero-initialise before first
+ * use; one per thread.
+ */
+typedef struct {
+    int* map;         // position -> host vertex
+    int* cursor;      // position -> next candidate index
+    uint64_t* used;   // host vertices in use
+    int patternCap;
+    int usedWords;
+} MatchScratch;
+
+/** preparedContains on caller-owned scratch: 1 or 0, or -1 if memory runs out. */
+int preparedContainsWith(const PreparedPattern* p, const PreparedHost* h, MatchScratch* s);
+/**
+ * Number of embeddings of p in h (injective maps preserving p's edges),
+ * stopping at `limit` (<= 0 = no limit) or after `timeLimit` seconds
+ * (<= 0 = none). *complete (may be NULL) is false when either stop cut the
+ * count short. -1 if memory runs out.
+ */
+long long preparedCountWith(const PreparedPattern* p, const PreparedHost* h,
+                            MatchScratch* s, long long limit, double timeLimit,
+                            bool* complete);
+void freeMatchScratch(MatchScratch* s);
+
+GraphDb* graphDbCreate(void);
+void graphDbFree(GraphDb* db);
+
+/** Prepares H and appends it under `name`. Returns 0, or -1 if memory runs out. */
+int graphDbAdd(GraphDb* db, const Graph* H, const char* name);
+
+/**
+ * Writes the database to `path` / reads it back. Save returns 0 or -1;
+ * load returns NULL if the file is missing, truncated or not a database.
+ */
+int graphDbSave(const GraphDb* db, const char* path);
+GraphDb* graphDbLoad(const char* path);
+
+/**
+ * Tests p against every host: the feature index picks the candidates, which
+ * are spread over `threads` workers (<= 0 = available processors).
+ * contains[i] receives the verdict for host i. `stats` may be NULL.
+ * Returns 0, or -1 if memory runs out.
+ */
+int graphDbQuery(const GraphDb* db, const PreparedPattern* p, int threads,
+                 bool* contains, GraphDbQueryStats* stats);
+
+#endif // GRAPHDB_H
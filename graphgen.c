@@ -2,6 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include "timing.h"
 
 // Helper function to write adjacency matrix to file
 void write_adjacency_matrix(FILE* f, int** matrix, int n) {
@@ -15,20 +19,26 @@ void write_adjacency_matrix(FILE* f, int** matrix, int n) {
     }
 }
 
-// Allocate n x n matrix initialized to 0
+void free_matrix(int** m, int n) {
+    if (!m) return;
+    for (int i = 0; i < n; i++) free(m[i]);
+    free(m);
+}
+
+// Allocate n x n matrix initialized to 0, or NULL if memory runs out
 int** alloc_matrix(int n) {
-    int** m = malloc(n * sizeof(int*));
+    int** m = malloc((n > 0 ? n : 1) * sizeof(int*));
+    if (!m) return NULL;
     for (int i = 0; i < n; i++) {
         m[i] = calloc(n, sizeof(int));
+        if (!m[i]) {
+            free_matrix(m, i);
+            return NULL;
+        }
     }
     return m;
 }
 
-void free_matrix(int** m, int n) {
-    for (int i = 0; i < n; i++) free(m[i]);
-    free(m);
-}
-
 // Generate path graph and return adjacency matrix
 int** generate_path_matrix(int n) {
     int** matrix = alloc_matrix(n);
@@ -160,6 +170,1118 @@ void generate_combined_input(const char* filename,
     fclose(f);
 }
 
+// =============================================================================
+// STREAMING GENERATORS
+// =============================================================================
+// The single/combined modes build an n x n matrix, which limits them to a
+// few thousand vertices. The stream mode never holds a matrix: edges are
+// produced in chunks and written as they are made, as an edge list, a
+// binary edge list or (for aac) an adjacency matrix assembled from the
+// edges at the end.
+//
+// Families whose edges can be produced row by row (vertex v only emits its
+// edges to lower-numbered vertices) are cut into blocks of about
+// STREAM_BLOCK_COST expected edges. Every block draws from its own random
+// stream, so --threads only changes how fast a file is made, not what is
+// in it: the same seed gives the same file for any thread count.
+// =============================================================================
+
+void print_usage();
+
+#define STREAM_CHUNK_EDGES 65536
+#define STREAM_BLOCK_COST (1 << 18)
+#define REGULAR_SCAN_LIMIT 256
+#define REGULAR_MAX_RESTARTS 1000
+
+enum { FORMAT_EDGES, FORMAT_BINARY, FORMAT_MATRIX };
+
+enum {
+    STREAM_PATH, STREAM_CYCLE, STREAM_COMPLETE, STREAM_GRID, STREAM_TORUS,
+    STREAM_GNP, STREAM_GNM, STREAM_BA, STREAM_REGULAR
+};
+
+typedef struct {
+    int type;
+    uint32_t n;
+    uint32_t rows, cols;         // grid, torus
+    double p;                    // gnp: edge probability
+    unsigned long long m;        // gnm: edge count
+    uint32_t k;                  // ba: edges per new vertex; regular: degree
+} StreamSpec;
+
+static void out_of_memory(void) {
+    printf("Out of memory.\n");
+    exit(1);
+}
+
+// --- 64-bit PRNG: xoshiro256**, seeded through splitmix64 ---
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Independent stream number `stream` of generator `seed`
+static void rng_seed(Rng* r, uint64_t seed, uint64_t stream) {
+    uint64_t x = seed;
+    x = splitmix64(&x) ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) r->s[i] = splitmix64(&x);
+}
+
+static uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t rng_next(Rng* r) {
+    uint64_t* s = r->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+// Uniform in [0, bound) without modulo bias; bound > 0
+static uint64_t rng_below(Rng* r, uint64_t bound) {
+    uint64_t threshold = -bound % bound;
+    for (;;) {
+        uint64_t x = rng_next(r);
+        if (x >= threshold) return x % bound;
+    }
+}
+
+// Uniform in [0, 1)
+static double rng_double(Rng* r) {
+    return (double)(rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+// --- Edge chunks and the output sink ---
+
+typedef struct {
+    uint32_t* pairs;             // 2 * count vertex ids, smaller id first
+    size_t count;
+    size_t cap;
+    char* bytes;                 // the pairs encoded for the edges/binary format
+    size_t len;
+    size_t bytes_cap;
+} EdgeChunk;
+
+static void chunk_add(EdgeChunk* c, uint32_t u, uint32_t v) {
+    if (c->count == c->cap) {
+        c->cap = c->cap ? c->cap * 2 : STREAM_CHUNK_EDGES;
+        c->pairs = realloc(c->pairs, 2 * c->cap * sizeof(uint32_t));
+        if (!c->pairs) out_of_memory();
+    }
+    if (u > v) {
+        uint32_t t = u;
+        u = v;
+        v = t;
+    }
+    c->pairs[2 * c->count] = u;
+    c->pairs[2 * c->count + 1] = v;
+    c->count++;
+}
+
+static void chunk_free(EdgeChunk* c) {
+    free(c->pairs);
+    free(c->bytes);
+    memset(c, 0, sizeof(*c));
+}
+
+static char* put_decimal(char* p, uint32_t x) {
+    char digits[10];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + x % 10);
+        x /= 10;
+    } while (x);
+    while (len) *p++ = digits[--len];
+    return p;
+}
+
+static void put_le32(unsigned char* p, uint32_t x) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(x >> (8 * i));
+}
+
+static void put_le64(unsigned char* p, uint64_t x) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(x >> (8 * i));
+}
+
+// Encodes the pairs of a chunk; the matrix format keeps only the pairs
+static void chunk_encode(EdgeChunk* c, int format) {
+    c->len = 0;
+    if (format == FORMAT_MATRIX || c->count == 0) return;
+    size_t need = c->count * (format == FORMAT_EDGES ? 22 : 8);
+    if (need > c->bytes_cap) {
+        free(c->bytes);
+        c->bytes = malloc(need);
+        if (!c->bytes) out_of_memory();
+        c->bytes_cap = need;
+    }
+    if (format == FORMAT_EDGES) {
+        char* p = c->bytes;
+        for (size_t i = 0; i < c->count; i++) {
+            p = put_decimal(p, c->pairs[2 * i]);
+            *p++ = ' ';
+            p = put_decimal(p, c->pairs[2 * i + 1]);
+            *p++ = '\n';
+        }
+        c->len = (size_t)(p - c->bytes);
+    } else {
+        unsigned char* p = (unsigned char*)c->bytes;
+        for (size_t i = 0; i < 2 * c->count; i++) put_le32(p + 4 * i, c->pairs[i]);
+        c->len = 8 * c->count;
+    }
+}
+
+typedef struct {
+    FILE* f;
+    int format;
+    uint32_t n;
+    unsigned long long edges;
+    EdgeChunk all;               // matrix format: every edge, written at the end
+} EdgeSink;
+
+// Width of the edge count in the edges header, patched in at the end
+#define EDGES_COUNT_WIDTH 20
+
+static void sink_begin(EdgeSink* s) {
+    if (s->format == FORMAT_EDGES) {
+        fprintf(s->f, "%u %*s\n", s->n, EDGES_COUNT_WIDTH, "");
+    } else if (s->format == FORMAT_BINARY) {
+        unsigned char header[24];
+        memcpy(header, "AACEDGE1", 8);
+        put_le64(header + 8, s->n);
+        put_le64(header + 16, 0);
+        fwrite(header, 1, sizeof(header), s->f);
+    }
+}
+
+// Writes an encoded chunk and empties it
+static void sink_write(EdgeSink* s, EdgeChunk* c) {
+    s->edges += c->count;
+    if (s->format == FORMAT_MATRIX) {
+        for (size_t i = 0; i < c->count; i++) chunk_add(&s->all, c->pairs[2 * i], c->pairs[2 * i + 1]);
+    } else if (c->len > 0 && fwrite(c->bytes, 1, c->len, s->f) != c->len) {
+        printf("Error writing output file.\n");
+        exit(1);
+    }
+    c->count = 0;
+    c->len = 0;
+}
+
+// Adds one edge from a sequential generator, writing full chunks
+static void sink_emit(EdgeSink* s, EdgeChunk* c, uint32_t u, uint32_t v) {
+    chunk_add(c, u, v);
+    if (c->count >= STREAM_CHUNK_EDGES) {
+        chunk_encode(c, s->format);
+        sink_write(s, c);
+    }
+}
+
+static void sink_flush(EdgeSink* s, EdgeChunk* c) {
+    chunk_encode(c, s->format);
+    sink_write(s, c);
+}
+
+// Matrix rows in the single/combined format, built from the collected edges
+static void write_matrix_from_edges(FILE* f, uint32_t n, const EdgeChunk* all) {
+    size_t* start = calloc((size_t)n + 1, sizeof(size_t));
+    uint32_t* nbr = malloc((2 * all->count + 1) * sizeof(uint32_t));
+    char* row = malloc(2 * (size_t)n);
+    if (!start || !nbr || !row) out_of_memory();
+
+    for (size_t i = 0; i < 2 * all->count; i++) start[all->pairs[i] + 1]++;
+    for (uint32_t v = 0; v < n; v++) start[v + 1] += start[v];
+    for (size_t i = 0; i < all->count; i++) {
+        uint32_t u = all->pairs[2 * i], v = all->pairs[2 * i + 1];
+        nbr[start[u]++] = v;
+        nbr[start[v]++] = u;
+    }
+    // start[v] now holds the end of v's neighbours, i.e. the start of v + 1's
+    for (uint32_t v = n; v > 0; v--) start[v] = start[v - 1];
+    start[0] = 0;
+
+    for (size_t j = 0; j < n; j++) {
+        row[2 * j] = '0';
+        row[2 * j + 1] = (j + 1 == n) ? '\n' : ' ';
+    }
+    fprintf(f, "%u\n", n);
+    for (uint32_t v = 0; v < n; v++) {
+        for (size_t i = start[v]; i < start[v + 1]; i++) row[2 * (size_t)nbr[i]] = '1';
+        fwrite(row, 1, 2 * (size_t)n, f);
+        for (size_t i = start[v]; i < start[v + 1]; i++) row[2 * (size_t)nbr[i]] = '0';
+    }
+    free(start);
+    free(nbr);
+    free(row);
+}
+
+static void sink_finish(EdgeSink* s) {
+    if (s->format == FORMAT_MATRIX) {
+        write_matrix_from_edges(s->f, s->n, &s->all);
+        chunk_free(&s->all);
+        return;
+    }
+    // The edge count is only known now: patch it into the header
+    fflush(s->f);
+    if (fseek(s->f, 0, SEEK_SET) != 0) {
+        printf("Error writing output file.\n");
+        exit(1);
+    }
+    if (s->format == FORMAT_EDGES) {
+        fprintf(s->f, "%u %*llu\n", s->n, EDGES_COUNT_WIDTH, s->edges);
+    } else {
+        unsigned char count[8];
+        put_le64(count, s->edges);
+        fseek(s->f, 16, SEEK_SET);
+        fwrite(count, 1, sizeof(count), s->f);
+    }
+}
+
+// --- Row families: path, cycle, complete, grid, torus, gnp ---
+
+// Emits the edges (w, v) with w < v for the vertices v in [first, end)
+static void generate_rows(const StreamSpec* spec, Rng* rng, uint32_t first, uint32_t end, EdgeChunk* c) {
+    uint32_t n = spec->n;
+    switch (spec->type) {
+    case STREAM_PATH:
+    case STREAM_CYCLE:
+        for (uint32_t v = first; v < end; v++) {
+            if (v > 0) chunk_add(c, v - 1, v);
+            if (spec->type == STREAM_CYCLE && v == n - 1 && n > 2) chunk_add(c, 0, v);
+        }
+        break;
+    case STREAM_COMPLETE:
+        for (uint32_t v = first; v < end; v++) {
+            for (uint32_t w = 0; w < v; w++) chunk_add(c, w, v);
+        }
+        break;
+    case STREAM_GRID:
+    case STREAM_TORUS:
+        for (uint32_t v = first; v < end; v++) {
+            uint32_t r = v / spec->cols, col = v % spec->cols;
+            if (col > 0) chunk_add(c, v - 1, v);
+            if (r > 0) chunk_add(c, v - spec->cols, v);
+            if (spec->type == STREAM_TORUS) {
+                if (col == spec->cols - 1 && spec->cols > 2) chunk_add(c, v - col, v);
+                if (r == spec->rows - 1 && spec->rows > 2) chunk_add(c, col, v);
+            }
+        }
+        break;
+    case STREAM_GNP: {
+        if (spec->p <= 0.0) break;
+        if (spec->p >= 1.0) {
+            StreamSpec complete = *spec;
+            complete.type = STREAM_COMPLETE;
+            generate_rows(&complete, rng, first, end, c);
+            break;
+        }
+        // Geometric skipping (Batagelj-Brandes): jump straight to the next
+        // pair that gets an edge instead of flipping a coin for every pair.
+        // Skips are memoryless, so a block can start fresh at its first row.
+        double log_q = log1p(-spec->p);
+        long long v = first, w = -1;
+        while (v < end) {
+            double skip = floor(log1p(-rng_double(rng)) / log_q);
+            if (skip > 4e18) break;  // beyond every remaining pair
+            w += 1 + (long long)skip;
+            while (w >= v && v < end) {
+                w -= v;
+                v++;
+            }
+            if (v < end) chunk_add(c, (uint32_t)w, (uint32_t)v);
+        }
+        break;
+    }
+    }
+}
+
+// First vertex after the block that starts at `first`
+static uint32_t row_block_end(const StreamSpec* spec, uint32_t first) {
+    double cost = 0.0;
+    uint32_t v = first;
+    while (v < spec->n && cost < STREAM_BLOCK_COST) {
+        if (spec->type == STREAM_COMPLETE) cost += (double)v + 1.0;
+        else if (spec->type == STREAM_GNP) cost += (double)v * spec->p + 1.0;
+        else cost += 3.0;
+        v++;
+    }
+    return v;
+}
+
+typedef struct {
+    const StreamSpec* spec;
+    int format;
+    uint64_t seed;
+    uint64_t index;              // block number, also its random stream
+    uint32_t first, end;
+    int spawned;
+    EdgeChunk chunk;
+} RowBlock;
+
+static void* row_block_worker(void* arg) {
+    RowBlock* b = arg;
+    Rng rng;
+    rng_seed(&rng, b->seed, b->index);
+    generate_rows(b->spec, &rng, b->first, b->end, &b->chunk);
+    chunk_encode(&b->chunk, b->format);
+    return NULL;
+}
+
+// Generates blocks `threads` at a time and writes each wave in block order
+static void stream_rows(const StreamSpec* spec, EdgeSink* sink, uint64_t seed, int threads) {
+    RowBlock* blocks = calloc(threads, sizeof(RowBlock));
+    pthread_t* tids = malloc(threads * sizeof(pthread_t));
+    if (!blocks || !tids) out_of_memory();
+
+    uint32_t next = 0;
+    uint64_t index = 0;
+    while (next < spec->n) {
+        int count = 0;
+        while (count < threads && next < spec->n) {
+            RowBlock* b = &blocks[count++];
+            b->spec = spec;
+            b->format = sink->format;
+            b->seed = seed;
+            b->index = index++;
+            b->first = next;
+            b->end = row_block_end(spec, next);
+            next = b->end;
+        }
+        for (int i = 1; i < count; i++) {
+            blocks[i].spawned = pthread_create(&tids[i], NULL, row_block_worker, &blocks[i]) == 0;
+            if (!blocks[i].spawned) row_block_worker(&blocks[i]);
+        }
+        row_block_worker(&blocks[0]);
+        for (int i = 1; i < count; i++) {
+            if (blocks[i].spawned) pthread_join(tids[i], NULL);
+        }
+        for (int i = 0; i < count; i++) sink_write(sink, &blocks[i].chunk);
+    }
+
+    for (int i = 0; i < threads; i++) chunk_free(&blocks[i].chunk);
+    free(blocks);
+    free(tids);
+}
+
+// --- Sequential families: gnm, ba, regular ---
+
+// Open-addressing set of 64-bit keys (stored + 1, so 0 marks a free slot)
+typedef struct {
+    uint64_t* slots;
+    size_t mask;
+} KeySet;
+
+static void keyset_init(KeySet* s, unsigned long long expected) {
+    size_t cap = 16;
+    while (cap < 2 * expected) cap *= 2;
+    s->slots = calloc(cap, sizeof(uint64_t));
+    if (!s->slots) out_of_memory();
+    s->mask = cap - 1;
+}
+
+static size_t keyset_slot(const KeySet* s, uint64_t key) {
+    uint64_t h = key;
+    size_t i = (size_t)splitmix64(&h) & s->mask;
+    while (s->slots[i] && s->slots[i] != key + 1) i = (i + 1) & s->mask;
+    return i;
+}
+
+static int keyset_contains(const KeySet* s, uint64_t key) {
+    return s->slots[keyset_slot(s, key)] != 0;
+}
+
+// Returns 1 if the key was added, 0 if it was already present
+static int keyset_insert(KeySet* s, uint64_t key) {
+    size_t i = keyset_slot(s, key);
+    if (s->slots[i]) return 0;
+    s->slots[i] = key + 1;
+    return 1;
+}
+
+// Pair number i in the order (0,1), (0,2), (1,2), (0,3), ...
+static void pair_from_index(uint64_t i, uint32_t* w, uint32_t* v) {
+    uint64_t r = (uint64_t)((1.0 + sqrt(1.0 + 8.0 * (double)i)) / 2.0);
+    while (r * (r - 1) / 2 > i) r--;
+    while (r * (r + 1) / 2 <= i) r++;
+    *v = (uint32_t)r;
+    *w = (uint32_t)(i - r * (r - 1) / 2);
+}
+
+// G(n, m): m distinct pairs by Floyd's sampling, O(m) time and memory
+static void stream_gnm(const StreamSpec* spec, Rng* rng, EdgeSink* sink, EdgeChunk* c) {
+    uint64_t total = (uint64_t)spec->n * (spec->n - 1) / 2;
+    uint64_t m = spec->m;
+    uint32_t w, v;
+    KeySet chosen;
+    if (2 * m <= total) {
+        // Each step adds exactly one new pair, so it can be written at once
+        keyset_init(&chosen, m);
+        for (uint64_t j = total - m; j < total; j++) {
+            uint64_t t = rng_below(rng, j + 1);
+            uint64_t pick = keyset_insert(&chosen, t) ? t : j;
+            if (pick == j) keyset_insert(&chosen, j);
+            pair_from_index(pick, &w, &v);
+            sink_emit(sink, c, w, v);
+        }
+    } else {
+        // Dense: sample the total - m pairs left out and write the rest
+        uint64_t skipped = total - m;
+        keyset_init(&chosen, skipped);
+        for (uint64_t j = total - skipped; j < total; j++) {
+            uint64_t t = rng_below(rng, j + 1);
+            if (!keyset_insert(&chosen, t)) keyset_insert(&chosen, j);
+        }
+        for (uint64_t i = 0; i < total; i++) {
+            if (keyset_contains(&chosen, i)) continue;
+            pair_from_index(i, &w, &v);
+            sink_emit(sink, c, w, v);
+        }
+    }
+    free(chosen.slots);
+}
+
+// Barabasi-Albert preferential attachment: a complete graph on the first
+// k + 1 vertices, then each new vertex links to k distinct earlier ones,
+// picked with probability proportional to degree by drawing a random
+// endpoint of the edges made so far.
+static void stream_barabasi_albert(const StreamSpec* spec, Rng* rng, EdgeSink* sink, EdgeChunk* c) {
+    uint32_t n = spec->n, k = spec->k;
+    uint64_t m = (uint64_t)k * (k + 1) / 2 + (uint64_t)(n - k - 1) * k;
+    uint32_t* ends = malloc(2 * m * sizeof(uint32_t));
+    uint32_t* targets = malloc(k * sizeof(uint32_t));
+    if (!ends || !targets) out_of_memory();
+    size_t len = 0;
+
+    for (uint32_t v = 1; v <= k; v++) {
+        for (uint32_t w = 0; w < v; w++) {
+            sink_emit(sink, c, w, v);
+            ends[len++] = w;
+            ends[len++] = v;
+        }
+    }
+    for (uint32_t v = k + 1; v < n; v++) {
+        uint32_t chosen = 0;
+        while (chosen < k) {
+            uint32_t t = ends[rng_below(rng, len)];
+            uint32_t i = 0;
+            while (i < chosen && targets[i] != t) i++;
+            if (i == chosen) targets[chosen++] = t;
+        }
+        for (uint32_t i = 0; i < k; i++) {
+            sink_emit(sink, c, targets[i], v);
+            ends[len++] = targets[i];
+            ends[len++] = v;
+        }
+    }
+    free(ends);
+    free(targets);
+}
+
+// Random d-regular graph (Steger-Wormald): pair random free endpoint
+// copies while the pair is neither a loop nor a repeated edge, restarting
+// when no such pair is left. The edges are kept until an attempt succeeds.
+// Pairing gets stuck when d is close to n, so for d > (n-1)/2 the
+// complement, which is (n-1-d)-regular, is paired and its gaps written.
+static void stream_regular(const StreamSpec* spec, Rng* rng, EdgeSink* sink, EdgeChunk* c) {
+    uint32_t n = spec->n, d = spec->k;
+    int complement = d > (n - 1) / 2;
+    if (complement) d = n - 1 - d;
+    size_t total = (size_t)n * d;
+    uint32_t* points = malloc((total + 1) * sizeof(uint32_t));
+    if (!points) out_of_memory();
+    KeySet edges;
+    keyset_init(&edges, total / 2);
+
+    for (int attempt = 0; attempt < REGULAR_MAX_RESTARTS; attempt++) {
+        for (size_t i = 0; i < total; i++) points[i] = (uint32_t)(i / d);
+        memset(edges.slots, 0, (edges.mask + 1) * sizeof(uint64_t));
+        c->count = 0;
+        size_t free_points = total;
+        size_t failures = 0;
+        int stuck = 0;
+
+        while (free_points > 0 && !stuck) {
+            size_t i = rng_below(rng, free_points), j = rng_below(rng, free_points);
+            uint32_t a = points[i], b = points[j];
+            uint64_t key = a < b ? ((uint64_t)a << 32 | b) : ((uint64_t)b << 32 | a);
+            if (a == b || keyset_contains(&edges, key)) {
+                if (++failures < 64) continue;
+                if (free_points > REGULAR_SCAN_LIMIT) {
+                    stuck = failures >= 64 + free_points;
+                    continue;
+                }
+                // Few points left: pick uniformly among the pairs still allowed
+                size_t seen = 0;
+                for (size_t x = 0; x < free_points; x++) {
+                    for (size_t y = x + 1; y < free_points; y++) {
+                        uint32_t p = points[x], q = points[y];
+                        uint64_t pq = p < q ? ((uint64_t)p << 32 | q) : ((uint64_t)q << 32 | p);
+                        if (p == q || keyset_contains(&edges, pq)) continue;
+                        if (rng_below(rng, ++seen) == 0) {
+                            i = x;
+                            j = y;
+                            key = pq;
+                        }
+                    }
+                }
+                if (seen == 0) {
+                    stuck = 1;
+                    continue;
+                }
+                a = points[i];
+                b = points[j];
+            }
+            failures = 0;
+            keyset_insert(&edges, key);
+            chunk_add(c, a, b);
+            size_t hi = i > j ? i : j, lo = i > j ? j : i;
+            points[hi] = points[--free_points];
+            points[lo] = points[--free_points];
+        }
+        if (!stuck) {
+            if (complement) {
+                c->count = 0;
+                for (uint32_t v = 1; v < n; v++) {
+                    for (uint32_t w = 0; w < v; w++) {
+                        if (!keyset_contains(&edges, (uint64_t)w << 32 | v)) sink_emit(sink, c, w, v);
+                    }
+                }
+            }
+            free(points);
+            free(edges.slots);
+            sink_flush(sink, c);
+            return;
+        }
+    }
+    printf("Could not build a %u-regular graph on %u vertices; try a smaller degree.\n", spec->k, n);
+    exit(1);
+}
+
+// Generates every edge of `spec` into the sink
+static void stream_generate(const StreamSpec* spec, EdgeSink* sink, EdgeChunk* c,
+                            uint64_t seed, int threads) {
+    if (spec->type == STREAM_GNM || spec->type == STREAM_BA || spec->type == STREAM_REGULAR) {
+        Rng rng;
+        rng_seed(&rng, seed, 0);
+        if (spec->type == STREAM_GNM) stream_gnm(spec, &rng, sink, c);
+        else if (spec->type == STREAM_BA) stream_barabasi_albert(spec, &rng, sink, c);
+        else stream_regular(spec, &rng, sink, c);
+        sink_flush(sink, c);
+    } else {
+        stream_rows(spec, sink, seed, threads);
+    }
+}
+
+// --- Command line ---
+
+static const struct {
+    const char* name;
+    int type;
+} STREAM_TYPES[] = {
+    { "path",     STREAM_PATH },
+    { "cycle",    STREAM_CYCLE },
+    { "complete", STREAM_COMPLETE },
+    { "grid",     STREAM_GRID },
+    { "torus",    STREAM_TORUS },
+    { "gnp",      STREAM_GNP },
+    { "gnm",      STREAM_GNM },
+    { "ba",       STREAM_BA },
+    { "regular",  STREAM_REGULAR },
+};
+
+#define STREAM_TYPE_COUNT (int)(sizeof(STREAM_TYPES) / sizeof(STREAM_TYPES[0]))
+
+// Whole decimal number in [min, max]
+static int parse_count(const char* s, unsigned long long min, unsigned long long max,
+                       unsigned long long* out) {
+    char* end;
+    if (!s || *s == '-') return 0;
+    unsigned long long x = strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || x < min || x > max) return 0;
+    *out = x;
+    return 1;
+}
+
+// Reads a stream type `name` and its parameters from argv[start...];
+// returns how many parameters were used
+static int parse_stream_spec(int argc, char** argv, const char* name, int start, StreamSpec* spec) {
+    unsigned long long a, b;
+    const unsigned long long max_n = INT32_MAX;
+    int type = -1;
+    for (int i = 0; i < STREAM_TYPE_COUNT; i++) {
+        if (strcmp(name, STREAM_TYPES[i].name) == 0) type = STREAM_TYPES[i].type;
+    }
+    if (type < 0) {
+        printf("Unknown graph type: %s\n", name);
+        return -1;
+    }
+    memset(spec, 0, sizeof(*spec));
+    spec->type = type;
+
+    if (type == STREAM_GRID || type == STREAM_TORUS) {
+        if (start + 1 >= argc || !parse_count(argv[start], 1, max_n, &a) ||
+            !parse_count(argv[start + 1], 1, max_n, &b) || a * b < 2 || a * b > max_n) {
+            printf("%s needs <rows> <cols> with 2 <= rows*cols <= %llu\n", name, max_n);
+            return -1;
+        }
+        spec->rows = (uint32_t)a;
+        spec->cols = (uint32_t)b;
+        spec->n = (uint32_t)(a * b);
+        return 2;
+    }
+
+    if (start >= argc || !parse_count(argv[start], 2, max_n, &a)) {
+        printf("n must be between 2 and %llu\n", max_n);
+        return -1;
+    }
+    spec->n = (uint32_t)a;
+    unsigned long long pairs = a * (a - 1) / 2;
+    if (type == STREAM_PATH || type == STREAM_CYCLE || type == STREAM_COMPLETE) return 1;
+
+    if (start + 1 >= argc) {
+        printf("%s requires another parameter\n", name);
+        return -1;
+    }
+    const char* arg = argv[start + 1];
+    if (type == STREAM_GNP) {
+        char* end;
+        spec->p = strtod(arg, &end);
+        if (end == arg || *end != '\0' || !(spec->p >= 0.0 && spec->p <= 1.0)) {
+            printf("p must be between 0 and 1\n");
+            return -1;
+        }
+    } else if (type == STREAM_GNM) {
+        if (!parse_count(arg, 0, pairs, &spec->m)) {
+            printf("m must be between 0 and n(n-1)/2 = %llu\n", pairs);
+            return -1;
+        }
+    } else if (type == STREAM_BA) {
+        if (!parse_count(arg, 1, a - 1, &b)) {
+            printf("k must be between 1 and n-1\n");
+            return -1;
+        }
+        spec->k = (uint32_t)b;
+    } else if (type == STREAM_REGULAR) {
+        if (!parse_count(arg, 1, a - 1, &b) || (a * b) % 2 != 0) {
+            printf("d must be between 1 and n-1, with n*d even\n");
+            return -1;
+        }
+        spec->k = (uint32_t)b;
+    }
+    return 2;
+}
+
+static const char* format_name(int format) {
+    return format == FORMAT_EDGES ? "edges" : format == FORMAT_BINARY ? "binary" : "matrix";
+}
+
+// ./graphgen stream <type> <output_file> <params...> [--format f] [--seed s] [--threads t]
+int run_stream(int argc, char** argv) {
+    if (argc < 5) {
+        print_usage();
+        return 1;
+    }
+    const char* filename = argv[3];
+    StreamSpec spec;
+    int consumed = parse_stream_spec(argc, argv, argv[2], 4, &spec);
+    if (consumed < 0) return 1;
+
+    int format = FORMAT_EDGES;
+    int threads = 1;
+    const char* env_seed = getenv("GRAPHGEN_SEED");
+    uint64_t seed = env_seed ? strtoull(env_seed, NULL, 10) : (uint64_t)time(NULL);
+    for (int i = 4 + consumed; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* f = argv[++i];
+            if (strcmp(f, "edges") == 0) format = FORMAT_EDGES;
+            else if (strcmp(f, "binary") == 0) format = FORMAT_BINARY;
+            else if (strcmp(f, "matrix") == 0) format = FORMAT_MATRIX;
+            else {
+                printf("Unknown format: %s (edges, binary or matrix)\n", f);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1 || threads > 256) {
+                printf("--threads must be between 1 and 256\n");
+                return 1;
+            }
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    FILE* f = fopen(filename, format == FORMAT_BINARY ? "wb" : "w");
+    if (!f) {
+        printf("Error opening file.\n");
+        return 1;
+    }
+    double started = wallSeconds();
+    EdgeSink sink = { f, format, spec.n, 0, { 0 } };
+    EdgeChunk chunk = { 0 };
+    sink_begin(&sink);
+    stream_generate(&spec, &sink, &chunk, seed, threads);
+    sink_finish(&sink);
+    chunk_free(&chunk);
+    if (fclose(f) != 0) {
+        printf("Error writing output file.\n");
+        return 1;
+    }
+
+    printf("\n");
+    printf("[OK] Generated streamed graph successfully!\n");
+    printf("\n");
+    printf("  Type     : %s\n", argv[2]);
+    printf("  Vertices : %u\n", spec.n);
+    printf("  Edges    : %llu\n", sink.edges);
+    printf("  Format   : %s\n", format_name(format));
+    printf("  Seed     : %llu\n", (unsigned long long)seed);
+    printf("  Threads  : %d\n", threads);
+    printf("  Time     : %.2f s\n", wallSeconds() - started);
+    printf("  Output   : %s\n", filename);
+    printf("\n");
+    return 0;
+}
+
+// =============================================================================
+// PLANTED INSTANCES
+// =============================================================================
+// A planted instance hides a copy of G in a host H and then damages the
+// copy: some image vertices are deleted from H together with all their
+// edges, and some image edges between the remaining ones are removed.
+// Repairing the damage extends H to a graph containing G, so the repair
+// cost is an upper bound on the minimal extension cost. Every instance
+// also has the lower bound
+//
+//     max(0, n_G - n_H) + max(0, m_G - m_H)
+//
+// since H' needs n_G vertices and m_G edges. Without background edges
+// the two bounds meet, and the optimal cost is known by construction.
+// =============================================================================
+
+// Planted instances are built as dense matrices (two of N x N ints, about
+// 800 MB at the cap); larger graphs are what the stream modes are for.
+#define PLANTED_MAX_HOST 10000
+
+typedef struct {
+    StreamSpec pattern;
+    uint32_t host;               // host vertices before the damage, >= n_G
+    double noise;                // probability of a background edge in H
+    uint32_t remove_vertices;
+    unsigned long long remove_edges;
+} PlantedSpec;
+
+typedef struct {
+    int n_g, m_g, n_h, m_h;
+    int removed_vertices;
+    int removed_edges;
+    int* mapping;                // repair: G vertex -> H vertex, -1 for a new vertex
+    int new_vertices;
+    int new_edges;
+    int lower_bound;
+} PlantedTruth;
+
+// Builds instance `index` of a corpus, writes G and H to `out` and fills `t`.
+// Returns -1 if memory runs out.
+static int make_planted(const PlantedSpec* ps, uint64_t seed, uint64_t index, FILE* out, PlantedTruth* t) {
+    Rng rng;
+    rng_seed(&rng, seed, index);
+
+    // Pattern G from the stream generators, kept as an edge list
+    EdgeSink sink = { NULL, FORMAT_MATRIX, ps->pattern.n, 0, { 0 } };
+    EdgeChunk chunk = { 0 };
+    stream_generate(&ps->pattern, &sink, &chunk, rng_next(&rng), 1);
+    chunk_free(&chunk);
+    const uint32_t* edges = sink.all.pairs;
+    int ng = (int)ps->pattern.n, mg = (int)sink.all.count;
+    int N = (int)ps->host;
+
+    int* order = malloc(N * sizeof(int));
+    int** host = alloc_matrix(N);
+    int* removed = calloc(ng, sizeof(int));
+    int* pick = malloc(((ng > mg ? ng : mg) + 1) * sizeof(int));
+    int* label = malloc(N * sizeof(int));
+    if (!order || !host || !removed || !pick || !label) {
+        free(order);
+        free_matrix(host, N);
+        free(removed);
+        free(pick);
+        free(label);
+        chunk_free(&sink.all);
+        return -1;
+    }
+
+    // Random image of G in a host of N vertices, plus background edges
+    for (int i = 0; i < N; i++) order[i] = i;
+    for (int i = 0; i < ng; i++) {
+        int j = i + (int)rng_below(&rng, (uint64_t)(N - i));
+        int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+    int* image = order;          // image[u] for the G vertices u < ng
+    if (ps->noise > 0.0) {
+        for (int i = 0; i < N; i++) {
+            for (int j = i + 1; j < N; j++) {
+                if (rng_double(&rng) < ps->noise) host[i][j] = host[j][i] = 1;
+            }
+        }
+    }
+    for (int e = 0; e < mg; e++) {
+        int a = image[edges[2 * e]], b = image[edges[2 * e + 1]];
+        host[a][b] = host[b][a] = 1;
+    }
+
+    // Damage: delete image vertices, then image edges between survivors
+    for (int i = 0; i < ng; i++) pick[i] = i;
+    for (int i = 0; i < (int)ps->remove_vertices; i++) {
+        int j = i + (int)rng_below(&rng, (uint64_t)(ng - i));
+        int tmp = pick[i]; pick[i] = pick[j]; pick[j] = tmp;
+        removed[pick[i]] = 1;
+    }
+    int candidates = 0;
+    for (int e = 0; e < mg; e++) {
+        if (!removed[edges[2 * e]] && !removed[edges[2 * e + 1]]) pick[candidates++] = e;
+    }
+    int cut = ps->remove_edges < (unsigned long long)candidates ? (int)ps->remove_edges : candidates;
+    for (int i = 0; i < cut; i++) {
+        int j = i + (int)rng_below(&rng, (uint64_t)(candidates - i));
+        int tmp = pick[i]; pick[i] = pick[j]; pick[j] = tmp;
+        int a = image[edges[2 * pick[i]]], b = image[edges[2 * pick[i] + 1]];
+        host[a][b] = host[b][a] = 0;
+    }
+
+    // H: the host without the deleted vertices, relabelled in order
+    for (int x = 0; x < N; x++) label[x] = 0;
+    for (int u = 0; u < ng; u++) {
+        if (removed[u]) label[image[u]] = -1;
+    }
+    int nh = 0;
+    for (int x = 0; x < N; x++) {
+        if (label[x] >= 0) label[x] = nh++;
+    }
+    int** H = alloc_matrix(nh);
+    int** G = alloc_matrix(ng);
+    int* mapping = malloc(ng * sizeof(int));
+    int* used = calloc(nh, sizeof(int));
+    if (!H || !G || !mapping || !used) {
+        free_matrix(H, nh);
+        free_matrix(G, ng);
+        free(mapping);
+        free(used);
+        free_matrix(host, N);
+        free(order);
+        free(removed);
+        free(pick);
+        free(label);
+        chunk_free(&sink.all);
+        return -1;
+    }
+    int mh = 0;
+    for (int x = 0; x < N; x++) {
+        for (int y = 0; y < N; y++) {
+            if (label[x] < 0 || label[y] < 0 || !host[x][y]) continue;
+            H[label[x]][label[y]] = 1;
+            if (x < y) mh++;
+        }
+    }
+
+    for (int e = 0; e < mg; e++) {
+        G[edges[2 * e]][edges[2 * e + 1]] = G[edges[2 * e + 1]][edges[2 * e]] = 1;
+    }
+
+    // Repair: survivors keep their image; each deleted vertex takes the
+    // unused H vertex that already has the most of its edges, or a new one
+    for (int u = 0; u < ng; u++) {
+        mapping[u] = removed[u] ? -1 : label[image[u]];
+        if (mapping[u] >= 0) used[mapping[u]] = 1;
+    }
+    for (int u = 0; u < ng; u++) {
+        if (!removed[u]) continue;
+        int best = -1, best_gain = -1;
+        for (int s = 0; s < nh; s++) {
+            if (used[s]) continue;
+            int gain = 0;
+            for (int w = 0; w < ng; w++) {
+                if (G[u][w] && mapping[w] >= 0 && H[s][mapping[w]]) gain++;
+            }
+            if (gain > best_gain) {
+                best = s;
+                best_gain = gain;
+            }
+        }
+        if (best >= 0) {
+            mapping[u] = best;
+            used[best] = 1;
+        }
+    }
+    t->new_vertices = 0;
+    for (int u = 0; u < ng; u++) {
+        if (mapping[u] < 0) t->new_vertices++;
+    }
+    t->new_edges = 0;
+    for (int e = 0; e < mg; e++) {
+        int a = mapping[edges[2 * e]], b = mapping[edges[2 * e + 1]];
+        if (a < 0 || b < 0 || !H[a][b]) t->new_edges++;
+    }
+
+    t->n_g = ng;
+    t->m_g = mg;
+    t->n_h = nh;
+    t->m_h = mh;
+    t->removed_vertices = (int)ps->remove_vertices;
+    t->removed_edges = cut;
+    t->mapping = mapping;
+    t->lower_bound = (ng > nh ? ng - nh : 0) + (mg > mh ? mg - mh : 0);
+
+    write_adjacency_matrix(out, G, ng);
+    write_adjacency_matrix(out, H, nh);
+
+    free_matrix(G, ng);
+    free_matrix(H, nh);
+    free_matrix(host, N);
+    free(order);
+    free(removed);
+    free(pick);
+    free(label);
+    free(used);
+    chunk_free(&sink.all);
+    return 0;
+}
+
+static void write_planted_truth(FILE* f, int job, const char* input, uint64_t seed, const PlantedTruth* t) {
+    int cost = t->new_vertices + t->new_edges;
+    fprintf(f, "{\"job\":%d,\"input\":\"%s\",\"seed\":%llu,\"n_g\":%d,\"m_g\":%d,\"n_h\":%d,\"m_h\":%d,"
+               "\"removed_vertices\":%d,\"removed_edges\":%d,\"upper_bound\":%d,\"new_vertices\":%d,"
+               "\"new_edges\":%d,\"lower_bound\":%d,\"optimal\":%s,\"mapping\":[",
+            job, input, (unsigned long long)seed, t->n_g, t->m_g, t->n_h, t->m_h,
+            t->removed_vertices, t->removed_edges, cost, t->new_vertices, t->new_edges,
+            t->lower_bound, cost == t->lower_bound ? "true" : "false");
+    for (int u = 0; u < t->n_g; u++) fprintf(f, "%s%d", u > 0 ? "," : "", t->mapping[u]);
+    fprintf(f, "]}\n");
+}
+
+// ./graphgen planted <prefix> <type> <params...> [options]
+int run_planted(int argc, char** argv) {
+    if (argc < 5) {
+        print_usage();
+        return 1;
+    }
+    const char* prefix = argv[2];
+    PlantedSpec ps;
+    memset(&ps, 0, sizeof(ps));
+    int consumed = parse_stream_spec(argc, argv, argv[3], 4, &ps.pattern);
+    if (consumed < 0) return 1;
+    ps.host = ps.pattern.n;
+
+    unsigned long long value, count = 1;
+    const char* env_seed = getenv("GRAPHGEN_SEED");
+    uint64_t seed = env_seed ? strtoull(env_seed, NULL, 10) : (uint64_t)time(NULL);
+    for (int i = 4 + consumed; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* arg = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(opt, "--host") == 0 && parse_count(arg, 2, INT32_MAX, &value)) {
+            ps.host = (uint32_t)value;
+        } else if (strcmp(opt, "--noise") == 0 && arg) {
+            char* end;
+            ps.noise = strtod(arg, &end);
+            if (end == arg || *end != '\0' || !(ps.noise >= 0.0 && ps.noise <= 1.0)) {
+                printf("--noise must be between 0 and 1\n");
+                return 1;
+            }
+        } else if (strcmp(opt, "--remove-vertices") == 0 && parse_count(arg, 0, INT32_MAX, &value)) {
+            ps.remove_vertices = (uint32_t)value;
+        } else if (strcmp(opt, "--remove-edges") == 0 && parse_count(arg, 0, INT32_MAX, &value)) {
+            ps.remove_edges = value;
+        } else if (strcmp(opt, "--count") == 0 && parse_count(arg, 1, 1000000, &value)) {
+            count = value;
+        } else if (strcmp(opt, "--seed") == 0 && arg) {
+            seed = strtoull(arg, NULL, 10);
+        } else {
+            printf("Unknown or invalid option: %s\n", opt);
+            return 1;
+        }
+        i++;
+    }
+    if (ps.host > PLANTED_MAX_HOST) {
+        printf("Planted hosts are dense matrices of at most %d vertices; use stream for larger graphs\n",
+               PLANTED_MAX_HOST);
+        return 1;
+    }
+    if (ps.host < ps.pattern.n) {
+        printf("--host must be at least n_G = %u\n", ps.pattern.n);
+        return 1;
+    }
+    if (ps.remove_vertices > ps.pattern.n || ps.remove_vertices >= ps.host) {
+        printf("--remove-vertices must be at most n_G and leave H a vertex\n");
+        return 1;
+    }
+
+    char path[1024], manifest_path[1024], truth_path[1024];
+    snprintf(manifest_path, sizeof(manifest_path), "%s.manifest", prefix);
+    snprintf(truth_path, sizeof(truth_path), "%s.truth.jsonl", prefix);
+    FILE* manifest = fopen(manifest_path, "w");
+    FILE* truth = fopen(truth_path, "w");
+    if (!manifest || !truth) {
+        printf("Error opening file.\n");
+        return 1;
+    }
+    fprintf(manifest, "# planted instances, ground truth in %s\n", truth_path);
+
+    int optimal = 0;
+    for (unsigned long long i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s-%llu.txt", prefix, i);
+        FILE* out = fopen(path, "w");
+        if (!out) {
+            printf("Error opening file.\n");
+            return 1;
+        }
+        PlantedTruth t;
+        int status = make_planted(&ps, seed, i, out, &t);
+        fclose(out);
+        if (status != 0) {
+            printf("Error: out of memory building a host of %u vertices.\n", ps.host);
+            fclose(manifest);
+            fclose(truth);
+            return 1;
+        }
+        fprintf(manifest, "%s\n", path);
+        write_planted_truth(truth, (int)i, path, seed, &t);
+        if (t.new_vertices + t.new_edges == t.lower_bound) optimal++;
+        free(t.mapping);
+    }
+    fclose(manifest);
+    fclose(truth);
+
+    printf("\n");
+    printf("[OK] Generated planted instances successfully!\n");
+    printf("\n");
+    printf("  Pattern   : %s, %u vertices\n", argv[3], ps.pattern.n);
+    printf("  Host      : %u vertices, noise %g\n", ps.host, ps.noise);
+    printf("  Damage    : %u vertices, %llu edges\n", ps.remove_vertices, ps.remove_edges);
+    printf("  Instances : %llu (%d with a known optimal cost)\n", count, optimal);
+    printf("  Seed      : %llu\n", (unsigned long long)seed);
+    printf("  Manifest  : %s\n", manifest_path);
+    printf("  Truth     : %s\n", truth_path);
+    printf("\n");
+    printf("  Run with: ./aac batch %s [greedy|beam|exact]\n", manifest_path);
+    printf("\n");
+    return 0;
+}
+
 void print_usage() {
     printf("\n");
     printf("========================================\n");
@@ -175,6 +1297,12 @@ void print_usage() {
     printf("  2) Generate combined input file (for aac):\n");
     printf("     ./graphgen combined <output_file> <type1> <n1> [k1] <type2> <n2> [k2]\n");
     printf("\n");
+    printf("  3) Stream a large graph without building a matrix:\n");
+    printf("     ./graphgen stream <type> <output_file> <params...> [options]\n");
+    printf("\n");
+    printf("  4) Planted instances with known costs (G hidden in H, then damaged):\n");
+    printf("     ./graphgen planted <prefix> <stream_type> <params...> [options]\n");
+    printf("\n");
     printf("  GRAPH TYPES:\n");
     printf("  ------------\n");
     printf("    path     - Path graph (n vertices, n-1 edges)\n");
@@ -183,6 +1311,32 @@ void print_usage() {
     printf("    random   - Random connected graph (requires k = edge count)\n");
     printf("               Constraint: n-1 <= k <= n(n-1)/2\n");
     printf("\n");
+    printf("  STREAM TYPES:\n");
+    printf("  -------------\n");
+    printf("    path <n>, cycle <n>, complete <n>\n");
+    printf("    grid <rows> <cols>  - 2D lattice\n");
+    printf("    torus <rows> <cols> - 2D lattice with wrap-around edges\n");
+    printf("    gnp <n> <p>         - Erdos-Renyi G(n,p), each pair with probability p\n");
+    printf("    gnm <n> <m>         - Erdos-Renyi G(n,m), m distinct edges\n");
+    printf("    ba <n> <k>          - Barabasi-Albert, k edges per new vertex\n");
+    printf("    regular <n> <d>     - Random d-regular graph (n*d even)\n");
+    printf("\n");
+    printf("  STREAM OPTIONS:\n");
+    printf("  ---------------\n");
+    printf("    --format edges|binary|matrix  Output format (default: edges)\n");
+    printf("    --seed <s>                    Random seed (default: GRAPHGEN_SEED or time)\n");
+    printf("    --threads <t>                 Generator threads (default: 1)\n");
+    printf("\n");
+    printf("  PLANTED OPTIONS:\n");
+    printf("  ----------------\n");
+    printf("    --host <n>             Host vertices before the damage (default: n_G, max %d)\n",
+           PLANTED_MAX_HOST);
+    printf("    --noise <p>            Background edge probability in H (default: 0)\n");
+    printf("    --remove-vertices <a>  Image vertices deleted from H (default: 0)\n");
+    printf("    --remove-edges <b>     Image edges deleted from H (default: 0)\n");
+    printf("    --count <c>            Instances in the corpus (default: 1)\n");
+    printf("    --seed <s>             Corpus seed (default: GRAPHGEN_SEED or time)\n");
+    printf("\n");
     printf("  EXAMPLES:\n");
     printf("  ---------\n");
     printf("    ./graphgen single path out.txt 5\n");
@@ -193,6 +1347,12 @@ void print_usage() {
     printf("    ./graphgen combined input.txt path 4 cycle 6\n");
     printf("    ./graphgen combined input.txt random 5 7 complete 6\n");
     printf("\n");
+    printf("    ./graphgen stream gnp big.txt 1000000 0.00001 --threads 4\n");
+    printf("    ./graphgen stream ba big.bin 1000000 3 --format binary --seed 7\n");
+    printf("    ./graphgen stream grid host.txt 20 30 --format matrix\n");
+    printf("\n");
+    printf("    ./graphgen planted corpus gnm 12 20 --host 40 --remove-edges 3 --count 50\n");
+    printf("\n");
     printf("========================================\n");
     printf("\n");
 }
@@ -229,7 +1389,9 @@ int parse_graph_args(int argc, char** argv, int start, const char** type, int* n
 }
 
 int main(int argc, char** argv) {
-    srand((unsigned int)time(NULL));
+    // GRAPHGEN_SEED makes random graphs reproducible (e.g. for make bench)
+    const char* seed = getenv("GRAPHGEN_SEED");
+    srand(seed ? (unsigned int)strtoul(seed, NULL, 10) : (unsigned int)time(NULL));
 
     if (argc < 2) {
         print_usage();
@@ -335,6 +1497,12 @@ int main(int argc, char** argv) {
         printf("  Run with: ./aac %s [greedy|exact|subiso]\n", filename);
         printf("\n");
     }
+    else if (strcmp(mode, "stream") == 0) {
+        return run_stream(argc, argv);
+    }
+    else if (strcmp(mode, "planted") == 0) {
+        return run_planted(argc, argv);
+    }
     else {
         print_usage();
         return 1;
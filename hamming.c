@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "hamming.h"
+#include "trace.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAMMING_X86 1
+#include <immintrin.h>
+#endif
+
+#define TILE_ROWS_A 16     // rows of a per tile
+#define TILE_ROWS_B 256    // rows of b per tile (kept hot in L2)
+#define PARALLEL_MIN_WORDS (1L << 20)  // XOR-popcount words worth a thread
+
+typedef int (*HammingKernel)(const uint64_t* a, const uint64_t* b, int words);
+
+static int hammingScalar(const uint64_t* a, const uint64_t* b, int words) {
+    int h = 0;
+    for (int w = 0; w < words; w++) h += __builtin_popcountll(a[w] ^ b[w]);
+    return h;
+}
+
+#ifdef HAMMING_X86
+// Same loop with the hardware POPCNT instruction instead of a library call
+__attribute__((target("popcnt")))
+static int hammingPopcnt(const uint64_t* a, const uint64_t* b, int words) {
+    int h = 0;
+    for (int w = 0; w < words; w++) h += __builtin_popcountll(a[w] ^ b[w]);
+    return h;
+}
+
+// Mula's method: per-nibble counts by byte shuffle, summed with SAD.
+__attribute__((target("avx2")))
+static int hammingAvx2(const uint64_t* a, const uint64_t* b, int words) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+
+    for (int w = 0; w < words; w += 4) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + w)),
+                                     _mm256_loadu_si256((const __m256i*)(b + w)));
+        __m256i lo = _mm256_and_si256(x, low);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                      _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+    }
+    return (int)(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+                 _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static int hammingAvx512(const uint64_t* a, const uint64_t* b, int words) {
+    __m512i acc = _mm512_setzero_si512();
+    for (int w = 0; w < words; w += 8) {
+        __m512i x = _mm512_xor_si512(_mm512_loadu_si512(a + w), _mm512_loadu_si512(b + w));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+    return (int)_mm512_reduce_add_epi64(acc);
+}
+#endif
+
+static HammingKernel kernel = hammingScalar;
+static const char* kernel_name = "scalar";
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void selectKernel(void) {
+    const char* forced = getenv("AAC_HAMMING_KERNEL");
+#ifdef HAMMING_X86
+    __builtin_cpu_init();
+    int has512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+    int has2 = __builtin_cpu_supports("avx2");
+    int hasPopcnt = __builtin_cpu_supports("popcnt");
+    if (forced && strcmp(forced, "scalar") == 0) return;
+    if (has512 && (!forced || strcmp(forced, "avx512") == 0)) {
+        kernel = hammingAvx512;
+        kernel_name = "avx512";
+    } else if (has2 && (!forced || strcmp(forced, "popcnt") != 0)) {
+        kernel = hammingAvx2;
+        kernel_name = "avx2";
+    } else if (hasPopcnt) {
+        kernel = hammingPopcnt;
+        kernel_name = "popcnt";
+    }
+#else
+    (void)forced;
+#endif
+}
+
+const char* hammingKernelName(void) {
+    pthread_once(&kernel_once, selectKernel);
+    return kernel_name;
+}
+
+int packAdjacencyRows(const Graph* g, int width, PackedRows* out) {
+    int words = (width + 63) / 64;
+    words = (words + 7) & ~7;   // whole vectors: kernels need no tail loop
+    if (words == 0) words = 8;
+
+    out->rows = g->n;
+    out->words = words;
+    out->bits = calloc((size_t)(g->n > 0 ? g->n : 1) * words, sizeof(uint64_t));
+    if (!out->bits) return -1;
+
+    for (int i = 0; i < g->n; i++) {
+        uint64_t* row = out->bits + (size_t)i * words;
+        for (int j = 0; j < g->n; j++) {
+            if (g->matrix[i][j]) row[j >> 6] |= 1ULL << (j & 63);
+        }
+    }
+    return 0;
+}
+
+void freePackedRows(PackedRows* rows) {
+    free(rows->bits);
+    rows->bits = NULL;
+}
+
+typedef struct {
+    const PackedRows* a;
+    const PackedRows* b;
+    int* out;
+    int first_tile;
+    int stride;
+} HammingJob;
+
+static void* hammingWorker(void* arg) {
+    const HammingJob* job = arg;
+    const PackedRows* a = job->a;
+    const PackedRows* b = job->b;
+    int words = a->words;
+    int tiles = (a->rows + TILE_ROWS_A - 1) / TILE_ROWS_A;
+    if (job->first_tile > 0) traceThreadName("hamming worker");
+    double traceStart = traceBegin();
+
+    for (int t = job->first_tile; t < tiles; t += job->stride) {
+        int i0 = t * TILE_ROWS_A;
+        int i1 = i0 + TILE_ROWS_A < a->rows ? i0 + TILE_ROWS_A : a->rows;
+        for (int j0 = 0; j0 < b->rows; j0 += TILE_ROWS_B) {
+            int j1 = j0 + TILE_ROWS_B < b->rows ? j0 + TILE_ROWS_B : b->rows;
+            for (int i = i0; i < i1; i++) {
+                const uint64_t* ra = a->bits + (size_t)i * words;
+                int* dst = job->out + (size_t)i * b->rows;
+                for (int j = j0; j < j1; j++) {
+                    dst[j] = kernel(ra, b->bits + (size_t)j * words, words);
+                }
+            }
+        }
+    }
+    traceEndArgs(traceStart, "hamming tiles", "worker", job->first_tile, "rows", a->rows);
+    return NULL;
+}
+
+int hammingMatrix(const PackedRows* a, const PackedRows* b, int* out, int threads) {
+    if (a->words != b->words) return -1;
+    pthread_once(&kernel_once, selectKernel);
+
+    int tiles = (a->rows + TILE_ROWS_A - 1) / TILE_ROWS_A;
+    long work = (long)a->rows * b->rows * a->words;
+    if (threads < 1 || work < PARALLEL_MIN_WORDS) threads = 1;
+    if (threads > tiles) threads = tiles > 0 ? tiles : 1;
+
+    HammingJob jobs[threads];
+    pthread_t tids[threads];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (HammingJob){ a, b, out, t, threads };
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, hammingWorker, &jobs[t]) != 0) break;
+        started = t;
+    }
+    // Tiles of workers that did not start are done by the caller
+    for (int t = started + 1; t < threads; t++) hammingWorker(&jobs[t]);
+    hammingWorker(&jobs[0]);
+    for (int t = 1; t <= started; t++) pthread_join(tids[t], NULL);
+    return 0;
+}
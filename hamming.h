@@ -0,0 +1,48 @@
+#ifndef HAMMING_H
+#define HAMMING_H
+
+#include <stdint.h>
+#include "graph.h"
+
+/**
+ * =============================================================================
+ * PACKED ROW HAMMING DISTANCES
+ * =============================================================================
+ * Adjacency rows packed one bit per column into 64-bit words, so the
+ * Hamming distance between two rows is a run of XOR + popcount over
+ * `words` words. The kernel is picked once at runtime: AVX-512 VPOPCNTDQ,
+ * AVX2 (nibble lookup), the POPCNT instruction, or portable scalar code.
+ * Setting the environment variable AAC_HAMMING_KERNEL to 'scalar',
+ * 'popcnt', 'avx2' or 'avx512' forces a kernel (the next best one is used
+ * if the CPU lacks it).
+ * =============================================================================
+ */
+
+typedef struct {
+    int rows;
+    int words;        // words per row, padded to a multiple of 8 (zero bits)
+    uint64_t* bits;   // rows x words
+} PackedRows;
+
+/**
+ * Packs the adjacency rows of g over `width` columns (width >= g->n;
+ * columns past g->n are zero). Returns 0 on success, -1 if memory runs out.
+ */
+int packAdjacencyRows(const Graph* g, int width, PackedRows* out);
+void freePackedRows(PackedRows* rows);
+
+/**
+ * Fills out[i * b->rows + j] with the Hamming distance between row i of a
+ * and row j of b (a->words == b->words). The matrix is computed in cache
+ * tiles split across `threads` workers (<= 1 = the calling thread; small
+ * matrices always stay on it). Returns 0 on success, -1 on
+ * mismatched widths.
+ */
+int hammingMatrix(const PackedRows* a, const PackedRows* b, int* out, int threads);
+
+/**
+ * Name of the kernel in use: "avx512", "avx2", "popcnt" or "scalar".
+ */
+const char* hammingKernelName(void);
+
+#endif // HAMMING_H
@@ -0,0 +1,318 @@
+#include <stdlib.h>
+#include <string.h>
+#include "isocache.h"
+
+#define WL_ROUNDS 3
+
+// Leaves of the individualisation tree explored per certificate; beyond
+// it the smallest leaf seen so far is used (see isoCertificate)
+#define CERT_MAX_LEAVES 128
+
+typedef struct IsoEntry {
+    uint64_t hash;
+    bool verdict;
+    int n;
+    int m;
+    unsigned char* cert;    // certificate confirming hash matches
+    size_t bytes;
+    struct IsoEntry* chain; // next entry in the same bucket
+    struct IsoEntry* newer; // insertion order, oldest first
+} IsoEntry;
+
+struct IsoCache {
+    IsoEntry** buckets;
+    int bucketCount;        // power of two
+    IsoEntry* oldest;
+    IsoEntry* newest;
+    size_t maxBytes;
+    IsoCacheStats stats;
+};
+
+static size_t certBytes(int n) {
+    return ((size_t)n * (n - 1) / 2 + 7) / 8;
+}
+
+IsoCache* isoCacheCreate(size_t maxBytes) {
+    IsoCache* c = calloc(1, sizeof(IsoCache));
+    if (!c) return NULL;
+    c->bucketCount = 1024;
+    c->buckets = calloc(c->bucketCount, sizeof(IsoEntry*));
+    if (!c->buckets) {
+        free(c);
+        return NULL;
+    }
+    c->maxBytes = maxBytes;
+    return c;
+}
+
+void isoCacheFree(IsoCache* cache) {
+    if (!cache) return;
+    IsoEntry* e = cache->oldest;
+    while (e) {
+        IsoEntry* next = e->newer;
+        free(e->cert);
+        free(e);
+        e = next;
+    }
+    free(cache->buckets);
+    free(cache);
+}
+
+// --- Certificates ---
+//
+// A certificate is the upper triangle of H's adjacency matrix, one bit per
+// pair, with the vertices in an order derived from the structure alone:
+// colour refinement, then individualisation of each vertex of the first
+// non-singleton colour class, recursively, until every class is a single
+// vertex. Each leaf of that tree is an ordering; the certificate is the
+// smallest bit string over the leaves. Two graphs with equal certificates
+// are isomorphic (the bits are the whole graph, relabelled), so a match
+// needs no further check. With at most CERT_MAX_LEAVES leaves explored the
+// result is still such a relabelling; large symmetric graphs may then get
+// different certificates for isomorphic copies, which costs hits, never
+// correctness.
+
+typedef struct {
+    uint64_t key;
+    int v;
+} CertKey;
+
+typedef struct {
+    const Graph* g;
+    CertKey* keys;
+    int* order;
+    unsigned char* leaf;
+    unsigned char* best;
+    bool haveBest;
+    int leaves;
+} CertSearch;
+
+static uint64_t certMix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static int compareCertKeys(const void* a, const void* b) {
+    const CertKey* x = a;
+    const CertKey* y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return 0;
+}
+
+// Renumbers the vertices 0..k-1 by ascending key[v]; equal keys share a
+// colour. Returns the number of colours.
+static int rankKeys(CertSearch* s, int* color) {
+    int n = s->g->n;
+    qsort(s->keys, n, sizeof(CertKey), compareCertKeys);
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        if (i > 0 && s->keys[i].key != s->keys[i - 1].key) k++;
+        color[s->keys[i].v] = k;
+    }
+    return n > 0 ? k + 1 : 0;
+}
+
+// Colour refinement: a vertex's new colour is its colour plus the multiset
+// of its neighbours' colours, until the number of colours stops growing.
+// Colours are ranked by label-free keys, so the result is the same for
+// every labelling of the graph.
+static int refineColors(CertSearch* s, int* color, int k) {
+    const Graph* g = s->g;
+    for (;;) {
+        for (int v = 0; v < g->n; v++) {
+            uint64_t sum = 0;
+            for (int i = 0; i < g->adjSize[v]; i++) sum += certMix((uint64_t)color[g->adj[v][i]]);
+            s->keys[v].key = ((uint64_t)color[v] << 40) ^ (certMix(sum) >> 24);
+            s->keys[v].v = v;
+        }
+        int refined = rankKeys(s, color);
+        if (refined <= k) return k;
+        k = refined;
+    }
+}
+
+static void certLeaf(CertSearch* s, const int* color) {
+    const Graph* g = s->g;
+    int n = g->n;
+    size_t bytes = certBytes(n);
+    for (int v = 0; v < n; v++) s->order[color[v]] = v;
+    memset(s->leaf, 0, bytes);
+    size_t bit = 0;
+    for (int i = 0; i < n; i++) {
+        const int* row = g->matrix[s->order[i]];
+        for (int j = i + 1; j < n; j++, bit++) {
+            if (row[s->order[j]]) s->leaf[bit >> 3] |= (unsigned char)(1u << (bit & 7));
+        }
+    }
+    if (!s->haveBest || memcmp(s->leaf, s->best, bytes) < 0) {
+        memcpy(s->best, s->leaf, bytes);
+        s->haveBest = true;
+    }
+    s->leaves++;
+}
+
+static bool certSearch(CertSearch* s, const int* color, int k) {
+    int n = s->g->n;
+    if (k == n) {
+        certLeaf(s, color);
+        return true;
+    }
+    // Target: the lowest colour held by more than one vertex
+    int* size = calloc(k, sizeof(int));
+    int* child = malloc(n * sizeof(int));
+    if (!size || !child) {
+        free(size);
+        free(child);
+        return false;
+    }
+    for (int v = 0; v < n; v++) size[color[v]]++;
+    int target = 0;
+    while (size[target] == 1) target++;
+    free(size);
+
+    bool ok = true;
+    for (int v = 0; v < n && ok && s->leaves < CERT_MAX_LEAVES; v++) {
+        if (color[v] != target) continue;
+        // v goes first within its class, the rest of the class after it
+        for (int w = 0; w < n; w++) {
+            s->keys[w].key = 2 * (uint64_t)color[w] + (w != v && color[w] == target);
+            s->keys[w].v = w;
+        }
+        int ck = rankKeys(s, child);
+        ok = certSearch(s, child, refineColors(s, child, ck));
+    }
+    free(child);
+    return ok;
+}
+
+// Writes H's certificate (certBytes(H->n) bytes) to `out`.
+static bool isoCertificate(const Graph* H, unsigned char* out) {
+    int n = H->n;
+    size_t bytes = certBytes(n);
+    CertSearch s = { H, malloc(n * sizeof(CertKey) + 1), malloc(n * sizeof(int) + 1),
+                     malloc(bytes + 1), out, false, 0 };
+    int* color = malloc(n * sizeof(int) + 1);
+    bool ok = s.keys && s.order && s.leaf && color;
+    if (ok) {
+        for (int v = 0; v < n; v++) {
+            s.keys[v].key = (uint64_t)H->adjSize[v];
+            s.keys[v].v = v;
+        }
+        int k = rankKeys(&s, color);
+        ok = certSearch(&s, color, refineColors(&s, color, k)) && s.haveBest;
+    }
+    free(s.keys);
+    free(s.order);
+    free(s.leaf);
+    free(color);
+    return ok;
+}
+
+bool isoCacheLookup(IsoCache* cache, const Graph* H, bool* verdict, uint64_t* hashOut) {
+    uint64_t hash = graphWLHash(H, WL_ROUNDS);
+    if (hashOut) *hashOut = hash;
+    if (!cache) return false;
+
+    // The certificate is only built once a stored entry has the same hash
+    unsigned char* cert = NULL;
+    bool certFailed = false;
+    IsoEntry* e = cache->buckets[hash & (cache->bucketCount - 1)];
+    for (; e; e = e->chain) {
+        if (e->hash != hash || e->n != H->n || e->m != H->m) continue;
+        if (!cert && !certFailed) {
+            cert = malloc(certBytes(H->n) + 1);
+            certFailed = !cert || !isoCertificate(H, cert);
+        }
+        if (!certFailed && memcmp(cert, e->cert, certBytes(H->n)) == 0) {
+            *verdict = e->verdict;
+            cache->stats.hits++;
+            free(cert);
+            return true;
+        }
+        cache->stats.collisions++;
+    }
+    free(cert);
+    cache->stats.misses++;
+    return false;
+}
+
+static void unlinkFromBucket(IsoCache* cache, IsoEntry* victim) {
+    IsoEntry** slot = &cache->buckets[victim->hash & (cache->bucketCount - 1)];
+    while (*slot && *slot != victim) slot = &(*slot)->chain;
+    if (*slot) *slot = victim->chain;
+}
+
+static void evictOldest(IsoCache* cache) {
+    IsoEntry* victim = cache->oldest;
+    if (!victim) return;
+    cache->oldest = victim->newer;
+    if (!cache->oldest) cache->newest = NULL;
+    unlinkFromBucket(cache, victim);
+    cache->stats.bytes -= victim->bytes;
+    cache->stats.entries--;
+    cache->stats.evictions++;
+    free(victim->cert);
+    free(victim);
+}
+
+// Keep chains short: double the bucket array once the load factor passes 2.
+static void growBuckets(IsoCache* cache) {
+    int newCount = cache->bucketCount * 2;
+    IsoEntry** nb = calloc(newCount, sizeof(IsoEntry*));
+    if (!nb) return;
+    for (IsoEntry* e = cache->oldest; e; e = e->newer) {
+        IsoEntry** slot = &nb[e->hash & (newCount - 1)];
+        e->chain = *slot;
+        *slot = e;
+    }
+    free(cache->buckets);
+    cache->buckets = nb;
+    cache->bucketCount = newCount;
+}
+
+void isoCacheInsert(IsoCache* cache, const Graph* H, uint64_t hash, bool verdict) {
+    if (!cache || cache->maxBytes == 0) return;
+
+    size_t bytes = sizeof(IsoEntry) + certBytes(H->n);
+    if (bytes > cache->maxBytes) return;
+
+    IsoEntry* e = malloc(sizeof(IsoEntry));
+    if (!e) return;
+    e->cert = malloc(certBytes(H->n) + 1);
+    if (!e->cert || !isoCertificate(H, e->cert)) {
+        free(e->cert);
+        free(e);
+        return;
+    }
+    while (cache->oldest && cache->stats.bytes + bytes > cache->maxBytes) {
+        evictOldest(cache);
+    }
+    e->n = H->n;
+    e->m = H->m;
+    e->hash = hash;
+    e->verdict = verdict;
+    e->bytes = bytes;
+    e->newer = NULL;
+
+    if (cache->stats.entries >= 2L * cache->bucketCount) growBuckets(cache);
+    IsoEntry** bucket = &cache->buckets[hash & (cache->bucketCount - 1)];
+    e->chain = *bucket;
+    *bucket = e;
+    if (cache->newest) cache->newest->newer = e;
+    else cache->oldest = e;
+    cache->newest = e;
+
+    cache->stats.bytes += bytes;
+    cache->stats.entries++;
+}
+
+void isoCacheGetStats(const IsoCache* cache, IsoCacheStats* stats) {
+    if (!stats) return;
+    if (!cache) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = cache->stats;
+}
@@ -0,0 +1,50 @@
+#ifndef ISOCACHE_H
+#define ISOCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+/**
+ * =============================================================================
+ * SUBGRAPH ISOMORPHISM VERDICT CACHE
+ * =============================================================================
+ * Remembers "does G embed into H'?" for the host graphs H' tested during an
+ * exact extension search. Entries are keyed by the Weisfeiler-Lehman hash of
+ * H'; a hash match is only trusted when the certificates match too. A
+ * certificate is H's adjacency matrix under a vertex order found by colour
+ * refinement and individualisation, so equal certificates mean isomorphic
+ * graphs and a hit is always a correct verdict. The pattern G is fixed for
+ * the lifetime of a cache.
+ *
+ * Memory is capped at `maxBytes`; once the cap is reached the oldest
+ * entries are evicted first.
+ * =============================================================================
+ */
+typedef struct IsoCache IsoCache;
+
+typedef struct {
+    long hits;          // verdicts answered from the cache
+    long misses;        // lookups that had to run the real test
+    long collisions;    // hash matches rejected by the certificate
+    long evictions;     // entries dropped to stay under the memory cap
+    long entries;       // entries currently stored
+    size_t bytes;       // approximate memory held by the entries
+} IsoCacheStats;
+
+IsoCache* isoCacheCreate(size_t maxBytes);
+void isoCacheFree(IsoCache* cache);
+
+/**
+ * Looks up H. Returns true and stores the verdict on a confirmed hit.
+ * `hashOut` receives the structural hash of H for a following insert.
+ */
+bool isoCacheLookup(IsoCache* cache, const Graph* H, bool* verdict, uint64_t* hashOut);
+
+/** Stores the verdict for H under the hash returned by the lookup. */
+void isoCacheInsert(IsoCache* cache, const Graph* H, uint64_t hash, bool verdict);
+
+void isoCacheGetStats(const IsoCache* cache, IsoCacheStats* stats);
+
+#endif
@@ -2,36 +2,156 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "graph.h"
 #include "subiso.h"
 #include "gmext.h"
 #include "exact_extension.h"
+#include "beam_extension.h"
+#include "batch.h"
+#include "graphdb.h"
+#include "multimatch.h"
+#include "dynamic.h"
+#include "serve.h"
+#include "resultcache.h"
+#include "stats.h"
+#include "trace.h"
+#include "timing.h"
 
 typedef enum {
     ALG_GREEDY,
+    ALG_GREEDY_LS,
+    ALG_BEAM,
     ALG_EXACT,
     ALG_SUBISO_ONLY
 } Algorithm;
 
+static const struct {
+    const char* name;   // command line spelling
+    const char* label;  // banner text
+    Algorithm alg;
+} ALGORITHMS[] = {
+    { "greedy",    "Greedy",                ALG_GREEDY },
+    { "greedy+ls", "Greedy + local search", ALG_GREEDY_LS },
+    { "beam",      "Beam search",           ALG_BEAM },
+    { "exact",     "Exact",                 ALG_EXACT },
+    { "subiso",    "Subiso only",           ALG_SUBISO_ONLY },
+};
+#define ALGORITHM_COUNT ((int)(sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0])))
+
+typedef struct {
+    double timeLimit;   // exact: anytime mode budget in seconds (0 = run to completion)
+    double isoCacheMB;  // exact: verdict cache cap in megabytes (0 = disabled)
+    GreedyCandidateMode candidates;  // greedy: candidate generation policy
+    int assignmentSeed; // greedy: also try the assignment-seeded mapping
+    int restarts;       // greedy: randomized restarts (0 = none)
+    int threads;        // worker threads for parallel phases
+    unsigned long long seed;  // greedy: PRNG seed for restarts
+    int rclSize;        // greedy: restricted candidate list length
+    long lsIterations;  // greedy+ls: annealing moves (0 = default)
+    double lsTime;      // greedy+ls: refinement time cap in seconds (0 = none)
+    int beamWidth;      // beam: partial mappings kept per level (0 = default)
+    DistanceMode distance;  // tier used for the d(G, H) metric
+    int metrics;        // METRIC_* bits: optional output computed on request
+    int countEmbeddings;  // dynamic: maintain the number of embeddings
+    const char* socketPath;  // serve: UNIX socket to listen on (NULL = stdin)
+    long long countLimit;    // serve: count queries stop here (0 = count all)
+    const char* cachePath;   // persistent result cache file (NULL = none)
+    double cacheMB;          // result cache file cap in megabytes (0 = none)
+    int stats;               // report search counters, phase times and peak memory
+    const char* tracePath;   // write a Chrome trace of the run here (NULL = none)
+} RunOptions;
+
+// Optional report sections. Nothing here is computed unless requested.
+enum {
+    METRIC_DISTANCE = 1 << 0,  // d(G, H) estimate and bounds
+    METRIC_SIZES    = 1 << 1,  // S(G), S(H), S(H') and d(H, H')
+    METRIC_MATRICES = 1 << 2,  // adjacency matrices of G, H and H'
+    METRIC_ALL      = METRIC_DISTANCE | METRIC_SIZES | METRIC_MATRICES
+};
+
+#define DEFAULT_ISO_CACHE_MB 0
+#define DEFAULT_RESULT_CACHE_MB 256
+#define DEFAULT_COUNT_LIMIT 1000000
+
 static void printUsage(const char* programName) {
     printf("Usage:\n");
     printf("  %s <input_file> [algorithm]           - Single file with both graphs\n", programName);
     printf("  %s <graph_G> <graph_H> [algorithm]    - Two separate graph files\n", programName);
+    printf("  %s batch <manifest|-> [algorithm]     - Run every job of a manifest\n", programName);
+    printf("  %s db build <db> <host_files...>      - Preprocess host graphs into a database\n", programName);
+    printf("  %s db add <db> <host_files...>        - Append host graphs to a database\n", programName);
+    printf("  %s db prepare <graph_G> <file>        - Preprocess G for repeated queries\n", programName);
+    printf("  %s db query <db> <graph_G>            - List the hosts that contain G (G may be\n", programName);
+    printf("  %*s                                      a file written by 'db prepare')\n", (int)strlen(programName), "");
+    printf("  %s multi <graph_H> <pattern_files...> - Test many patterns against one host\n", programName);
+    printf("  %s dynamic <graph_G> <graph_H> <updates|-> - Track the verdict under\n", programName);
+    printf("                                          '+ u v' / '- u v' edge updates of H\n");
+    printf("  %s serve <host_files...>             - Keep hosts loaded and answer pattern\n", programName);
+    printf("                                          queries from stdin or --socket\n");
     printf("\nArguments:\n");
     printf("  input_file  - File containing both graphs (G and H) in adjacency matrix format\n");
     printf("  graph_G     - File containing graph G (pattern) in adjacency matrix format\n");
     printf("  graph_H     - File containing graph H (host) in adjacency matrix format\n");
-    printf("  algorithm   - Optional: 'greedy' (default), 'exact', or 'subiso'\n");
+    printf("  algorithm   - Optional: 'greedy' (default), 'greedy+ls', 'beam', 'exact', or 'subiso'\n");
+    printf("\nOptions:\n");
+    printf("  --time-limit <sec>  - Run 'exact' in anytime mode: stop after <sec> seconds\n");
+    printf("                        and report the best extension with its optimality gap.\n");
+    printf("                        For 'greedy': time budget for randomized restarts\n");
+    printf("  --iso-cache-mb <MB> - Memory cap of the exact search's isomorphism verdict\n");
+    printf("                        cache (default %d: off)\n", DEFAULT_ISO_CACHE_MB);
+    printf("  --candidates <full|frontier>\n");
+    printf("                      - Greedy candidate policy: 'full' (default) considers every\n");
+    printf("                        unused H vertex, 'frontier' only neighbours of mapped images\n");
+    printf("  --assignment-seed   - Greedy: also try a mapping seeded by an O(n^3) assignment\n");
+    printf("                        over vertex signatures (graphs up to 500 vertices)\n");
+    printf("  --restarts <n>      - Greedy: run <n> randomized (GRASP) restarts after the fixed\n");
+    printf("                        strategies and keep the best mapping\n");
+    printf("  --threads <n>       - Worker threads for parallel phases (default 1; batch and\n");
+    printf("                        serve: jobs solved at once, default all processors)\n");
+    printf("  --seed <n>          - Seed for randomized restarts (results are reproducible\n");
+    printf("                        for a given seed and restart count)\n");
+    printf("  --rcl <k>           - Restarts pick among the best <k> candidates (default 3)\n");
+    printf("  --ls-iterations <n> - greedy+ls: annealing moves to try (default 200 per G vertex)\n");
+    printf("  --ls-time <sec>     - greedy+ls: wall-clock cap for the refinement\n");
+    printf("  --beam-width <w>    - beam: partial mappings kept per level (default 16); wider\n");
+    printf("                        beams run longer and get closer to the exact optimum\n");
+    printf("  --metrics <list>    - Optional report sections, comma separated: 'distance',\n");
+    printf("                        'sizes', 'matrices', 'all' or 'none' (default). The\n");
+    printf("                        distance estimate runs concurrently with the solver\n");
+    printf("  --count             - dynamic: also maintain the number of embeddings of G\n");
+    printf("  --socket <path>     - serve: listen on this UNIX socket instead of stdin\n");
+    printf("  --count-limit <n>   - serve: 'count' queries stop after <n> embeddings\n");
+    printf("                        (default %d, 0 = count all)\n", DEFAULT_COUNT_LIMIT);
+    printf("  --cache <file>      - Keep results in <file> and reuse them for the same G, H,\n");
+    printf("                        algorithm and settings (single runs and batch)\n");
+    printf("  --cache-mb <MB>     - Size cap of the --cache file (default %d, 0 = none)\n",
+           DEFAULT_RESULT_CACHE_MB);
+    printf("  --stats             - Report search counters, time per phase and peak memory\n");
+    printf("                        (batch: a \"stats\" object in every JSON line)\n");
+    printf("  --trace <file>      - Write a timeline of the solver phases to <file> as\n");
+    printf("                        Chrome trace JSON (chrome://tracing, ui.perfetto.dev)\n");
+    printf("  --distance <auto|lower|upper|assignment>\n");
+    printf("                      - How d(G, H) is computed: degree lower bound, greedy\n");
+    printf("                        alignment upper bound, or O(n^3) assignment estimate.\n");
+    printf("                        'auto' (default) uses the assignment up to %d vertices.\n",
+           DISTANCE_ASSIGNMENT_MAX_N);
+    printf("                        Implies --metrics distance\n");
     printf("\nAlgorithms:\n");
-    printf("  greedy  - Approximate Minimal Extension Algorithm\n");
-    printf("  exact   - Exact Minimal Extension Algorithm\n");
-    printf("  subiso  - Only check subgraph isomorphism\n");
+    printf("  greedy     - Approximate Minimal Extension Algorithm\n");
+    printf("  greedy+ls  - Greedy followed by a local search refinement (relocate/swap moves)\n");
+    printf("  beam       - Beam search over partial mappings, between greedy and exact\n");
+    printf("  exact      - Exact Minimal Extension Algorithm\n");
+    printf("  subiso     - Only check subgraph isomorphism\n");
     printf("\nExamples:\n");
     printf("  %s combined.txt              (single file, uses greedy)\n", programName);
     printf("  %s combined.txt exact        (single file, uses exact)\n", programName);
     printf("  %s graphG.txt graphH.txt     (two files, uses greedy)\n", programName);
     printf("  %s graphG.txt graphH.txt exact (two files, uses exact)\n", programName);
+    printf("  %s combined.txt exact --time-limit 5  (exact, best-so-far after 5s)\n", programName);
+    printf("  %s batch jobs.txt beam --threads 8    (JSON line per job on stdout)\n", programName);
+    printf("  %s db query hosts.db pattern.txt --threads 8\n", programName);
 }
 
 static void printSeparator(void) {
@@ -42,7 +162,7 @@ static void printSeparator(void) {
 // Only prints if the extended graph has 20 or fewer vertices
 // Highlights new vertices and new edges
 static void printExtendedMatrix(const Graph* H, int newVertexCount, 
-                                 int (*newEdges)[2], int newEdgeCount) {
+                                 int (*newEdges)[2], int newEdgeCount, int showMatrix) {
     int newN = H->n + newVertexCount;
     
     // Count edges first (we need this for the summary)
@@ -52,6 +172,7 @@ static void printExtendedMatrix(const Graph* H, int newVertexCount,
     printf("\n  [EXTENDED GRAPH H']\n\n");
     printf("    H' has %d vertices and %d edges\n", newN, edgeCount);
     printf("    (Added %d new vertices and %d new edges)\n", newVertexCount, newEdgeCount);
+    if (!showMatrix) return;
     
     // Only print adjacency matrix for small graphs (20 or fewer vertices)
     if (newN > 20) {
@@ -166,160 +287,999 @@ static void printAdjacencyMatrix(const Graph* g, const char* title) {
 
 }
 
-static void runGreedyExtension(Graph* G, Graph* H) {
+// Print the cost breakdown, metrics and edit list shared by all extension
+// algorithms.
+static void printExtensionResult(const Graph* G, const Graph* H,
+                                 const int* newVertices, int newVertexCount,
+                                 int (*newEdges)[2], int newEdgeCount, int metrics) {
+    int total_cost = newVertexCount + newEdgeCount;
+
+    printf("\n  [RESULTS]\n\n");
+    printf("    New vertices needed : %d\n", newVertexCount);
+    printf("    New edges needed    : %d\n", newEdgeCount);
+    printf("    -------------------------\n");
+    printf("    TOTAL COST          : %d\n", total_cost);
+
+    // Display metric information
+    if (metrics & METRIC_SIZES) {
+        printf("\n  [GRAPH METRICS]\n\n");
+        printf("    Size of G (|V|+|E|)       : %d\n", graphSize(G));
+        printf("    Size of H (|V|+|E|)       : %d\n", graphSize(H));
+        printf("    Size of H' (extended)     : %d\n", graphSize(H) + newVertexCount + newEdgeCount);
+        printf("    Extension Distance d(H,H'): %d\n", extensionDistance(G, H, newVertexCount, newEdgeCount));
+    }
+
+    if (newVertexCount > 0) {
+        printf("\n  [VERTICES TO ADD]\n\n    ");
+        for (int i = 0; i < newVertexCount; i++) {
+            printf("v%d ", newVertices[i]);
+        }
+        printf("\n");
+    }
+
+    if (newEdgeCount > 0) {
+        printf("\n  [EDGES TO ADD]\n\n    ");
+        for (int i = 0; i < newEdgeCount; i++) {
+            printf("(%d, %d)", newEdges[i][0], newEdges[i][1]);
+            if (i < newEdgeCount - 1) printf(", ");
+        }
+        printf("\n");
+    }
+
+    // Print the extended graph's adjacency matrix
+    printExtendedMatrix(H, newVertexCount, newEdges, newEdgeCount, metrics & METRIC_MATRICES);
+}
+
+// `full` is the same search with the full candidate scan, run alongside a
+// frontier search to show what the narrower candidate set costs (or NULL).
+static void printGreedySearchStats(const GreedyExtension* ext, const GreedyExtension* full,
+                                   const RunOptions* run) {
+    printf("\n  [SEARCH STATISTICS]\n\n");
+    printf("    Candidate policy    : %s\n",
+           run->candidates == GREEDY_CANDIDATES_FRONTIER ? "frontier" : "full");
+    if (ext->restartsRun > 0) {
+        printf("    Random restarts     : %ld (seed %llu, %d thread%s)\n", ext->restartsRun,
+               run->seed, run->threads > 1 ? run->threads : 1, run->threads > 1 ? "s" : "");
+    }
+    if (ext->refinementMoves > 0 || ext->costBeforeRefinement != ext->newVertexCount + ext->newEdgeCount) {
+        printf("    Local search        : cost %d -> %d (%ld moves accepted)\n",
+               ext->costBeforeRefinement, ext->newVertexCount + ext->newEdgeCount,
+               ext->refinementMoves);
+    }
+    printf("    Candidates scored   : %ld\n", ext->candidatesScored);
+    printf("    Full scan would be  : %ld", ext->fullScanCandidates);
+    if (ext->candidatesScored > 0) {
+        printf(" (%.1fx fewer evaluations)", (double)ext->fullScanCandidates / ext->candidatesScored);
+    }
+    printf("\n");
+    if (full) {
+        int cost = ext->newVertexCount + ext->newEdgeCount;
+        int fullCost = full->newVertexCount + full->newEdgeCount;
+        printf("    Full scan result    : cost %d vs %d with the frontier (%+d), %ld candidates scored\n",
+               fullCost, cost, cost - fullCost, full->candidatesScored);
+    }
+}
+
+// Keeps a copy of a solver's extension for the result cache.
+static void recordExtension(CachedResult* record, int newVertexCount,
+                            int (*newEdges)[2], int newEdgeCount, bool optimal, int lowerBound) {
+    if (!record) return;
+    record->edges = newEdgeCount > 0 ? malloc(newEdgeCount * sizeof(*newEdges)) : NULL;
+    if (newEdgeCount > 0 && !record->edges) return;
+    if (newEdgeCount > 0) memcpy(record->edges, newEdges, newEdgeCount * sizeof(*newEdges));
+    record->newVertices = newVertexCount;
+    record->newEdges = newEdgeCount;
+    record->optimal = optimal;
+    record->lowerBound = lowerBound;
+}
+
+static bool runGreedyExtension(Graph* G, Graph* H, const RunOptions* run, int localSearch,
+                               CachedResult* record) {
     printf("\n");
     printSeparator();
-    printf("  GREEDY EXTENSION ALGORITHM\n");
+    printf(localSearch ? "  GREEDY EXTENSION ALGORITHM + LOCAL SEARCH\n"
+                       : "  GREEDY EXTENSION ALGORITHM\n");
     printSeparator();
     
-    GreedyExtension* ext = greedy_extension(G, H);
+    GreedyOptions opts = {0};
+    opts.candidates = run->candidates;
+    opts.assignmentSeed = run->assignmentSeed;
+    opts.restarts = run->restarts;
+    opts.timeBudget = run->timeLimit;
+    opts.threads = run->threads;
+    opts.seed = run->seed;
+    opts.rclSize = run->rclSize;
+    opts.localSearch = localSearch;
+    opts.lsIterations = run->lsIterations;
+    opts.lsTimeBudget = run->lsTime;
+    GreedyExtension* ext = greedy_extension_with_options(G, H, &opts);
+    GreedyExtension* full = NULL;
+    if (ext && opts.candidates == GREEDY_CANDIDATES_FRONTIER) {
+        opts.candidates = GREEDY_CANDIDATES_FULL;
+        full = greedy_extension_with_options(G, H, &opts);
+    }
     
     if (ext) {
-        int total_cost = ext->newVertexCount + ext->newEdgeCount;
-        
-        printf("\n  [RESULTS]\n\n");
-        printf("    New vertices needed : %d\n", ext->newVertexCount);
-        printf("    New edges needed    : %d\n", ext->newEdgeCount);
-        printf("    -------------------------\n");
-        printf("    TOTAL COST          : %d\n", total_cost);
-        
-        // Display metric information
-        printf("\n  [GRAPH METRICS]\n\n");
-        printf("    Size of G (|V|+|E|)       : %d\n", graphSize(G));
-        printf("    Size of H (|V|+|E|)       : %d\n", graphSize(H));
-        printf("    Size of H' (extended)     : %d\n", graphSize(H) + ext->newVertexCount + ext->newEdgeCount);
-        printf("    Extension Distance d(H,H'): %d\n", extensionDistance(G, H, ext->newVertexCount, ext->newEdgeCount));
-        
-        if (ext->newVertexCount > 0) {
-            printf("\n  [VERTICES TO ADD]\n\n    ");
-            for (int i = 0; i < ext->newVertexCount; i++) {
-                printf("v%d ", ext->newVertices[i]);
-            }
-            printf("\n");
-        }
-        
-        if (ext->newEdgeCount > 0) {
-            printf("\n  [EDGES TO ADD]\n\n    ");
-            for (int i = 0; i < ext->newEdgeCount; i++) {
-                printf("(%d, %d)", ext->newEdges[i][0], ext->newEdges[i][1]);
-                if (i < ext->newEdgeCount - 1) printf(", ");
-            }
-            printf("\n");
-        }
-        
-        // Print the extended graph's adjacency matrix
-        printExtendedMatrix(H, ext->newVertexCount, 
-                           ext->newEdges, ext->newEdgeCount);
+        printExtensionResult(G, H, ext->newVertices, ext->newVertexCount,
+                             ext->newEdges, ext->newEdgeCount, run->metrics);
+        printGreedySearchStats(ext, full, run);
+        recordExtension(record, ext->newVertexCount, ext->newEdges, ext->newEdgeCount, false, -1);
         
         printf("\n");
         printSeparator();
         freeGreedyExtension(ext);
-    } else {
-        printf("\n  [ERROR] Failed to compute greedy extension.\n");
+        freeGreedyExtension(full);
+        return true;
+    }
+    printf("\n  [ERROR] Failed to compute greedy extension.\n");
+    printSeparator();
+    return false;
+}
+
+static bool runBeamExtension(Graph* G, Graph* H, const RunOptions* run, CachedResult* record) {
+    printf("\n");
+    printSeparator();
+    printf("  BEAM SEARCH EXTENSION ALGORITHM\n");
+    printSeparator();
+
+    BeamOptions opts = {0};
+    opts.width = run->beamWidth;
+    opts.threads = run->threads;
+    BeamStats stats;
+    GreedyExtension* ext = beam_extension(G, H, &opts, &stats);
+
+    if (ext) {
+        printExtensionResult(G, H, ext->newVertices, ext->newVertexCount,
+                             ext->newEdges, ext->newEdgeCount, run->metrics);
+
+        printf("\n  [SEARCH STATISTICS]\n\n");
+        printf("    Beam width          : %d (%d thread%s)\n", stats.width,
+               run->threads > 1 ? run->threads : 1, run->threads > 1 ? "s" : "");
+        printf("    Levels expanded     : %d\n", stats.levels);
+        printf("    States expanded     : %ld\n", stats.statesExpanded);
+        printf("    Candidates scored   : %ld (%ld pruned by the upper bound)\n",
+               stats.candidatesScored, stats.candidatesPruned);
+        printf("    Lower bound (root)  : %d\n", stats.rootBound);
+        printf("    Greedy upper bound  : %d%s\n", stats.seedCost,
+               stats.fromSeed ? " (kept, beam did not improve it)" : "");
+        printf("    Elapsed             : %.3fs\n", stats.elapsed);
+        recordExtension(record, ext->newVertexCount, ext->newEdges, ext->newEdgeCount, false, -1);
+
+        printf("\n");
         printSeparator();
+        freeGreedyExtension(ext);
+        return true;
+    }
+    printf("\n  [ERROR] Failed to compute beam search extension.\n");
+    printSeparator();
+    return false;
+}
+
+static void printExactSearchStats(const ExactSearchStats* stats) {
+    const IsoCacheStats* c = &stats->cache;
+    long lookups = c->hits + c->misses;
+
+    printf("\n  [SEARCH STATISTICS]\n\n");
+    printf("    Subiso tests run    : %ld\n", stats->isoTests);
+    if (lookups == 0) {
+        printf("    Verdict cache       : disabled\n");
+        return;
     }
+    printf("    Cache hits / misses : %ld / %ld (%.1f%% hit rate)\n",
+           c->hits, c->misses, 100.0 * c->hits / lookups);
+    printf("    Hash collisions     : %ld\n", c->collisions);
+    printf("    Cache entries       : %ld (%.2f MB, %ld evicted)\n",
+           c->entries, c->bytes / (1024.0 * 1024.0), c->evictions);
+}
+
+static size_t cacheBytesFromMB(double mb) {
+    return mb > 0 ? (size_t)(mb * 1024.0 * 1024.0) : 0;
 }
 
-static void runExactExtension(const Graph* G, const Graph* H) {
+static bool runExactExtension(const Graph* G, const Graph* H, const RunOptions* run,
+                              CachedResult* record) {
     printf("\n");
     printSeparator();
     printf("  EXACT MINIMAL EXTENSION ALGORITHM\n");
     printSeparator();
     
-    Extension* ext = exactMinimalExtension(G, H);
+    ExactOptions opts = {0};
+    opts.isoCacheBytes = cacheBytesFromMB(run->isoCacheMB);
+    ExactSearchStats stats;
+    Extension* ext = exactMinimalExtensionWithOptions(G, H, &opts, &stats);
     
     if (ext) {
-        int total_cost = ext->newVertexCount + ext->newEdgeCount;
-        
-        printf("\n  [RESULTS]\n\n");
-        printf("    New vertices needed : %d\n", ext->newVertexCount);
-        printf("    New edges needed    : %d\n", ext->newEdgeCount);
-        printf("    -------------------------\n");
-        printf("    TOTAL COST          : %d\n", total_cost);
-        
-        // Display metric information
-        printf("\n  [GRAPH METRICS]\n\n");
-        printf("    Size of G (|V|+|E|)       : %d\n", graphSize(G));
-        printf("    Size of H (|V|+|E|)       : %d\n", graphSize(H));
-        printf("    Size of H' (extended)     : %d\n", graphSize(H) + ext->newVertexCount + ext->newEdgeCount);
-        printf("    Extension Distance d(H,H'): %d\n", extensionDistance(G, H, ext->newVertexCount, ext->newEdgeCount));
-        
-        if (ext->newVertexCount > 0) {
-            printf("\n  [VERTICES TO ADD]\n\n    ");
-            for (int i = 0; i < ext->newVertexCount; i++) {
-                printf("v%d ", ext->newVertices[i]);
-            }
-            printf("\n");
-        }
-        
-        if (ext->newEdgeCount > 0) {
-            printf("\n  [EDGES TO ADD]\n\n    ");
-            for (int i = 0; i < ext->newEdgeCount; i++) {
-                printf("(%d, %d)", ext->newEdges[i][0], ext->newEdges[i][1]);
-                if (i < ext->newEdgeCount - 1) printf(", ");
-            }
-            printf("\n");
-        }
-        
-        // Print the extended graph's adjacency matrix
-        printExtendedMatrix(H, ext->newVertexCount, 
-                           ext->newEdges, ext->newEdgeCount);
+        printExtensionResult(G, H, ext->newVertices, ext->newVertexCount,
+                             ext->newEdges, ext->newEdgeCount, run->metrics);
+        printExactSearchStats(&stats);
+        recordExtension(record, ext->newVertexCount, ext->newEdges, ext->newEdgeCount, true, -1);
         
         printf("\n");
         printSeparator();
         freeExtensionObject(ext);
+        return true;
+    }
+    printf("\n  [ERROR] No extension found.\n");
+    printSeparator();
+    return false;
+}
+
+static void printAnytimeProgress(const char* event, int lowerBound, int upperBound,
+                                 double elapsed, void* user) {
+    (void)user;
+    printf("    [%8.3fs] %-9s  bound = %-4d  incumbent = %-4d  gap = %d\n",
+           elapsed, event, lowerBound, upperBound, upperBound - lowerBound);
+    fflush(stdout);
+}
+
+static bool runAnytimeExactExtension(const Graph* G, const Graph* H, const RunOptions* run,
+                                     CachedResult* record) {
+    printf("\n");
+    printSeparator();
+    printf("  EXACT MINIMAL EXTENSION ALGORITHM (anytime, %.3fs limit)\n", run->timeLimit);
+    printSeparator();
+
+    ExactOptions opts = {0};
+    opts.timeLimit = run->timeLimit;
+    opts.isoCacheBytes = cacheBytesFromMB(run->isoCacheMB);
+    opts.progress = printAnytimeProgress;
+
+    printf("\n  [PROGRESS]\n\n");
+    fflush(stdout);
+    ExactAnytimeResult* res = exactMinimalExtensionAnytime(G, H, &opts);
+    bool solved = res && res->best;
+
+    if (solved) {
+        Extension* ext = res->best;
+        printExtensionResult(G, H, ext->newVertices, ext->newVertexCount,
+                             ext->newEdges, ext->newEdgeCount, run->metrics);
+
+        printf("\n  [OPTIMALITY]\n\n");
+        printf("    Best cost found     : %d\n", res->upperBound);
+        printf("    Proven lower bound  : %d\n", res->lowerBound);
+        printf("    Gap                 : %d\n", res->upperBound - res->lowerBound);
+        printf("    Status              : %s\n",
+               res->optimal ? "optimal" : (res->timedOut ? "time limit reached" : "not proven"));
+        printf("    Elapsed             : %.3fs\n", res->elapsed);
+        printExactSearchStats(&res->stats);
+        recordExtension(record, ext->newVertexCount, ext->newEdges, ext->newEdgeCount,
+                        res->optimal, res->lowerBound);
+
+        printf("\n");
+        printSeparator();
     } else {
         printf("\n  [ERROR] No extension found.\n");
         printSeparator();
     }
+    freeExactAnytimeResult(res);
+    return solved;
+}
+
+static void resultParamsFromRun(ResultParams* p, const RunOptions* run, Algorithm alg) {
+    memset(p, 0, sizeof(*p));
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (ALGORITHMS[i].alg == alg) p->algorithm = ALGORITHMS[i].name;
+    }
+    p->timeLimit = run->timeLimit;
+    p->restarts = run->restarts;
+    p->seed = run->seed;
+    p->rclSize = run->rclSize;
+    p->candidates = run->candidates;
+    p->assignmentSeed = run->assignmentSeed;
+    p->lsIterations = run->lsIterations;
+    p->lsTime = run->lsTime;
+    p->beamWidth = run->beamWidth;
+}
+
+static void printCachedExtension(const Graph* G, const Graph* H, const CachedResult* c,
+                                 const RunOptions* run) {
+    printf("      Extension taken from the result cache.\n");
+    int* newVertices = malloc((c->newVertices > 0 ? c->newVertices : 1) * sizeof(int));
+    if (!newVertices) return;
+    for (int i = 0; i < c->newVertices; i++) newVertices[i] = H->n + i;
+    printf("\n");
+    printSeparator();
+    printExtensionResult(G, H, newVertices, c->newVertices, c->edges, c->newEdges, run->metrics);
+    printf("\n    Status              : %s\n", c->optimal ? "optimal" : "heuristic");
+    printf("\n");
+    printSeparator();
+    free(newVertices);
+}
+
+// The distance estimate shares no state with the solvers, so it runs on
+// its own thread while the subiso check and the extension search proceed.
+typedef struct {
+    const Graph* G;
+    const Graph* H;
+    GraphDistanceOptions opts;
+    GraphDistanceResult result;
+    double seconds;
+    pthread_t thread;
+    int started;
+} DistanceJob;
+
+static void* distanceThread(void* arg) {
+    DistanceJob* job = arg;
+    traceThreadName("distance");
+    double t0 = wallSeconds();
+    graphDistanceWithOptions(job->G, job->H, &job->opts, &job->result);
+    job->seconds = wallSeconds() - t0;
+    traceEnd(t0, "distance");
+    return NULL;
+}
+
+static void startDistance(DistanceJob* job, const Graph* G, const Graph* H, const RunOptions* run) {
+    memset(job, 0, sizeof(*job));
+    job->G = G;
+    job->H = H;
+    job->opts.mode = run->distance;
+    job->opts.threads = run->threads;
+    job->started = pthread_create(&job->thread, NULL, distanceThread, job) == 0;
+}
+
+static void printDistance(DistanceJob* job) {
+    if (job->started) pthread_join(job->thread, NULL);
+    else distanceThread(job);
+
+    printf("\n  [GRAPH DISTANCE]\n\n");
+    printf("    d(G, H)             : %d (%s)\n", job->result.value,
+           distanceTierName(job->result.tier));
+    printf("    Bounds              : %d <= GED <= %d\n",
+           job->result.lowerBound, job->result.upperBound);
+}
+
+// Wall-clock seconds spent in each phase of a single run.
+typedef struct {
+    double load;
+    double distance;    // on its own thread, overlapping the others
+    double subiso;
+    double extension;
+    double total;
+} PhaseTimes;
+
+static void printRunStats(const PhaseTimes* t, const RunOptions* run) {
+    printf("\n  [STATISTICS]\n\n");
+    printf("    Load graphs         : %.3fs\n", t->load);
+    if (run->metrics & METRIC_DISTANCE) {
+        printf("    Distance            : %.3fs (concurrent)\n", t->distance);
+    }
+    printf("    Subiso check        : %.3fs\n", t->subiso);
+    printf("    Extension           : %.3fs\n", t->extension);
+    printf("    Total               : %.3fs\n", t->total);
+    printf("    Peak memory (RSS)   : %.1f MB\n", statsPeakRssKB() / 1024.0);
+
+    if (!statsEnabled()) {
+        printf("    Search counters     : not compiled in (build with STATS=1)\n");
+        return;
+    }
+    SearchStats s;
+    statsSnapshot(&s);
+    const long long* c = s.counters;
+    printf("\n    Subiso calls        : %lld\n", c[STAT_SUBISO_CALLS]);
+    printf("    Search nodes        : %lld\n", c[STAT_SUBISO_NODES]);
+    printf("    Candidates examined : %lld\n", c[STAT_SUBISO_CANDIDATES]);
+    printf("    Pruned by degree    : %lld\n", c[STAT_PRUNE_DEGREE]);
+    printf("    Pruned (adjacency)  : %lld\n", c[STAT_PRUNE_CONSISTENCY]);
+    printf("    Pruned (lookahead)  : %lld\n", c[STAT_PRUNE_FEASIBILITY]);
+    if (c[STAT_EXACT_TRIES] > 0) {
+        printf("    Exact H' tested     : %lld (%lld from the verdict cache)\n",
+               c[STAT_EXACT_TRIES], c[STAT_EXACT_CACHE_HITS]);
+        printf("    Tries per (kv, ke)  :");
+        for (int i = 0; i < s.levelCount; i++) {
+            printf("%s(%d, %d) %lld", i > 0 ? ", " : " ", s.levels[i].kv, s.levels[i].ke,
+                   s.levels[i].tries);
+        }
+        printf("%s\n", s.levelCount == STATS_MAX_LEVELS ? " (last row includes later levels)" : "");
+    }
+}
+
+// Parses a comma separated --metrics list into METRIC_* bits; -1 if invalid.
+static int parseMetrics(const char* list) {
+    int metrics = 0;
+    const char* p = list;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        if (len == 8 && strncmp(p, "distance", len) == 0) metrics |= METRIC_DISTANCE;
+        else if (len == 5 && strncmp(p, "sizes", len) == 0) metrics |= METRIC_SIZES;
+        else if (len == 8 && strncmp(p, "matrices", len) == 0) metrics |= METRIC_MATRICES;
+        else if (len == 3 && strncmp(p, "all", len) == 0) metrics |= METRIC_ALL;
+        else if (!(len == 4 && strncmp(p, "none", len) == 0)) return -1;
+        p += len;
+        if (*p == ',') p++;
+    }
+    return metrics;
+}
+
+static int isAlgorithmName(const char* s) {
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (strcmp(s, ALGORITHMS[i].name) == 0) return 1;
+    }
+    return 0;
+}
+
+static int parseAlgorithm(const char* s, Algorithm* alg) {
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (strcmp(s, ALGORITHMS[i].name) == 0) {
+            *alg = ALGORITHMS[i].alg;
+            return 0;
+        }
+    }
+    printf("Unknown algorithm: %s\n", s);
+    printf("Use one of:");
+    for (int i = 0; i < ALGORITHM_COUNT; i++) printf(" '%s'", ALGORITHMS[i].name);
+    printf("\n");
+    return -1;
+}
+
+static const char* algorithmLabel(Algorithm alg) {
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (ALGORITHMS[i].alg == alg) return ALGORITHMS[i].label;
+    }
+    return "?";
+}
+
+// Split argv into "--option value" pairs and positional arguments.
+// Returns the number of positional arguments, or -1 on a malformed option.
+static int parseOptions(int argc, char** argv, RunOptions* opts, char** positional) {
+    int count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0) {
+            positional[count++] = argv[i];
+            continue;
+        }
+        if (strcmp(argv[i], "--time-limit") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->timeLimit = atof(argv[++i]);
+            if (opts->timeLimit <= 0) {
+                printf("--time-limit must be a positive number of seconds\n");
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--iso-cache-mb") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->isoCacheMB = atof(argv[++i]);
+            if (opts->isoCacheMB < 0) {
+                printf("--iso-cache-mb must not be negative\n");
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--restarts") == 0 || strcmp(argv[i], "--threads") == 0 ||
+                   strcmp(argv[i], "--rcl") == 0 || strcmp(argv[i], "--beam-width") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            int value = atoi(argv[i + 1]);
+            if (value < 0 || (value == 0 && strcmp(argv[i], "--restarts") != 0)) {
+                printf("Option %s requires a positive integer\n", argv[i]);
+                return -1;
+            }
+            if (strcmp(argv[i], "--restarts") == 0) opts->restarts = value;
+            else if (strcmp(argv[i], "--threads") == 0) opts->threads = value;
+            else if (strcmp(argv[i], "--beam-width") == 0) opts->beamWidth = value;
+            else opts->rclSize = value;
+            i++;
+        } else if (strcmp(argv[i], "--ls-iterations") == 0 || strcmp(argv[i], "--ls-time") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            double value = atof(argv[i + 1]);
+            if (value <= 0) {
+                printf("Option %s requires a positive value\n", argv[i]);
+                return -1;
+            }
+            if (strcmp(argv[i], "--ls-iterations") == 0) opts->lsIterations = (long)value;
+            else opts->lsTime = value;
+            i++;
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--distance") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            i++;
+            if (strcmp(argv[i], "auto") == 0) opts->distance = DISTANCE_AUTO;
+            else if (strcmp(argv[i], "lower") == 0) opts->distance = DISTANCE_LOWER_BOUND;
+            else if (strcmp(argv[i], "upper") == 0) opts->distance = DISTANCE_UPPER_BOUND;
+            else if (strcmp(argv[i], "assignment") == 0) opts->distance = DISTANCE_ASSIGNMENT;
+            else {
+                printf("--distance must be 'auto', 'lower', 'upper' or 'assignment'\n");
+                return -1;
+            }
+            opts->metrics |= METRIC_DISTANCE;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            opts->countEmbeddings = 1;
+        } else if (strcmp(argv[i], "--assignment-seed") == 0) {
+            opts->assignmentSeed = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            opts->stats = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->cachePath = argv[++i];
+        } else if (strcmp(argv[i], "--cache-mb") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->cacheMB = atof(argv[++i]);
+            if (opts->cacheMB < 0) {
+                printf("--cache-mb must not be negative\n");
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--count-limit") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->countLimit = atoll(argv[++i]);
+            if (opts->countLimit < 0) {
+                printf("--count-limit must not be negative\n");
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--socket") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            opts->socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            int metrics = parseMetrics(argv[++i]);
+            if (metrics < 0) {
+                printf("--metrics takes a comma separated list of 'distance', 'sizes',\n");
+                printf("'matrices', 'all' or 'none'\n");
+                return -1;
+            }
+            opts->metrics |= metrics;
+        } else if (strcmp(argv[i], "--candidates") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", argv[i]);
+                return -1;
+            }
+            i++;
+            if (strcmp(argv[i], "full") == 0) {
+                opts->candidates = GREEDY_CANDIDATES_FULL;
+            } else if (strcmp(argv[i], "frontier") == 0) {
+                opts->candidates = GREEDY_CANDIDATES_FRONTIER;
+            } else {
+                printf("--candidates must be 'full' or 'frontier'\n");
+                return -1;
+            }
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            return -1;
+        }
+    }
+    return count;
+}
+
+// Calls fn(graph, name, user) for every graph of `file`: "file" for a
+// single graph, "file@k" for the k-th graph of a container. fn takes
+// ownership of the graph. Stops at the first nonzero return.
+static int forEachGraphInFile(const char* file, int (*fn)(Graph*, const char*, void*), void* user) {
+    FILE* f = fopen(file, "r");
+    if (!f) {
+        printf("[ERROR] Cannot open graph file: %s\n", file);
+        return -1;
+    }
+    char name[512];
+    int status = 0;
+    for (int k = 0; status == 0 && !graphFileAtEnd(f); k++) {
+        Graph* g = loadGraphFromFile(f);
+        if (!g) {
+            printf("[ERROR] Failed to load graph %d from file: %s\n", k, file);
+            status = -1;
+            break;
+        }
+        if (k == 0 && graphFileAtEnd(f)) snprintf(name, sizeof(name), "%s", file);
+        else snprintf(name, sizeof(name), "%s@%d", file, k);
+        status = fn(g, name, user);
+    }
+    fclose(f);
+    return status;
+}
+
+static int addHost(Graph* H, const char* name, void* db) {
+    int status = graphDbAdd(db, H, name);
+    freeGraph(H);
+    return status;
+}
+
+// db build <db> <host files...> | db add <db> <host files...> |
+// db prepare <pattern> <out> | db query <db> <pattern or prepared pattern>
+static int runDbCommand(int npos, char** pos, const RunOptions* run) {
+    int build = strcmp(pos[0], "build") == 0;
+    if ((build || strcmp(pos[0], "add") == 0) && npos >= 3) {
+        GraphDb* db = build ? graphDbCreate() : graphDbLoad(pos[1]);
+        if (!db) {
+            printf("[ERROR] Cannot load database: %s\n", pos[1]);
+            return 1;
+        }
+        int before = db->count;
+        int status = 0;
+        for (int i = 2; status == 0 && i < npos; i++) status = forEachGraphInFile(pos[i], addHost, db);
+        if (status == 0 && graphDbSave(db, pos[1]) != 0) {
+            printf("[ERROR] Cannot write database: %s\n", pos[1]);
+            status = -1;
+        }
+        if (status == 0) {
+            printf("Database %s: %d hosts (%d added)\n", pos[1], db->count, db->count - before);
+        }
+        graphDbFree(db);
+        return status == 0 ? 0 : 1;
+    }
+
+    if (strcmp(pos[0], "prepare") == 0 && npos == 3) {
+        Graph* G = loadGraph(pos[1]);
+        if (!G) {
+            printf("[ERROR] Failed to load pattern from file: %s\n", pos[1]);
+            return 1;
+        }
+        PreparedPattern* p = preparePattern(G);
+        int status = p ? preparedPatternSave(p, pos[2]) : -1;
+        if (status == 0) printf("Prepared pattern %s: %d vertices, %d edges\n", pos[2], p->n, p->m);
+        else printf("[ERROR] Cannot write prepared pattern: %s\n", pos[2]);
+        freePreparedPattern(p);
+        freeGraph(G);
+        return status == 0 ? 0 : 1;
+    }
+
+    if (strcmp(pos[0], "query") == 0 && npos == 3) {
+        GraphDb* db = graphDbLoad(pos[1]);
+        if (!db) {
+            printf("[ERROR] Cannot load database: %s\n", pos[1]);
+            return 1;
+        }
+        // A file written by 'db prepare', or a pattern to prepare now
+        Graph* G = NULL;
+        PreparedPattern* p = preparedPatternLoad(pos[2]);
+        if (!p) {
+            G = loadGraph(pos[2]);
+            if (!G) {
+                printf("[ERROR] Failed to load pattern from file: %s\n", pos[2]);
+                graphDbFree(db);
+                return 1;
+            }
+            p = preparePattern(G);
+        }
+        bool* contains = calloc(db->count > 0 ? db->count : 1, sizeof(bool));
+        GraphDbQueryStats stats;
+        int status = p && contains ? graphDbQuery(db, p, run->threads, contains, &stats) : -1;
+        if (status == 0) {
+            for (int i = 0; i < db->count; i++) {
+                if (contains[i]) printf("%s\n", db->hosts[i]->name);
+            }
+            fprintf(stderr, "db: %d of %d hosts contain the pattern in %.3fs\n",
+                    stats.matches, stats.hosts, stats.elapsed);
+            fprintf(stderr, "db: feature index kept %d of %d hosts (filter ratio %.1f%%), "
+                    "%d more ruled out by exact counts, %d searched\n",
+                    stats.candidates, stats.hosts,
+                    stats.hosts > 0 ? 100.0 * stats.candidates / stats.hosts : 0.0,
+                    stats.rejected, stats.searched);
+        } else {
+            printf("[ERROR] Out of memory while querying %s\n", pos[1]);
+        }
+        free(contains);
+        freePreparedPattern(p);
+        freeGraph(G);
+        graphDbFree(db);
+        return status == 0 ? 0 : 1;
+    }
+
+    printf("Usage: db build <db_file> <host_files...>\n");
+    printf("       db add <db_file> <host_files...>\n");
+    printf("       db prepare <pattern_file> <prepared_file>\n");
+    printf("       db query <db_file> <pattern_file | prepared_file>\n");
+    return 1;
+}
+
+typedef struct {
+    Graph** graphs;
+    char** names;
+    int count;
+    int capacity;
+} GraphList;
+
+static int appendGraph(Graph* g, const char* name, void* user) {
+    GraphList* list = user;
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? 2 * list->capacity : 16;
+        Graph** graphs = realloc(list->graphs, capacity * sizeof(Graph*));
+        if (graphs) list->graphs = graphs;
+        char** names = realloc(list->names, capacity * sizeof(char*));
+        if (names) list->names = names;
+        if (!graphs || !names) {
+            freeGraph(g);
+            return -1;
+        }
+        list->capacity = capacity;
+    }
+    list->names[list->count] = strdup(name);
+    if (!list->names[list->count]) {
+        freeGraph(g);
+        return -1;
+    }
+    list->graphs[list->count++] = g;
+    return 0;
+}
+
+// multi <host_file> <pattern_files...>: one verdict per pattern
+static int runMultiCommand(int npos, char** pos) {
+    Graph* H = loadGraph(pos[0]);
+    if (!H) {
+        printf("[ERROR] Failed to load host graph from file: %s\n", pos[0]);
+        return 1;
+    }
+    GraphList list = {0};
+    int status = 0;
+    for (int i = 1; status == 0 && i < npos; i++) {
+        status = forEachGraphInFile(pos[i], appendGraph, &list);
+    }
+
+    PreparedHost* host = status == 0 ? prepareHost(H, pos[0]) : NULL;
+    MultiPattern* mp = host ? multiPatternBuild((const Graph* const*)list.graphs, list.count) : NULL;
+    bool* found = calloc(list.count > 0 ? list.count : 1, sizeof(bool));
+    MultiMatchStats stats;
+    if (status == 0 && (!mp || !found || multiPatternMatch(mp, host, found, &stats) != 0)) {
+        printf("[ERROR] Out of memory while matching %d patterns\n", list.count);
+        status = -1;
+    }
+    if (status == 0) {
+        for (int i = 0; i < list.count; i++) printf("%s %s\n", found[i] ? "yes" : "no", list.names[i]);
+        fprintf(stderr, "multi: %d of %d patterns embed in %s in %.3fs\n",
+                stats.found, stats.patterns, pos[0], stats.elapsed);
+        fprintf(stderr, "multi: trie has %d nodes for %d pattern vertices (%.1f%% shared), "
+                "%d patterns ruled out by feature counts, %ld extensions\n",
+                stats.trieNodes, stats.patternVertices,
+                stats.patternVertices > 0 ? 100.0 * (stats.patternVertices - stats.trieNodes) /
+                                            stats.patternVertices : 0.0,
+                stats.ruledOut, stats.extensions);
+    }
+
+    free(found);
+    multiPatternFree(mp);
+    freePreparedHost(host);
+    for (int i = 0; i < list.count; i++) {
+        freeGraph(list.graphs[i]);
+        free(list.names[i]);
+    }
+    free(list.graphs);
+    free(list.names);
+    freeGraph(H);
+    return status == 0 ? 0 : 1;
+}
+
+// dynamic <graph_G> <graph_H> <updates|->: verdict after every edge update
+static int runDynamicCommand(char** pos, const RunOptions* run) {
+    Graph* G = loadGraph(pos[0]);
+    Graph* H = G ? loadGraph(pos[1]) : NULL;
+    if (!G || !H) {
+        printf("[ERROR] Failed to load graphs from files: %s, %s\n", pos[0], pos[1]);
+        freeGraph(G);
+        return 1;
+    }
+    FILE* in = strcmp(pos[2], "-") == 0 ? stdin : fopen(pos[2], "r");
+    if (!in) {
+        printf("[ERROR] Cannot open update stream: %s\n", pos[2]);
+        freeGraph(G);
+        freeGraph(H);
+        return 1;
+    }
+
+    DynamicMode mode = run->countEmbeddings ? DYNAMIC_COUNT : DYNAMIC_VERDICT;
+    double t0 = wallSeconds();
+    DynamicMatcher* dm = dynamicMatcherCreate(G, H, mode);
+    double setup = wallSeconds() - t0;
+    int status = dm ? 0 : -1;
+    if (!dm) printf("[ERROR] Out of memory while indexing H\n");
+    int hostN = H->n;
+    freeGraph(H);
+
+    // One line per update: the update, then the verdict (and count)
+    if (dm) {
+        printf("initial %s", dynamicContains(dm) ? "yes" : "no");
+        if (mode == DYNAMIC_COUNT) printf(" %lld", dynamicEmbeddingCount(dm));
+        printf("\n");
+    }
+    char line[256];
+    long lineNo = 0, changes = 0;
+    double total = 0.0, worst = 0.0;
+    while (status == 0 && fgets(line, sizeof(line), in)) {
+        lineNo++;
+        char op;
+        int a, b;
+        char* text = line;
+        while (*text == ' ' || *text == '\t') text++;
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue;
+        if (sscanf(text, " %c %d %d", &op, &a, &b) != 3 || (op != '+' && op != '-')) {
+            printf("[ERROR] Line %ld: expected '+ u v' or '- u v'\n", lineNo);
+            status = -1;
+            break;
+        }
+        bool before = dynamicContains(dm);
+        double u0 = wallSeconds();
+        int r = op == '+' ? dynamicInsertEdge(dm, a, b) : dynamicDeleteEdge(dm, a, b);
+        double latency = wallSeconds() - u0;
+        if (r < 0) {
+            printf("[ERROR] Line %ld: invalid edge %d-%d (H has %d vertices)\n", lineNo, a, b, hostN);
+            status = -1;
+            break;
+        }
+        total += latency;
+        if (latency > worst) worst = latency;
+        if (dynamicContains(dm) != before) changes++;
+        printf("%c %d %d %s", op, a, b, dynamicContains(dm) ? "yes" : "no");
+        if (mode == DYNAMIC_COUNT) printf(" %lld", dynamicEmbeddingCount(dm));
+        printf("\n");
+    }
+
+    if (dm) {
+        DynamicStats st;
+        dynamicGetStats(dm, &st);
+        long handled = st.updates + st.ignored;
+        fprintf(stderr, "dynamic: %ld updates (%ld no-ops), %ld verdict changes, setup %.3fs, "
+                "latency mean %.1fus max %.1fus\n",
+                st.updates, st.ignored, changes, setup,
+                handled > 0 ? 1e6 * total / handled : 0.0, 1e6 * worst);
+        fprintf(stderr, "dynamic: %ld seeded searches, %ld global searches, %ld extensions\n",
+                st.seededSearches, st.globalSearches, st.extensions);
+    }
+    if (in != stdin) fclose(in);
+    dynamicMatcherFree(dm);
+    freeGraph(G);
+    return status == 0 ? 0 : 1;
 }
 
 int main(int argc, char** argv) {
     Algorithm alg = ALG_GREEDY;
     Graph *G = NULL, *H = NULL;
     const char *inputInfo = NULL;
+    char infoBuffer[512];   // "G file (G), H file (H)" in two-file mode
     int twoFileMode = 0;
+    RunOptions opts = {0};
+    opts.isoCacheMB = DEFAULT_ISO_CACHE_MB;
+    opts.cacheMB = DEFAULT_RESULT_CACHE_MB;
+    opts.countLimit = DEFAULT_COUNT_LIMIT;
+
+    char** pos = malloc((argc > 1 ? argc : 1) * sizeof(char*));
+    int npos = pos ? parseOptions(argc, argv, &opts, pos) : -1;
+    if (npos >= 0 && opts.tracePath && traceOpen(opts.tracePath) != 0) {
+        printf("[ERROR] Cannot write trace file: %s\n", opts.tracePath);
+        free(pos);
+        return 1;
+    }
+    PhaseTimes phases = {0};
+    double started = wallSeconds();
+
+    if (npos == 4 && strcmp(pos[0], "dynamic") == 0) {
+        int status = runDynamicCommand(pos + 1, &opts);
+        free(pos);
+        return status;
+    }
+
+    if (npos >= 3 && strcmp(pos[0], "multi") == 0) {
+        int status = runMultiCommand(npos - 1, pos + 1);
+        free(pos);
+        return status;
+    }
+
+    if (npos >= 2 && strcmp(pos[0], "serve") == 0) {
+        ServeOptions sopts;
+        memset(&sopts, 0, sizeof(sopts));
+        sopts.threads = opts.threads;
+        sopts.socketPath = opts.socketPath;
+        aacConfigDefaults(&sopts.config);
+        sopts.config.timeLimit = opts.timeLimit;
+        sopts.config.isoCacheBytes = cacheBytesFromMB(opts.isoCacheMB);
+        sopts.config.beamWidth = opts.beamWidth;
+        sopts.config.restarts = opts.restarts;
+        sopts.config.seed = opts.seed;
+        sopts.config.assignmentSeed = opts.assignmentSeed;
+        sopts.config.countLimit = opts.countLimit;
+        int status = runServer(pos + 1, npos - 1, &sopts);
+        free(pos);
+        return status == 0 ? 0 : 1;
+    }
+
+    if (npos >= 2 && strcmp(pos[0], "db") == 0) {
+        int status = runDbCommand(npos - 1, pos + 1, &opts);
+        free(pos);
+        return status;
+    }
 
-    if (argc < 2 || argc > 4) {
+    if (npos < 1 || npos > 3) {
         printUsage(argv[0]);
+        free(pos);
         return 1;
     }
 
-    // Determine if we're using single file or two file mode
-    // Check if argv[2] is an algorithm name or a filename
-    if (argc >= 3) {
-        if (strcmp(argv[2], "exact") == 0 || strcmp(argv[2], "greedy") == 0 || strcmp(argv[2], "subiso") == 0) {
-            // Single file mode: argv[1] = combined file, argv[2] = algorithm
-            twoFileMode = 0;
-        } else {
-            // Two file mode: argv[1] = G, argv[2] = H
-            twoFileMode = 1;
+    if (strcmp(pos[0], "batch") == 0) {
+        if (npos < 2) {
+            printUsage(argv[0]);
+            free(pos);
+            return 1;
+        }
+        const char* unsupported = opts.metrics ? "--distance/--metrics"
+                                : opts.countEmbeddings ? "--count"
+                                : opts.countLimit != DEFAULT_COUNT_LIMIT ? "--count-limit"
+                                : opts.socketPath ? "--socket" : NULL;
+        if (unsupported) {
+            printf("%s is not supported in batch mode\n", unsupported);
+            free(pos);
+            return 1;
         }
+        BatchOptions bopts = {0};
+        bopts.algorithm = npos == 3 ? pos[2] : NULL;
+        bopts.threads = opts.threads;
+        bopts.timeLimit = opts.timeLimit;
+        bopts.isoCacheBytes = cacheBytesFromMB(opts.isoCacheMB);
+        bopts.beamWidth = opts.beamWidth;
+        bopts.candidates = opts.candidates;
+        bopts.restarts = opts.restarts;
+        bopts.seed = opts.seed;
+        bopts.rclSize = opts.rclSize;
+        bopts.lsIterations = opts.lsIterations;
+        bopts.lsTime = opts.lsTime;
+        bopts.assignmentSeed = opts.assignmentSeed;
+        bopts.stats = opts.stats;
+        if (opts.cachePath) {
+            bopts.cache = resultCacheOpen(opts.cachePath, cacheBytesFromMB(opts.cacheMB));
+            if (!bopts.cache) {
+                free(pos);
+                return 1;
+            }
+        }
+        int status = runBatch(pos[1], &bopts, stdout);
+        resultCacheClose(bopts.cache);
+        free(pos);
+        return status == 0 ? 0 : 1;
+    }
+
+    // Determine if we're using single file or two file mode
+    // Check if the second positional argument is an algorithm name or a filename
+    if (npos >= 2) {
+        // Single file mode: pos[0] = combined file, pos[1] = algorithm
+        // Two file mode: pos[0] = G, pos[1] = H
+        twoFileMode = !isAlgorithmName(pos[1]);
     }
 
     if (twoFileMode) {
         // Two separate files mode
-        const char *fileG = argv[1];
-        const char *fileH = argv[2];
+        const char *fileG = pos[0];
+        const char *fileH = pos[1];
         
         // Parse algorithm if provided
-        if (argc == 4) {
-            if (strcmp(argv[3], "exact") == 0) {
-                alg = ALG_EXACT;
-            } else if (strcmp(argv[3], "greedy") == 0) {
-                alg = ALG_GREEDY;
-            } else if (strcmp(argv[3], "subiso") == 0) {
-                alg = ALG_SUBISO_ONLY;
-            } else {
-                printf("Unknown algorithm: %s\n", argv[3]);
-                printf("Use 'greedy', 'exact', or 'subiso'\n");
-                return 1;
-            }
+        if (npos == 3 && parseAlgorithm(pos[2], &alg) != 0) {
+            free(pos);
+            return 1;
         }
         
         G = loadGraph(fileG);
         if (!G) {
             printf("[ERROR] Failed to load graph G from file: %s\n", fileG);
+            free(pos);
             return 1;
         }
         
@@ -327,39 +1287,44 @@ int main(int argc, char** argv) {
         if (!H) {
             printf("[ERROR] Failed to load graph H from file: %s\n", fileH);
             freeGraph(G);
+            free(pos);
             return 1;
         }
         
         // Create input info string for display
-        static char infoBuffer[512];
         snprintf(infoBuffer, sizeof(infoBuffer), "%s (G), %s (H)", fileG, fileH);
         inputInfo = infoBuffer;
     } else {
         // Single combined file mode
-        const char *inputFile = argv[1];
+        const char *inputFile = pos[0];
         
         // Parse algorithm if provided
-        if (argc == 3) {
-            if (strcmp(argv[2], "exact") == 0) {
-                alg = ALG_EXACT;
-            } else if (strcmp(argv[2], "greedy") == 0) {
-                alg = ALG_GREEDY;
-            } else if (strcmp(argv[2], "subiso") == 0) {
-                alg = ALG_SUBISO_ONLY;
-            } else {
-                printf("Unknown algorithm: %s\n", argv[2]);
-                printf("Use 'greedy', 'exact', or 'subiso'\n");
-                return 1;
-            }
+        if (npos == 2 && parseAlgorithm(pos[1], &alg) != 0) {
+            free(pos);
+            return 1;
+        }
+        if (npos == 3) {
+            printUsage(argv[0]);
+            free(pos);
+            return 1;
         }
         
         if (loadBothGraphs(inputFile, &G, &H) != 0) {
             printf("[ERROR] Failed to load graphs from file: %s\n", inputFile);
+            free(pos);
             return 1;
         }
         
         inputInfo = inputFile;
     }
+    free(pos);
+    phases.load = wallSeconds() - started;
+    traceEnd(started, "load");
+    statsReset();
+
+    // Start the distance estimate first so it overlaps with everything else
+    DistanceJob distJob;
+    if (opts.metrics & METRIC_DISTANCE) startDistance(&distJob, G, H, &opts);
 
     printf("\n");
     printf("================================================\n");
@@ -367,52 +1332,117 @@ int main(int argc, char** argv) {
     printf("================================================\n");
     printf("\n");
     printf("  Input: %s\n", inputInfo);
-    printf("  Algorithm : %s\n", alg == ALG_EXACT ? "Exact" : (alg == ALG_GREEDY ? "Greedy" : "Subiso only"));
+    printf("  Algorithm : %s\n", algorithmLabel(alg));
     printf("\n");
     printf("  +-------------------------------------------+\n");
     printf("  |  GRAPH G (Pattern)                       |\n");
     printf("  |    Vertices: %-4d    Edges: %-4d         |\n", G->n, G->m);
-    printf("  |    Size S(G) = |V|+|E| = %-4d            |\n", graphSize(G));
+    if (opts.metrics & METRIC_SIZES) {
+        printf("  |    Size S(G) = |V|+|E| = %-4d            |\n", graphSize(G));
+    }
     printf("  +-------------------------------------------+\n");
     printf("  |  GRAPH H (Host)                          |\n");
     printf("  |    Vertices: %-4d    Edges: %-4d         |\n", H->n, H->m);
-    printf("  |    Size S(H) = |V|+|E| = %-4d            |\n", graphSize(H));
-    printf("  +-------------------------------------------+\n");
-    printf("  |  GRAPH DISTANCE METRIC                   |\n");
-    printf("  |    d(G, H) = %-4d                        |\n", graphDistance(G, H));
+    if (opts.metrics & METRIC_SIZES) {
+        printf("  |    Size S(H) = |V|+|E| = %-4d            |\n", graphSize(H));
+    }
     printf("  +-------------------------------------------+\n");
     printf("\n");
 
     // Print adjacency matrices for the input graphs
-    printAdjacencyMatrix(G, "G");
-    printAdjacencyMatrix(H, "H");
-    printf("\n");
+    if (opts.metrics & METRIC_MATRICES) {
+        printAdjacencyMatrix(G, "G");
+        printAdjacencyMatrix(H, "H");
+        printf("\n");
+    }
+    fflush(stdout);
 
-    printf("  Checking subgraph isomorphism...\n");
-    bool result = isSubgraphIsomorphic(G, H);
+    ResultCache* cache = NULL;
+    ResultKey key;
+    CachedResult cached;
+    bool hit = false;
+    if (opts.cachePath) {
+        cache = resultCacheOpen(opts.cachePath, cacheBytesFromMB(opts.cacheMB));
+        if (cache) {
+            ResultParams params;
+            resultParamsFromRun(&params, &opts, alg);
+            resultKeyInit(&key, G, H, &params);
+            hit = resultCacheLookup(cache, &key, &cached);
+        }
+    }
+
+    bool result;
+    if (hit) {
+        printf("  Found in the result cache (solver skipped).\n");
+        result = cached.subiso;
+    } else {
+        printf("  Checking subgraph isomorphism...\n");
+        double t0 = wallSeconds();
+        result = isSubgraphIsomorphic(G, H);
+        phases.subiso = wallSeconds() - t0;
+        traceEnd(t0, "subiso");
+    }
+    CachedResult record = { result, result, -1, 0, 0, NULL };
+    bool solved = result;
 
     if (result) {
         printf("\n  [OK] G is isomorphic to a subgraph of H!\n");
         if (alg != ALG_SUBISO_ONLY) {
             printf("       No extension needed.\n");
         }
-        printf("\n================================================\n");
     } else {
         printf("\n  [X] G is NOT isomorphic to any subgraph of H.\n");
         
-        if (alg == ALG_SUBISO_ONLY) {
-            printf("\n================================================\n");
-        } else {
+        if (alg != ALG_SUBISO_ONLY && hit) {
+            printCachedExtension(G, H, &cached, &opts);
+        } else if (alg != ALG_SUBISO_ONLY) {
             printf("      Computing minimal extension to make H contain G...\n");
-            
-            if (alg == ALG_GREEDY) {
-                runGreedyExtension(G, H);
+            double t0 = wallSeconds();
+
+            if (alg == ALG_GREEDY || alg == ALG_GREEDY_LS) {
+                solved = runGreedyExtension(G, H, &opts, alg == ALG_GREEDY_LS, &record);
+            } else if (alg == ALG_BEAM) {
+                solved = runBeamExtension(G, H, &opts, &record);
+            } else if (opts.timeLimit > 0) {
+                solved = runAnytimeExactExtension(G, H, &opts, &record);
             } else {
-                runExactExtension(G, H);
+                solved = runExactExtension(G, H, &opts, &record);
             }
+            phases.extension = wallSeconds() - t0;
+            traceEnd(t0, "extension");
         }
     }
 
+    if (cache) {
+        // Anytime results that are not proven optimal could still improve
+        bool store = !hit && (solved || alg == ALG_SUBISO_ONLY) &&
+                     (alg != ALG_EXACT || record.optimal);
+        if (store && resultCacheStore(cache, &key, &record) != 0) {
+            printf("\n  [WARNING] Could not write to the result cache %s\n", opts.cachePath);
+            store = false;
+        }
+        ResultCacheStats cs;
+        resultCacheGetStats(cache, &cs);
+        printf("\n  [RESULT CACHE] %s - %s, %ld entries (%.2f MB)\n",
+               hit ? "hit" : (store ? "miss, result stored" : "miss"),
+               opts.cachePath, cs.entries, cs.bytes / (1024.0 * 1024.0));
+        resultCacheClose(cache);
+        if (hit) free(cached.edges);
+    }
+    free(record.edges);
+
+    if (opts.metrics & METRIC_DISTANCE) {
+        printDistance(&distJob);
+        phases.distance = distJob.seconds;
+    }
+    if (opts.stats) {
+        phases.total = wallSeconds() - started;
+        printRunStats(&phases, &opts);
+    }
+    if (result || alg == ALG_SUBISO_ONLY || (opts.metrics & METRIC_DISTANCE) || opts.stats) {
+        printf("\n================================================\n");
+    }
+
     freeGraph(G);
     freeGraph(H);
     return 0;
@@ -0,0 +1,297 @@
+#include <stdlib.h>
+#include <string.h>
+#include "multimatch.h"
+#include "timing.h"
+#include "trace.h"
+
+typedef struct {
+    int depth;           // vertices placed after this node; its vertex sits at depth - 1
+    int up;              // parent node (-1 for the root)
+    int* back;           // earlier positions the new vertex is adjacent to, ascending
+    int backCount;
+    int source;          // back position whose image's neighbours are the candidates (-1 = all)
+    int minDegree;       // smallest degree of this vertex over the patterns through the node
+    int* children;
+    int childCount;
+    int childCap;
+    int* ends;           // patterns whose last vertex is this one
+    int endCount;
+    int endCap;
+    int patternsBelow;   // patterns ending at this node or below
+} TrieNode;
+
+struct MultiPattern {
+    TrieNode* nodes;     // nodes[0] is the root
+    int nodeCount;
+    int nodeCap;
+    int patterns;
+    int patternVertices;
+    int maxDepth;
+    PreparedPattern** prepared;  // per pattern: feature counts for the pre-filter
+};
+
+static int pushInt(int** array, int* count, int* cap, int value) {
+    if (*count == *cap) {
+        int grown = *cap ? 2 * *cap : 4;
+        int* a = realloc(*array, grown * sizeof(int));
+        if (!a) return -1;
+        *array = a;
+        *cap = grown;
+    }
+    (*array)[(*count)++] = value;
+    return 0;
+}
+
+static int newNode(MultiPattern* mp, int up, const int* back, int backCount, int source) {
+    if (mp->nodeCount == mp->nodeCap) {
+        int grown = mp->nodeCap ? 2 * mp->nodeCap : 64;
+        TrieNode* nodes = realloc(mp->nodes, grown * sizeof(TrieNode));
+        if (!nodes) return -1;
+        mp->nodes = nodes;
+        mp->nodeCap = grown;
+    }
+    TrieNode* node = &mp->nodes[mp->nodeCount];
+    memset(node, 0, sizeof(*node));
+    node->up = up;
+    node->depth = up >= 0 ? mp->nodes[up].depth + 1 : 0;
+    node->source = source;
+    node->minDegree = -1;
+    if (backCount > 0) {
+        node->back = malloc(backCount * sizeof(int));
+        if (!node->back) return -1;
+        memcpy(node->back, back, backCount * sizeof(int));
+    }
+    node->backCount = backCount;
+    return mp->nodeCount++;
+}
+
+void multiPatternFree(MultiPattern* mp) {
+    if (!mp) return;
+    for (int i = 0; i < mp->nodeCount; i++) {
+        free(mp->nodes[i].back);
+        free(mp->nodes[i].children);
+        free(mp->nodes[i].ends);
+    }
+    free(mp->nodes);
+    if (mp->prepared) {
+        for (int i = 0; i < mp->patterns; i++) freePreparedPattern(mp->prepared[i]);
+    }
+    free(mp->prepared);
+    free(mp);
+}
+
+// Positions of v's placed neighbours, ascending, into out. Returns the count.
+static int backPositions(const Graph* G, int v, const int* pos, int* out) {
+    int k = 0;
+    for (int j = 0; j < G->adjSize[v]; j++) {
+        int q = pos[G->adj[v][j]];
+        if (q < 0) continue;
+        int i = k++;
+        while (i > 0 && out[i - 1] > q) { out[i] = out[i - 1]; i--; }
+        out[i] = q;
+    }
+    return k;
+}
+
+// Follows (or creates) one trie path for G and records G at its end.
+static int insertPattern(MultiPattern* mp, const Graph* G, int index) {
+    int n = G->n;
+    int len = n > 0 ? n : 1;
+    int* pos = malloc(len * sizeof(int));
+    int* back = malloc(len * sizeof(int));
+    int* placedNeighbours = calloc(len, sizeof(int));
+    int status = pos && back && placedNeighbours ? 0 : -1;
+    for (int v = 0; status == 0 && v < n; v++) pos[v] = -1;
+
+    int node = 0;
+    for (int d = 0; status == 0 && d < n; d++) {
+        // Prefer an existing child: the first one some unplaced vertex fits,
+        // taking the highest-degree such vertex.
+        int nextNode = -1, chosen = -1;
+        for (int c = 0; c < mp->nodes[node].childCount && nextNode < 0; c++) {
+            const TrieNode* child = &mp->nodes[mp->nodes[node].children[c]];
+            for (int v = 0; v < n; v++) {
+                if (pos[v] >= 0 || placedNeighbours[v] != child->backCount) continue;
+                if (chosen >= 0 && G->adjSize[v] <= G->adjSize[chosen]) continue;
+                int k = backPositions(G, v, pos, back);
+                if (k == child->backCount &&
+                    (k == 0 || memcmp(back, child->back, k * sizeof(int)) == 0)) {
+                    chosen = v;
+                }
+            }
+            if (chosen >= 0) nextNode = mp->nodes[node].children[c];
+        }
+
+        if (nextNode < 0) {
+            // New branch: most placed neighbours, then highest degree
+            for (int v = 0; v < n; v++) {
+                if (pos[v] >= 0) continue;
+                if (chosen < 0 || placedNeighbours[v] > placedNeighbours[chosen] ||
+                    (placedNeighbours[v] == placedNeighbours[chosen] &&
+                     G->adjSize[v] > G->adjSize[chosen])) {
+                    chosen = v;
+                }
+            }
+            int k = backPositions(G, chosen, pos, back);
+            int source = -1;
+            for (int j = 0; j < G->adjSize[chosen]; j++) {
+                int u = G->adj[chosen][j];
+                if (pos[u] >= 0 && (source < 0 || G->adjSize[u] < G->adjSize[source])) source = u;
+            }
+            nextNode = newNode(mp, node, back, k, source >= 0 ? pos[source] : -1);
+            if (nextNode < 0 ||
+                pushInt(&mp->nodes[node].children, &mp->nodes[node].childCount,
+                        &mp->nodes[node].childCap, nextNode) != 0) {
+                status = -1;
+                break;
+            }
+        }
+
+        TrieNode* next = &mp->nodes[nextNode];
+        if (next->minDegree < 0 || G->adjSize[chosen] < next->minDegree) next->minDegree = G->adjSize[chosen];
+        pos[chosen] = d;
+        for (int j = 0; j < G->adjSize[chosen]; j++) placedNeighbours[G->adj[chosen][j]]++;
+        node = nextNode;
+    }
+
+    if (status == 0) {
+        TrieNode* end = &mp->nodes[node];
+        status = pushInt(&end->ends, &end->endCount, &end->endCap, index);
+        for (int a = node; status == 0 && a >= 0; a = mp->nodes[a].up) mp->nodes[a].patternsBelow++;
+        if (end->depth > mp->maxDepth) mp->maxDepth = end->depth;
+    }
+    free(pos);
+    free(back);
+    free(placedNeighbours);
+    return status;
+}
+
+MultiPattern* multiPatternBuild(const Graph* const* patterns, int count) {
+    MultiPattern* mp = calloc(1, sizeof(MultiPattern));
+    if (!mp) return NULL;
+    mp->prepared = calloc(count > 0 ? count : 1, sizeof(PreparedPattern*));
+    if (!mp->prepared || newNode(mp, -1, NULL, 0, -1) != 0) {
+        multiPatternFree(mp);
+        return NULL;
+    }
+    mp->patterns = count;
+    for (int i = 0; i < count; i++) {
+        mp->patternVertices += patterns[i]->n;
+        mp->prepared[i] = preparePattern(patterns[i]);
+        if (!mp->prepared[i] || insertPattern(mp, patterns[i], i) != 0) {
+            multiPatternFree(mp);
+            return NULL;
+        }
+    }
+    return mp;
+}
+
+typedef struct {
+    const MultiPattern* mp;
+    const PreparedHost* host;
+    bool* found;
+    int* pending;         // per node: patterns below not answered yet
+    int* map;             // position -> host vertex
+    uint64_t* used;
+    long extensions;
+} MultiSearch;
+
+static void answerEnds(MultiSearch* s, int nodeIndex) {
+    const TrieNode* node = &s->mp->nodes[nodeIndex];
+    for (int e = 0; e < node->endCount; e++) {
+        int p = node->ends[e];
+        if (s->found[p]) continue;
+        s->found[p] = true;
+        for (int a = nodeIndex; a >= 0; a = s->mp->nodes[a].up) s->pending[a]--;
+    }
+}
+
+static void extendNode(MultiSearch* s, int nodeIndex) {
+    const TrieNode* node = &s->mp->nodes[nodeIndex];
+    const PreparedHost* h = s->host;
+    int position = node->depth - 1;
+
+    const int* cand = NULL;
+    int count = h->n;
+    if (node->source >= 0) {
+        int img = s->map[node->source];
+        cand = h->adj + h->adjStart[img];
+        count = h->adjStart[img + 1] - h->adjStart[img];
+    }
+
+    for (int i = 0; i < count && s->pending[nodeIndex] > 0; i++) {
+        int c = cand ? cand[i] : i;
+        if (s->used[c >> 6] & (1ULL << (c & 63))) continue;
+        if (h->degree[c] < node->minDegree) continue;
+        const uint64_t* row = h->bits + (size_t)c * h->words;
+        bool ok = true;
+        for (int b = 0; b < node->backCount; b++) {
+            int img = s->map[node->back[b]];
+            if (!(row[img >> 6] & (1ULL << (img & 63)))) {
+                ok = false;
+                break;
+            }
+        }
+        s->extensions++;
+        if (!ok) continue;
+
+        s->map[position] = c;
+        s->used[c >> 6] |= 1ULL << (c & 63);
+        answerEnds(s, nodeIndex);
+        for (int k = 0; k < node->childCount; k++) {
+            if (s->pending[node->children[k]] > 0) extendNode(s, node->children[k]);
+        }
+        s->used[c >> 6] &= ~(1ULL << (c & 63));
+    }
+}
+
+int multiPatternMatch(const MultiPattern* mp, const PreparedHost* host,
+                      bool* found, MultiMatchStats* stats) {
+    double t0 = wallSeconds();
+    MultiSearch s = { mp, host, found, NULL, NULL, NULL, 0 };
+    s.pending = malloc(mp->nodeCount * sizeof(int));
+    s.map = malloc((mp->maxDepth > 0 ? mp->maxDepth : 1) * sizeof(int));
+    s.used = calloc(host->words > 0 ? host->words : 1, sizeof(uint64_t));
+    if (!s.pending || !s.map || !s.used) {
+        free(s.pending);
+        free(s.map);
+        free(s.used);
+        return -1;
+    }
+    for (int i = 0; i < mp->nodeCount; i++) s.pending[i] = mp->nodes[i].patternsBelow;
+    memset(found, 0, mp->patterns * sizeof(bool));
+
+    // Patterns the host's feature counts rule out are settled as "no" up
+    // front, which prunes trie branches that only they use.
+    int ruledOut = 0;
+    double traceStart = traceBegin();
+    for (int n = 0; n < mp->nodeCount; n++) {
+        for (int e = 0; e < mp->nodes[n].endCount; e++) {
+            if (preparedInvariantsAllow(mp->prepared[mp->nodes[n].ends[e]], host)) continue;
+            ruledOut++;
+            for (int a = n; a >= 0; a = mp->nodes[a].up) s.pending[a]--;
+        }
+    }
+    traceEndArgs(traceStart, "prefilter", "patterns", mp->patterns, "ruled_out", ruledOut);
+
+    answerEnds(&s, 0);  // empty patterns
+    const TrieNode* root = &mp->nodes[0];
+    for (int k = 0; k < root->childCount; k++) {
+        if (s.pending[root->children[k]] > 0) extendNode(&s, root->children[k]);
+    }
+
+    if (stats) {
+        stats->patterns = mp->patterns;
+        stats->trieNodes = mp->nodeCount - 1;
+        stats->patternVertices = mp->patternVertices;
+        stats->ruledOut = ruledOut;
+        stats->found = 0;
+        for (int i = 0; i < mp->patterns; i++) stats->found += found[i];
+        stats->extensions = s.extensions;
+        stats->elapsed = wallSeconds() - t0;
+    }
+    free(s.pending);
+    free(s.map);
+    free(s.used);
+    return 0;
+}
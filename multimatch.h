@@ -0,0 +1,52 @@
+#ifndef MULTIMATCH_H
+#define MULTIMATCH_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "graphdb.h"
+
+/**
+ * =============================================================================
+ * MULTI-PATTERN MATCHING
+ * =============================================================================
+ * Decides for many patterns at once whether each embeds in one host (same
+ * non-induced semantics as isSubgraphIsomorphic).
+ *
+ * The patterns' matching orders are merged into a trie. A trie node stands
+ * for "place one more vertex, adjacent exactly to these earlier positions";
+ * patterns whose first k vertices induce the same edges in the same order
+ * share the first k nodes. When a pattern is inserted, each step follows an
+ * existing child if some unplaced vertex of the pattern fits it, so
+ * patterns built around a common core reuse that core's path.
+ *
+ * The search walks the trie depth-first over the host: every partial
+ * embedding of a shared prefix is found once and then extended along each
+ * child. A pattern is answered as soon as an embedding reaches its end
+ * node, and subtrees whose patterns are all answered are skipped.
+ * =============================================================================
+ */
+
+typedef struct MultiPattern MultiPattern;
+
+typedef struct {
+    int patterns;         // patterns in the set
+    int trieNodes;        // trie nodes below the root
+    int patternVertices;  // total pattern vertices (nodes without sharing)
+    int ruledOut;         // patterns rejected by feature counts before search
+    int found;            // patterns that embed in the host
+    long extensions;      // host vertices tried at trie nodes
+    double elapsed;       // wall-clock seconds
+} MultiMatchStats;
+
+/** Builds the trie over count patterns (graphs are not kept). NULL if memory runs out. */
+MultiPattern* multiPatternBuild(const Graph* const* patterns, int count);
+void multiPatternFree(MultiPattern* mp);
+
+/**
+ * Sets found[i] to whether pattern i embeds in host. `stats` may be NULL.
+ * Returns 0, or -1 if memory runs out.
+ */
+int multiPatternMatch(const MultiPattern* mp, const PreparedHost* host,
+                      bool* found, MultiMatchStats* stats);
+
+#endif // MULTIMATCH_H
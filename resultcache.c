@@ -0,0 +1,429 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "resultcache.h"
+
+static const char CACHE_MAGIC[8] = { 'A', 'A', 'C', 'R', 'C', 'C', '0', '1' };
+
+// On-disk record header, followed by 2 * edgeCount int32 endpoints
+typedef struct {
+    uint32_t bytes;        // whole record, header included
+    uint32_t edgeCount;
+    uint64_t g[2];
+    uint64_t h[2];
+    uint64_t params;
+    int32_t newVertices;
+    int32_t lowerBound;
+    uint8_t subiso;
+    uint8_t optimal;
+    uint8_t pad[6];
+} RecordHeader;
+
+typedef struct CacheEntry {
+    RecordHeader rec;
+    int32_t* edges;
+    struct CacheEntry* chain;   // next entry in the same bucket
+    struct CacheEntry* older;   // file order
+    struct CacheEntry* newer;
+} CacheEntry;
+
+struct ResultCache {
+    char* path;
+    int fd;
+    long indexed;               // bytes of the current file read into the index
+    size_t maxBytes;
+    CacheEntry** buckets;
+    int bucketCount;            // power of two
+    CacheEntry* oldest;
+    CacheEntry* newest;
+    pthread_mutex_t lock;
+    ResultCacheStats stats;
+};
+
+static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t mixBytes(uint64_t h, const void* data, size_t size) {
+    const unsigned char* p = data;
+    for (size_t i = 0; i < size; i++) h = mix(h ^ p[i]);
+    return h;
+}
+
+void resultKeyInit(ResultKey* key, const Graph* G, const Graph* H, const ResultParams* p) {
+    memset(key, 0, sizeof(*key));
+    graphContentHash(G, key->g);
+    graphContentHash(H, key->h);
+
+    uint64_t h = mix(RESULT_CACHE_VERSION);
+    h = mixBytes(h, p->algorithm, strlen(p->algorithm) + 1);
+    if (strncmp(p->algorithm, "greedy", 6) == 0) {
+        h = mixBytes(h, &p->timeLimit, sizeof(p->timeLimit));
+        h = mix(h ^ (uint64_t)p->restarts);
+        h = mix(h ^ p->seed);
+        h = mix(h ^ (uint64_t)p->rclSize);
+        h = mix(h ^ (uint64_t)p->candidates);
+        h = mix(h ^ (uint64_t)p->assignmentSeed);
+        if (strcmp(p->algorithm, "greedy+ls") == 0) {
+            h = mix(h ^ (uint64_t)p->lsIterations);
+            h = mixBytes(h, &p->lsTime, sizeof(p->lsTime));
+        }
+    } else if (strcmp(p->algorithm, "beam") == 0) {
+        h = mix(h ^ (uint64_t)p->beamWidth);
+    }
+    key->params = h;
+}
+
+static bool sameKey(const RecordHeader* rec, const ResultKey* key) {
+    return rec->g[0] == key->g[0] && rec->g[1] == key->g[1] &&
+           rec->h[0] == key->h[0] && rec->h[1] == key->h[1] && rec->params == key->params;
+}
+
+static int bucketOf(const ResultCache* c, const uint64_t g[2], const uint64_t h[2], uint64_t params) {
+    return (int)(mix(g[0] ^ mix(h[0] ^ mix(params))) & (uint64_t)(c->bucketCount - 1));
+}
+
+// --- In-memory index ---
+
+static void unlinkEntry(ResultCache* c, CacheEntry* e) {
+    CacheEntry** slot = &c->buckets[bucketOf(c, e->rec.g, e->rec.h, e->rec.params)];
+    while (*slot != e) slot = &(*slot)->chain;
+    *slot = e->chain;
+    if (e->older) e->older->newer = e->newer;
+    else c->oldest = e->newer;
+    if (e->newer) e->newer->older = e->older;
+    else c->newest = e->older;
+    c->stats.entries--;
+    c->stats.bytes -= e->rec.bytes;
+}
+
+static void growBuckets(ResultCache* c) {
+    int count = c->bucketCount * 2;
+    CacheEntry** buckets = calloc(count, sizeof(CacheEntry*));
+    if (!buckets) return;  // keep the longer chains
+    free(c->buckets);
+    c->buckets = buckets;
+    c->bucketCount = count;
+    for (CacheEntry* e = c->oldest; e; e = e->newer) {
+        int b = bucketOf(c, e->rec.g, e->rec.h, e->rec.params);
+        e->chain = c->buckets[b];
+        c->buckets[b] = e;
+    }
+}
+
+static CacheEntry* findEntry(const ResultCache* c, const ResultKey* key) {
+    CacheEntry* e = c->buckets[bucketOf(c, key->g, key->h, key->params)];
+    while (e && !sameKey(&e->rec, key)) e = e->chain;
+    return e;
+}
+
+// Adds e as the newest entry, replacing an older one with the same key.
+static void insertEntry(ResultCache* c, CacheEntry* e) {
+    ResultKey key;
+    memcpy(key.g, e->rec.g, sizeof(key.g));
+    memcpy(key.h, e->rec.h, sizeof(key.h));
+    key.params = e->rec.params;
+    CacheEntry* old = findEntry(c, &key);
+    if (old) {
+        unlinkEntry(c, old);
+        free(old->edges);
+        free(old);
+    }
+    if (c->stats.entries >= 2L * c->bucketCount) growBuckets(c);
+    int b = bucketOf(c, e->rec.g, e->rec.h, e->rec.params);
+    e->chain = c->buckets[b];
+    c->buckets[b] = e;
+    e->older = c->newest;
+    e->newer = NULL;
+    if (c->newest) c->newest->newer = e;
+    else c->oldest = e;
+    c->newest = e;
+    c->stats.entries++;
+    c->stats.bytes += e->rec.bytes;
+}
+
+// --- File ---
+
+static int writeAll(int fd, const void* data, size_t size) {
+    const char* p = data;
+    while (size > 0) {
+        ssize_t w = write(fd, p, size);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        p += w;
+        size -= (size_t)w;
+    }
+    return 0;
+}
+
+// Reads the records of the open file from offset `from` (0 = the whole
+// file, magic included) into the index. Returns the end of the valid part,
+// or -1 if the file is not a result cache.
+static long loadRecords(ResultCache* c, long from) {
+    struct stat st;
+    if (fstat(c->fd, &st) != 0) return -1;
+    if (st.st_size <= from) return from == 0 ? 0 : (long)st.st_size;
+    size_t size = (size_t)(st.st_size - from);
+    char* data = malloc(size);
+    if (!data) return -1;
+    size_t got = 0;
+    while (got < size) {
+        ssize_t r = pread(c->fd, data + got, size - got, (off_t)(from + got));
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += (size_t)r;
+    }
+    size_t pos = 0;
+    if (from == 0) {
+        if (got < sizeof(CACHE_MAGIC) || memcmp(data, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+            free(data);
+            return -1;
+        }
+        pos = sizeof(CACHE_MAGIC);
+    }
+    while (pos + sizeof(RecordHeader) <= got) {
+        RecordHeader rec;
+        memcpy(&rec, data + pos, sizeof(rec));
+        size_t edgeBytes = (size_t)rec.edgeCount * 2 * sizeof(int32_t);
+        if (rec.bytes != sizeof(RecordHeader) + edgeBytes || pos + rec.bytes > got) break;
+        CacheEntry* e = calloc(1, sizeof(CacheEntry));
+        if (!e) break;
+        e->rec = rec;
+        if (edgeBytes > 0) {
+            e->edges = malloc(edgeBytes);
+            if (!e->edges) {
+                free(e);
+                break;
+            }
+            memcpy(e->edges, data + pos + sizeof(RecordHeader), edgeBytes);
+        }
+        insertEntry(c, e);
+        pos += rec.bytes;
+    }
+    free(data);
+    return from + (long)pos;
+}
+
+ResultCache* resultCacheOpen(const char* path, size_t maxBytes) {
+    ResultCache* c = calloc(1, sizeof(ResultCache));
+    if (!c) return NULL;
+    c->path = strdup(path);
+    c->bucketCount = 256;
+    c->buckets = calloc(c->bucketCount, sizeof(CacheEntry*));
+    c->maxBytes = maxBytes;
+    c->fd = c->path && c->buckets ? open(path, O_RDWR | O_CREAT, 0644) : -1;
+    pthread_mutex_init(&c->lock, NULL);
+    if (c->fd < 0) {
+        fprintf(stderr, "result cache: cannot open %s: %s\n", path, strerror(errno));
+        resultCacheClose(c);
+        return NULL;
+    }
+
+    flock(c->fd, LOCK_EX);
+    long valid = loadRecords(c, 0);
+    if (valid == 0) {
+        valid = writeAll(c->fd, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 ? (long)sizeof(CACHE_MAGIC) : -1;
+    }
+    struct stat st;
+    if (valid > 0 && fstat(c->fd, &st) == 0 && st.st_size > valid) {
+        // Torn tail from an interrupted writer
+        if (ftruncate(c->fd, valid) != 0) valid = -1;
+    }
+    flock(c->fd, LOCK_UN);
+    if (valid < 0) {
+        fprintf(stderr, "result cache: %s is not a result cache file\n", path);
+        resultCacheClose(c);
+        return NULL;
+    }
+    c->indexed = valid;
+    return c;
+}
+
+void resultCacheClose(ResultCache* c) {
+    if (!c) return;
+    CacheEntry* e = c->oldest;
+    while (e) {
+        CacheEntry* next = e->newer;
+        free(e->edges);
+        free(e);
+        e = next;
+    }
+    if (c->fd >= 0) close(c->fd);
+    pthread_mutex_destroy(&c->lock);
+    free(c->buckets);
+    free(c->path);
+    free(c);
+}
+
+// Takes the file lock on the current cache file. Another process may have
+// compacted it into a new inode meanwhile; then the new one is opened.
+static void lockCurrentFile(ResultCache* c) {
+    for (;;) {
+        flock(c->fd, LOCK_EX);
+        struct stat onDisk, held;
+        if (stat(c->path, &onDisk) != 0 || fstat(c->fd, &held) != 0 ||
+            (onDisk.st_ino == held.st_ino && onDisk.st_dev == held.st_dev)) {
+            return;
+        }
+        int fd = open(c->path, O_RDWR);
+        if (fd < 0) return;
+        close(c->fd);  // drops the lock on the replaced file
+        c->fd = fd;
+        c->indexed = 0;
+    }
+}
+
+// Indexes the records other processes appended since this one last read
+// the file, so that a compaction keeps them. Caller holds the file lock.
+// Returns -1 if the file cannot be read.
+static int indexNewRecords(ResultCache* c) {
+    long valid = loadRecords(c, c->indexed);
+    if (valid < 0) return -1;
+    struct stat st;
+    if (fstat(c->fd, &st) == 0 && st.st_size > valid) {
+        // Torn tail from a writer that died mid-record
+        if (ftruncate(c->fd, valid) != 0) return -1;
+    }
+    c->indexed = valid;
+    return 0;
+}
+
+// Rewrites the file with the newest entries that fit in 3/4 of the cap.
+// Caller holds the lock and the file lock.
+static void compact(ResultCache* c) {
+    size_t budget = c->maxBytes / 4 * 3;
+    size_t kept = sizeof(CACHE_MAGIC);
+    CacheEntry* first = c->newest;
+    while (first && kept + first->rec.bytes <= budget) {
+        kept += first->rec.bytes;
+        first = first->older;
+    }
+    // Entries older than `first`'s successor are dropped
+    first = first ? first->newer : c->oldest;
+
+    size_t tmpLen = strlen(c->path) + 8;
+    char* tmp = malloc(tmpLen);
+    if (!tmp) return;
+    snprintf(tmp, tmpLen, "%s.tmp", c->path);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int ok = fd >= 0 && writeAll(fd, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0;
+    for (CacheEntry* e = first; ok && e; e = e->newer) {
+        ok = writeAll(fd, &e->rec, sizeof(RecordHeader)) == 0 &&
+             writeAll(fd, e->edges, (size_t)e->rec.edgeCount * 2 * sizeof(int32_t)) == 0;
+    }
+    if (fd >= 0) close(fd);
+    if (!ok || rename(tmp, c->path) != 0) {
+        unlink(tmp);
+        free(tmp);
+        return;
+    }
+    free(tmp);
+
+    while (c->oldest != first) {
+        CacheEntry* e = c->oldest;
+        unlinkEntry(c, e);
+        free(e->edges);
+        free(e);
+        c->stats.evictions++;
+    }
+    // The caller still holds the flock on the old file, which is released
+    // when it is closed here; later writers find the new one.
+    int newFd = open(c->path, O_RDWR);
+    if (newFd >= 0) {
+        close(c->fd);
+        c->fd = newFd;
+        c->indexed = (long)kept;
+    }
+}
+
+bool resultCacheLookup(ResultCache* c, const ResultKey* key, CachedResult* out) {
+    pthread_mutex_lock(&c->lock);
+    CacheEntry* e = findEntry(c, key);
+    bool hit = false;
+    if (e) {
+        memset(out, 0, sizeof(*out));
+        out->subiso = e->rec.subiso;
+        out->optimal = e->rec.optimal;
+        out->lowerBound = e->rec.lowerBound;
+        out->newVertices = e->rec.newVertices;
+        out->newEdges = (int)e->rec.edgeCount;
+        if (out->newEdges > 0) {
+            out->edges = malloc(out->newEdges * sizeof(*out->edges));
+            if (out->edges) {
+                for (int i = 0; i < out->newEdges; i++) {
+                    out->edges[i][0] = e->edges[2 * i];
+                    out->edges[i][1] = e->edges[2 * i + 1];
+                }
+            }
+        }
+        hit = out->newEdges == 0 || out->edges != NULL;
+    }
+    if (hit) c->stats.hits++;
+    else c->stats.misses++;
+    pthread_mutex_unlock(&c->lock);
+    return hit;
+}
+
+int resultCacheStore(ResultCache* c, const ResultKey* key, const CachedResult* result) {
+    CacheEntry* e = calloc(1, sizeof(CacheEntry));
+    size_t edgeBytes = (size_t)result->newEdges * 2 * sizeof(int32_t);
+    size_t bytes = sizeof(RecordHeader) + edgeBytes;
+    char* record = malloc(bytes);
+    if (!e || !record || (edgeBytes > 0 && !(e->edges = malloc(edgeBytes)))) {
+        if (e) free(e->edges);
+        free(e);
+        free(record);
+        return -1;
+    }
+    e->rec.bytes = (uint32_t)bytes;
+    e->rec.edgeCount = (uint32_t)result->newEdges;
+    memcpy(e->rec.g, key->g, sizeof(key->g));
+    memcpy(e->rec.h, key->h, sizeof(key->h));
+    e->rec.params = key->params;
+    e->rec.newVertices = result->newVertices;
+    e->rec.lowerBound = result->lowerBound;
+    e->rec.subiso = result->subiso;
+    e->rec.optimal = result->optimal;
+    for (int i = 0; i < result->newEdges; i++) {
+        e->edges[2 * i] = result->edges[i][0];
+        e->edges[2 * i + 1] = result->edges[i][1];
+    }
+    memcpy(record, &e->rec, sizeof(RecordHeader));
+    if (edgeBytes > 0) memcpy(record + sizeof(RecordHeader), e->edges, edgeBytes);
+
+    pthread_mutex_lock(&c->lock);
+    lockCurrentFile(c);
+    int status = indexNewRecords(c) == 0 && lseek(c->fd, c->indexed, SEEK_SET) >= 0 &&
+                 writeAll(c->fd, record, bytes) == 0 ? 0 : -1;
+    if (status == 0) {
+        c->indexed += (long)bytes;
+        insertEntry(c, e);
+        c->stats.stores++;
+        struct stat st;
+        if (c->maxBytes > 0 && fstat(c->fd, &st) == 0 && (size_t)st.st_size > c->maxBytes) {
+            compact(c);
+        }
+    } else {
+        free(e->edges);
+        free(e);
+    }
+    flock(c->fd, LOCK_UN);
+    pthread_mutex_unlock(&c->lock);
+    free(record);
+    return status;
+}
+
+void resultCacheGetStats(ResultCache* c, ResultCacheStats* stats) {
+    pthread_mutex_lock(&c->lock);
+    *stats = c->stats;
+    pthread_mutex_unlock(&c->lock);
+}
@@ -0,0 +1,99 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+/**
+ * =============================================================================
+ * PERSISTENT RESULT CACHE
+ * =============================================================================
+ * Stores finished results (subiso verdict, extension cost and the added
+ * edges) in a file, so that a (G, H, algorithm) job seen in an earlier run
+ * is answered without solving it again.
+ *
+ * A key is the 128-bit content hash of G and of H (graphContentHash) plus a
+ * hash of the algorithm, the settings that can change its answer and
+ * RESULT_CACHE_VERSION. Content hashes are of the labelled graphs: the
+ * stored edges use H's vertex numbers, so a relabelled H must not hit.
+ *
+ * The file is an append-only log of records; a record for a key replaces
+ * earlier ones. A torn record at the end (a run killed mid-write) is cut
+ * off when the file is next opened. Writers hold an flock on the file and
+ * first index the records other processes appended, so several processes
+ * may share one cache. Once the file grows past
+ * `maxBytes` it is rewritten with only the newest entries, down to three
+ * quarters of the cap.
+ *
+ * Lookups and stores are thread-safe.
+ * =============================================================================
+ */
+
+// Bump when a solver change makes stored answers stale.
+#define RESULT_CACHE_VERSION 2
+
+typedef struct ResultCache ResultCache;
+
+typedef struct {
+    uint64_t g[2];       // graphContentHash of G
+    uint64_t h[2];       // graphContentHash of H
+    uint64_t params;     // algorithm, its answer-changing settings, version
+} ResultKey;
+
+/** The settings that go into a key; the ones an algorithm ignores are skipped. */
+typedef struct {
+    const char* algorithm;    // "greedy", "greedy+ls", "beam", "exact", "subiso"
+    double timeLimit;         // greedy: restart budget
+    int restarts;
+    unsigned long long seed;
+    int rclSize;
+    int candidates;           // GreedyCandidateMode
+    int assignmentSeed;
+    long lsIterations;
+    double lsTime;
+    int beamWidth;
+} ResultParams;
+
+typedef struct {
+    bool subiso;
+    bool optimal;
+    int lowerBound;           // -1 if none
+    int newVertices;
+    int newEdges;
+    int (*edges)[2];          // newEdges added edges (malloc'd by lookup)
+} CachedResult;
+
+typedef struct {
+    long hits;
+    long misses;
+    long stores;
+    long evictions;           // entries dropped when the file was compacted
+    long entries;             // entries currently in the file
+    size_t bytes;             // bytes those entries take
+} ResultCacheStats;
+
+/**
+ * Opens (or creates) the cache file and reads its entries. maxBytes = 0
+ * means no cap. Returns NULL if the file cannot be opened or is not a
+ * result cache.
+ */
+ResultCache* resultCacheOpen(const char* path, size_t maxBytes);
+void resultCacheClose(ResultCache* cache);
+
+void resultKeyInit(ResultKey* key, const Graph* G, const Graph* H, const ResultParams* params);
+
+/**
+ * On a hit fills *out (free out->edges with free) and returns true.
+ * Exact results should only be stored when optimal: an exact key does
+ * not include the time limit.
+ */
+bool resultCacheLookup(ResultCache* cache, const ResultKey* key, CachedResult* out);
+
+/** Appends the result to the file. Returns 0, or -1 on an I/O error. */
+int resultCacheStore(ResultCache* cache, const ResultKey* key, const CachedResult* result);
+
+void resultCacheGetStats(ResultCache* cache, ResultCacheStats* stats);
+
+#endif // RESULTCACHE_H
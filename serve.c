@@ -0,0 +1,564 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "aac.h"
+#include "timing.h"
+#include "serve.h"
+#include "trace.h"
+
+#define SERVE_LINE_MAX 4096
+#define SERVE_ID_MAX 128
+#define SERVE_PATTERN_MAX ((size_t)256 << 20)
+
+/**
+ * One client stream. Answers are written by whichever worker finishes a
+ * query, so writes are serialised by `lock`; the stream is closed only
+ * after its last pending query has been answered.
+ */
+typedef struct {
+    FILE* in;
+    FILE* out;
+    pthread_mutex_t lock;
+    pthread_cond_t idle;
+    int pending;
+} Connection;
+
+typedef struct Query {
+    Connection* conn;
+    char id[SERVE_ID_MAX];
+    int host;
+    bool count;           // 'count' rather than an extension algorithm
+    AacAlgorithm alg;
+    char* text;           // the pattern, parsed by the worker
+    size_t length;
+    struct Query* next;
+} Query;
+
+typedef struct {
+    AacGraph** hosts;
+    char** names;
+    int hostCount;
+    AacConfig config;
+
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    Query* head;
+    Query* tail;
+    int size;
+    int capacity;
+    int closed;
+
+    struct Client* clients;    // open socket connections, under `lock`
+    pthread_cond_t clientsDone;
+
+    long answered;
+    long failed;
+} Server;
+
+// --- Queue ---
+
+static void pushQuery(Server* sv, Query* q) {
+    pthread_mutex_lock(&sv->lock);
+    while (sv->size >= sv->capacity) pthread_cond_wait(&sv->notFull, &sv->lock);
+    q->next = NULL;
+    if (sv->tail) sv->tail->next = q;
+    else sv->head = q;
+    sv->tail = q;
+    sv->size++;
+    pthread_cond_signal(&sv->notEmpty);
+    pthread_mutex_unlock(&sv->lock);
+}
+
+// Returns NULL once the queue is closed and drained.
+static Query* popQuery(Server* sv) {
+    pthread_mutex_lock(&sv->lock);
+    while (!sv->head && !sv->closed) pthread_cond_wait(&sv->notEmpty, &sv->lock);
+    Query* q = sv->head;
+    if (q) {
+        sv->head = q->next;
+        if (!sv->head) sv->tail = NULL;
+        sv->size--;
+        pthread_cond_signal(&sv->notFull);
+    }
+    pthread_mutex_unlock(&sv->lock);
+    return q;
+}
+
+static void closeQueue(Server* sv) {
+    pthread_mutex_lock(&sv->lock);
+    sv->closed = 1;
+    pthread_cond_broadcast(&sv->notEmpty);
+    pthread_mutex_unlock(&sv->lock);
+}
+
+// --- Answers ---
+
+static void writeJsonString(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+// Caller holds conn->lock.
+static void writeError(Connection* conn, const char* id, const char* error) {
+    fprintf(conn->out, "{\"id\":");
+    writeJsonString(conn->out, id);
+    fprintf(conn->out, ",\"status\":\"error\",\"error\":");
+    writeJsonString(conn->out, error);
+    fprintf(conn->out, "}\n");
+    fflush(conn->out);
+}
+
+static void answerError(Server* sv, Connection* conn, const char* id, const char* error) {
+    pthread_mutex_lock(&conn->lock);
+    writeError(conn, id, error);
+    pthread_mutex_unlock(&conn->lock);
+    __atomic_fetch_add(&sv->answered, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sv->failed, 1, __ATOMIC_RELAXED);
+}
+
+static void answerHosts(Server* sv, Connection* conn, const char* id) {
+    pthread_mutex_lock(&conn->lock);
+    fprintf(conn->out, "{\"id\":");
+    writeJsonString(conn->out, id);
+    fprintf(conn->out, ",\"status\":\"ok\",\"hosts\":[");
+    for (int i = 0; i < sv->hostCount; i++) {
+        fprintf(conn->out, "%s{\"name\":", i > 0 ? "," : "");
+        writeJsonString(conn->out, sv->names[i]);
+        fprintf(conn->out, ",\"n\":%d,\"m\":%d}",
+                aacGraphVertices(sv->hosts[i]), aacGraphEdges(sv->hosts[i]));
+    }
+    fprintf(conn->out, "]}\n");
+    fflush(conn->out);
+    pthread_mutex_unlock(&conn->lock);
+    __atomic_fetch_add(&sv->answered, 1, __ATOMIC_RELAXED);
+}
+
+static void solveQuery(Server* sv, AacContext* ctx, Query* q) {
+    Connection* conn = q->conn;
+    const AacGraph* H = sv->hosts[q->host];
+    double t0 = wallSeconds();
+    AacGraph* G = aacGraphParse(q->text, q->length);
+    double parsed = wallSeconds();
+
+    AacResult r;
+    long long count = 0;
+    bool complete = true;
+    int status = AAC_ERR_INVALID;
+    if (G) status = q->count ? aacCount(ctx, G, H, &count, &complete) : aacSolve(ctx, G, H, q->alg, &r);
+    double solved = wallSeconds();
+
+    pthread_mutex_lock(&conn->lock);
+    if (!G) {
+        writeError(conn, q->id, "cannot parse pattern");
+    } else if (status != AAC_OK) {
+        writeError(conn, q->id, aacStatusString(status));
+    } else {
+        FILE* out = conn->out;
+        fprintf(out, "{\"id\":");
+        writeJsonString(out, q->id);
+        fprintf(out, ",\"host\":");
+        writeJsonString(out, sv->names[q->host]);
+        fprintf(out, ",\"query\":\"%s\",\"status\":\"ok\",\"n_g\":%d,\"m_g\":%d",
+                q->count ? "count" : aacAlgorithmName(q->alg), aacGraphVertices(G), aacGraphEdges(G));
+        if (q->count) {
+            fprintf(out, ",\"count\":%lld,\"complete\":%s", count, complete ? "true" : "false");
+        } else {
+            fprintf(out, ",\"subiso\":%s", r.contains ? "true" : "false");
+            if (r.solved) {
+                fprintf(out, ",\"cost\":%d,\"new_vertices\":%d,\"new_edges\":%d",
+                        r.newVertices + r.newEdges, r.newVertices, r.newEdges);
+                if (q->alg == AAC_ALG_EXACT) {
+                    fprintf(out, ",\"optimal\":%s", r.optimal ? "true" : "false");
+                    if (r.lowerBound >= 0) fprintf(out, ",\"lower_bound\":%d", r.lowerBound);
+                }
+            }
+        }
+        fprintf(out, ",\"parse_ms\":%.3f,\"solve_ms\":%.3f}\n",
+                (parsed - t0) * 1000.0, (solved - parsed) * 1000.0);
+        fflush(out);
+    }
+    conn->pending--;
+    pthread_cond_signal(&conn->idle);
+    pthread_mutex_unlock(&conn->lock);
+
+    if (!G || status != AAC_OK) __atomic_fetch_add(&sv->failed, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sv->answered, 1, __ATOMIC_RELAXED);
+    aacGraphFree(G);
+}
+
+static void* workerThread(void* arg) {
+    Server* sv = arg;
+    AacContext* ctx = aacContextCreate(&sv->config);
+    Query* q;
+    traceThreadName("serve worker");
+    while ((q = popQuery(sv)) != NULL) {
+        if (ctx) {
+            double traceStart = traceBegin();
+            solveQuery(sv, ctx, q);
+            traceEndArgs(traceStart, q->count ? "count query" : "query", "host", q->host,
+                         "alg", q->alg);
+        } else {
+            pthread_mutex_lock(&q->conn->lock);
+            writeError(q->conn, q->id, aacStatusString(AAC_ERR_NOMEM));
+            q->conn->pending--;
+            pthread_cond_signal(&q->conn->idle);
+            pthread_mutex_unlock(&q->conn->lock);
+            __atomic_fetch_add(&sv->answered, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&sv->failed, 1, __ATOMIC_RELAXED);
+        }
+        free(q->text);
+        free(q);
+    }
+    aacContextFree(ctx);
+    return NULL;
+}
+
+// --- Requests ---
+
+static int findHost(const Server* sv, const char* name) {
+    for (int i = 0; i < sv->hostCount; i++) {
+        if (strcmp(sv->names[i], name) == 0) return i;
+    }
+    char* end;
+    long index = strtol(name, &end, 10);
+    if (*name && *end == '\0' && index >= 0 && index < sv->hostCount) return (int)index;
+    return -1;
+}
+
+// Reads the requests of one connection until it ends, then waits for its
+// pending answers.
+static void readRequests(Server* sv, Connection* conn) {
+    char line[SERVE_LINE_MAX];
+    while (fgets(line, sizeof(line), conn->in)) {
+        if (!strchr(line, '\n') && !feof(conn->in)) {
+            answerError(sv, conn, "", "request line too long");
+            break;
+        }
+        char id[SERVE_ID_MAX], query[32], host[SERVE_LINE_MAX];
+        unsigned long long length;
+        int fields = sscanf(line, "%127s %31s %4095s %llu", id, query, host, &length);
+        if (fields <= 0) continue;  // blank line
+
+        if (fields >= 2 && strcmp(query, "hosts") == 0) {
+            answerHosts(sv, conn, id);
+            continue;
+        }
+        if (fields < 4 || length > SERVE_PATTERN_MAX) {
+            answerError(sv, conn, id, fields < 4 ? "expected '<id> <query> <host> <length>'"
+                                                 : "pattern too large");
+            break;  // the stream cannot be re-framed
+        }
+
+        char* text = malloc(length + 1);
+        if (!text || fread(text, 1, length, conn->in) != length) {
+            answerError(sv, conn, id, text ? "truncated pattern" : "out of memory");
+            free(text);
+            break;
+        }
+        text[length] = '\0';
+
+        Query* q = calloc(1, sizeof(Query));
+        int hostIndex = findHost(sv, host);
+        bool count = strcmp(query, "count") == 0;
+        AacAlgorithm alg = AAC_ALG_SUBISO;
+        const char* error = NULL;
+        if (!q) error = "out of memory";
+        else if (hostIndex < 0) error = "unknown host";
+        else if (!count && aacAlgorithmFromName(query, &alg) != AAC_OK) error = "unknown query";
+        if (error) {
+            answerError(sv, conn, id, error);
+            free(text);
+            free(q);
+            continue;
+        }
+
+        q->conn = conn;
+        snprintf(q->id, sizeof(q->id), "%s", id);
+        q->host = hostIndex;
+        q->count = count;
+        q->alg = alg;
+        q->text = text;
+        q->length = length;
+        pthread_mutex_lock(&conn->lock);
+        conn->pending++;
+        pthread_mutex_unlock(&conn->lock);
+        pushQuery(sv, q);
+    }
+
+    pthread_mutex_lock(&conn->lock);
+    while (conn->pending > 0) pthread_cond_wait(&conn->idle, &conn->lock);
+    pthread_mutex_unlock(&conn->lock);
+}
+
+static void initConnection(Connection* conn, FILE* in, FILE* out) {
+    memset(conn, 0, sizeof(*conn));
+    conn->in = in;
+    conn->out = out;
+    pthread_mutex_init(&conn->lock, NULL);
+    pthread_cond_init(&conn->idle, NULL);
+}
+
+static void destroyConnection(Connection* conn) {
+    pthread_mutex_destroy(&conn->lock);
+    pthread_cond_destroy(&conn->idle);
+}
+
+// --- Socket ---
+
+typedef struct Client {
+    Server* sv;
+    Connection conn;
+    int fd;
+    struct Client* prev;
+    struct Client* next;
+} Client;
+
+// SIGINT and SIGTERM write a byte here, which wakes the accept loop so
+// that the server shuts down through the normal path: pending queries are
+// answered and the trace is written at exit.
+static int stopPipe[2] = { -1, -1 };
+
+static void onStopSignal(int sig) {
+    (void)sig;
+    int saved = errno;
+    ssize_t r = write(stopPipe[1], "", 1);
+    (void)r;
+    errno = saved;
+}
+
+static void* clientThread(void* arg) {
+    Client* c = arg;
+    readRequests(c->sv, &c->conn);
+
+    Server* sv = c->sv;
+    pthread_mutex_lock(&sv->lock);
+    if (c->prev) c->prev->next = c->next;
+    else sv->clients = c->next;
+    if (c->next) c->next->prev = c->prev;
+    if (!sv->clients) pthread_cond_broadcast(&sv->clientsDone);
+    pthread_mutex_unlock(&sv->lock);
+
+    fclose(c->conn.in);
+    fclose(c->conn.out);
+    destroyConnection(&c->conn);
+    free(c);
+    return NULL;
+}
+
+static int listenOn(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "serve: socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // A socket left behind by an earlier server is replaced; anything else is not
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        fprintf(stderr, "serve: cannot listen on %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Accepts connections until a stop signal arrives.
+static void acceptClients(Server* sv, int listener) {
+    struct pollfd fds[2] = { { listener, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "serve: poll failed: %s\n", strerror(errno));
+            return;
+        }
+        if (fds[1].revents) return;
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN ||
+                errno == EWOULDBLOCK) continue;
+            fprintf(stderr, "serve: accept failed: %s\n", strerror(errno));
+            return;
+        }
+        Client* c = malloc(sizeof(Client));
+        int outFd = dup(fd);
+        FILE* in = fdopen(fd, "r");
+        FILE* out = outFd >= 0 ? fdopen(outFd, "w") : NULL;
+        pthread_t tid;
+        if (!c || !in || !out) {
+            free(c);
+            if (in) fclose(in);
+            else close(fd);
+            if (out) fclose(out);
+            else if (outFd >= 0) close(outFd);
+            continue;
+        }
+        c->sv = sv;
+        initConnection(&c->conn, in, out);
+        c->fd = fd;
+        c->prev = NULL;
+        pthread_mutex_lock(&sv->lock);
+        c->next = sv->clients;
+        if (c->next) c->next->prev = c;
+        sv->clients = c;
+        pthread_mutex_unlock(&sv->lock);
+        if (pthread_create(&tid, NULL, clientThread, c) != 0) {
+            clientThread(c);  // serve it on this thread instead
+            continue;
+        }
+        pthread_detach(tid);
+    }
+}
+
+// Closes the listener, removes its socket file and restores the default
+// handling of the stop signals.
+static void stopListening(int listener, const char* path) {
+    close(listener);
+    unlink(path);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    stopPipe[0] = stopPipe[1] = -1;
+}
+
+// Ends the open connections as if their clients had stopped sending:
+// queries already read are still answered. Returns once all are closed.
+static void stopClients(Server* sv) {
+    pthread_mutex_lock(&sv->lock);
+    for (Client* c = sv->clients; c; c = c->next) shutdown(c->fd, SHUT_RD);
+    while (sv->clients) pthread_cond_wait(&sv->clientsDone, &sv->lock);
+    pthread_mutex_unlock(&sv->lock);
+}
+
+// --- Server ---
+
+static void freeHosts(Server* sv) {
+    for (int i = 0; i < sv->hostCount; i++) aacGraphFree(sv->hosts[i]);
+    free(sv->hosts);
+}
+
+int runServer(char** hostFiles, int hostCount, const ServeOptions* opts) {
+    Server sv;
+    memset(&sv, 0, sizeof(sv));
+    sv.config = opts->config;
+
+    double t0 = wallSeconds();
+    sv.hosts = calloc(hostCount > 0 ? hostCount : 1, sizeof(AacGraph*));
+    sv.names = hostFiles;
+    if (!sv.hosts) return -1;
+    for (int i = 0; i < hostCount; i++) {
+        sv.hosts[i] = aacGraphLoad(hostFiles[i]);
+        if (!sv.hosts[i] || aacGraphPrepareHost(sv.hosts[i]) != AAC_OK) {
+            fprintf(stderr, "serve: cannot load host graph %s\n", hostFiles[i]);
+            sv.hostCount = sv.hosts[i] ? i + 1 : i;
+            freeHosts(&sv);
+            return -1;
+        }
+        sv.hostCount = i + 1;
+    }
+    double loaded = wallSeconds() - t0;
+
+    int listener = -1;
+    if (opts->socketPath) {
+        listener = listenOn(opts->socketPath);
+        if (listener < 0) {
+            freeHosts(&sv);
+            return -1;
+        }
+        // A client that disconnects early must not take the server down
+        signal(SIGPIPE, SIG_IGN);
+        // accept only after poll reports a connection, which may be gone by then
+        fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+        if (pipe(stopPipe) != 0) {
+            fprintf(stderr, "serve: cannot create pipe: %s\n", strerror(errno));
+            close(listener);
+            freeHosts(&sv);
+            return -1;
+        }
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = onStopSignal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+    }
+
+    int threads = opts->threads;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    sv.capacity = 4 * threads;
+    pthread_mutex_init(&sv.lock, NULL);
+    pthread_cond_init(&sv.notEmpty, NULL);
+    pthread_cond_init(&sv.notFull, NULL);
+    pthread_cond_init(&sv.clientsDone, NULL);
+
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    int running = 0;
+    for (int t = 0; workers && t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, workerThread, &sv) != 0) break;
+        running++;
+    }
+    if (running == 0) {
+        fprintf(stderr, "serve: cannot start worker threads\n");
+        if (listener >= 0) stopListening(listener, opts->socketPath);
+        free(workers);
+        freeHosts(&sv);
+        return -1;
+    }
+
+    fprintf(stderr, "serve: %d host%s loaded and prepared in %.3fs, %d worker%s, %s%s\n",
+            hostCount, hostCount == 1 ? "" : "s", loaded, running, running == 1 ? "" : "s",
+            listener >= 0 ? "listening on " : "reading stdin",
+            listener >= 0 ? opts->socketPath : "");
+
+    double started = wallSeconds();
+    if (listener >= 0) {
+        acceptClients(&sv, listener);
+        stopListening(listener, opts->socketPath);
+        stopClients(&sv);
+    } else {
+        Connection conn;
+        initConnection(&conn, stdin, stdout);
+        readRequests(&sv, &conn);
+        destroyConnection(&conn);
+    }
+    double elapsed = wallSeconds() - started;
+
+    closeQueue(&sv);
+    for (int t = 0; t < running; t++) pthread_join(workers[t], NULL);
+    free(workers);
+    pthread_mutex_destroy(&sv.lock);
+    pthread_cond_destroy(&sv.notEmpty);
+    pthread_cond_destroy(&sv.notFull);
+    pthread_cond_destroy(&sv.clientsDone);
+
+    fprintf(stderr, "serve: %ld queries answered (%ld failed) in %.3fs\n",
+            sv.answered, sv.failed, elapsed);
+    freeHosts(&sv);
+    return 0;
+}
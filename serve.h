@@ -0,0 +1,47 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "aac.h"
+
+/**
+ * =============================================================================
+ * SERVER MODE
+ * =============================================================================
+ * Loads host graphs once, builds their matching structures once, then
+ * answers pattern queries about them until the input ends. Query latency
+ * covers parsing the (small) pattern and solving, never host loading.
+ *
+ * Requests arrive on stdin, or on a local UNIX socket where every
+ * connection is a separate stream. Each request is a header line,
+ *
+ *     <id> <query> <host> <length>
+ *
+ * followed by exactly <length> bytes holding the pattern in the usual
+ * adjacency-matrix text format. <id> is any token (echoed back), <query>
+ * is 'subiso', 'greedy', 'greedy+ls', 'beam', 'exact' or 'count', and
+ * <host> is a host's file name as given at start-up or its 0-based
+ * index. The line '<id> hosts' lists the loaded hosts.
+ *
+ * Requests are handed to a pool of workers, each with its own AacContext,
+ * so queries from one or many connections are solved concurrently. Every
+ * answer is one JSON object per line, written when its query finishes
+ * (match answers to requests by "id"). A header that cannot be framed
+ * (no length) ends the connection after an error answer.
+ * =============================================================================
+ */
+
+typedef struct {
+    int threads;             // workers (<= 0 = available processors)
+    const char* socketPath;  // listen here instead of reading stdin (NULL = stdin)
+    AacConfig config;        // solver settings for every query
+} ServeOptions;
+
+/**
+ * Serves queries about the graphs in hostFiles. With stdin it returns at
+ * end of input; with a socket it returns after SIGINT or SIGTERM, once
+ * the queries already read are answered.
+ * Returns 0, or -1 if a host could not be loaded or the socket not opened.
+ */
+int runServer(char** hostFiles, int hostCount, const ServeOptions* opts);
+
+#endif // SERVE_H
@@ -0,0 +1,89 @@
+#include <string.h>
+#include <sys/resource.h>
+#include "stats.h"
+
+#ifdef AAC_STATS
+_Thread_local SearchStats threadStats;
+#endif
+
+static const char* const COUNTER_NAMES[STAT_COUNT] = {
+    "subiso_calls",
+    "subiso_nodes",
+    "subiso_candidates",
+    "pruned_degree",
+    "pruned_consistency",
+    "pruned_feasibility",
+    "match_calls",
+    "match_nodes",
+    "match_pruned",
+    "exact_tries",
+    "exact_cache_hits",
+};
+
+bool statsEnabled(void) {
+#ifdef AAC_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void statsReset(void) {
+#ifdef AAC_STATS
+    memset(&threadStats, 0, sizeof(threadStats));
+#endif
+}
+
+void statsSnapshot(SearchStats* out) {
+#ifdef AAC_STATS
+    *out = threadStats;
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+void statsRecordLevel(int kv, int ke, long long tries) {
+#ifdef AAC_STATS
+    SearchStats* s = &threadStats;
+    for (int i = s->levelCount - 1; i >= 0; i--) {
+        if (s->levels[i].kv == kv && s->levels[i].ke == ke) {
+            s->levels[i].tries += tries;
+            return;
+        }
+    }
+    if (s->levelCount == STATS_MAX_LEVELS) {
+        s->levels[STATS_MAX_LEVELS - 1].tries += tries;
+        return;
+    }
+    s->levels[s->levelCount].kv = kv;
+    s->levels[s->levelCount].ke = ke;
+    s->levels[s->levelCount].tries = tries;
+    s->levelCount++;
+#else
+    (void)kv; (void)ke; (void)tries;
+#endif
+}
+
+const char* statCounterName(StatCounter c) {
+    return (c >= 0 && c < STAT_COUNT) ? COUNTER_NAMES[c] : "?";
+}
+
+long statsPeakRssKB(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return ru.ru_maxrss;  // kilobytes on Linux
+}
+
+void statsWriteJson(FILE* out, const SearchStats* stats) {
+    for (int c = 0; c < STAT_COUNT; c++) {
+        fprintf(out, "%s\"%s\":%lld", c > 0 ? "," : "", COUNTER_NAMES[c], stats->counters[c]);
+    }
+    if (stats->levelCount > 0) {
+        fprintf(out, ",\"exact_levels\":[");
+        for (int i = 0; i < stats->levelCount; i++) {
+            fprintf(out, "%s{\"kv\":%d,\"ke\":%d,\"tries\":%lld}", i > 0 ? "," : "",
+                    stats->levels[i].kv, stats->levels[i].ke, stats->levels[i].tries);
+        }
+        fputc(']', out);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * =============================================================================
+ * SEARCH STATISTICS
+ * =============================================================================
+ * Counters bumped from the hot paths of the matchers and the exact search:
+ * how many search nodes were visited, what each pruning test rejected and
+ * how many H' graphs the exact search built per (kv, ke) level.
+ *
+ * The counters only exist in builds compiled with -DAAC_STATS (`make
+ * STATS=1`; off by default, as they slow the prepared matcher by 15-25%).
+ * Without it STAT_INC, STAT_ADD and STAT_LEVEL expand to nothing and
+ * STAT_GET to 0, so the hot loops are exactly the plain code, and
+ * statsSnapshot reports zeros.
+ *
+ * Every thread counts into its own block: a run reads the work done by the
+ * calling thread since its last statsReset. Work done on helper threads
+ * (beam levels, greedy restarts, db queries) is not included.
+ * =============================================================================
+ */
+
+typedef enum {
+    STAT_SUBISO_CALLS,         // isSubgraphIsomorphic calls
+    STAT_SUBISO_NODES,         // subgraphRec calls (search tree nodes)
+    STAT_SUBISO_CANDIDATES,    // (G vertex, H vertex) pairs examined
+    STAT_PRUNE_DEGREE,         // ... rejected: H vertex degree too small
+    STAT_PRUNE_CONSISTENCY,    // ... rejected: an edge to a mapped vertex is missing
+    STAT_PRUNE_FEASIBILITY,    // ... rejected: an unmapped neighbour has no candidate
+    STAT_MATCH_CALLS,          // prepared matcher runs (db, multi, serve, libaac)
+    STAT_MATCH_NODES,          // prepared matcher: positions filled
+    STAT_MATCH_PRUNED,         // prepared matcher: candidates rejected
+    STAT_EXACT_TRIES,          // exact: H' graphs built and tested
+    STAT_EXACT_CACHE_HITS,     // exact: verdicts answered by the isomorphism cache
+    STAT_COUNT
+} StatCounter;
+
+// Per (kv, ke) levels kept by one run; later levels are summed into the last.
+#define STATS_MAX_LEVELS 64
+
+typedef struct {
+    int kv;
+    int ke;
+    long long tries;
+} StatsLevel;
+
+typedef struct {
+    long long counters[STAT_COUNT];
+    int levelCount;
+    StatsLevel levels[STATS_MAX_LEVELS];
+} SearchStats;
+
+#ifdef AAC_STATS
+extern _Thread_local SearchStats threadStats;
+#define STAT_INC(c) (threadStats.counters[c]++)
+#define STAT_ADD(c, v) (threadStats.counters[c] += (v))
+#define STAT_GET(c) (threadStats.counters[c])
+#define STAT_LEVEL(kv, ke, tries) statsRecordLevel((kv), (ke), (tries))
+#else
+#define STAT_INC(c) ((void)0)
+#define STAT_ADD(c, v) ((void)0)
+#define STAT_GET(c) 0LL
+#define STAT_LEVEL(kv, ke, tries) ((void)(tries))
+#endif
+
+/** True when the counters are compiled in. */
+bool statsEnabled(void);
+
+/** Clears the calling thread's counters. */
+void statsReset(void);
+
+/** Copies the calling thread's counters. */
+void statsSnapshot(SearchStats* out);
+
+/** Adds `tries` to the (kv, ke) level of the calling thread's block. */
+void statsRecordLevel(int kv, int ke, long long tries);
+
+/** Short name of a counter, also its JSON key ("subiso_nodes"). */
+const char* statCounterName(StatCounter c);
+
+/** Peak resident set size of the process in kilobytes (0 if unknown). */
+long statsPeakRssKB(void);
+
+/** Writes the counters and levels as the members of a JSON object. */
+void statsWriteJson(FILE* out, const SearchStats* stats);
+
+#endif // STATS_H
@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "subiso.h"
+#include "stats.h"
 
 static bool subgraphRec(
     const Graph* G, const Graph* H,
@@ -35,6 +36,7 @@ static void computeNewAdjH(bool* adj, const Graph* g, int v, bool* used) {
 bool isSubgraphIsomorphic(const Graph* G, const Graph* H) {
     // H must be at least as large as G
     if (H->n < G->n) return false;
+    STAT_INC(STAT_SUBISO_CALLS);
 
     int* map = malloc(G->n * sizeof(int));
     bool* usedH = calloc(H->n, sizeof(bool));
@@ -54,6 +56,47 @@ bool isSubgraphIsomorphic(const Graph* G, const Graph* H) {
     return result;
 }
 
+bool subisoCandidateFeasible(const Graph* G, const Graph* H, const int* map,
+                             const bool* usedH, int n, int m) {
+    // Degree check
+    if (G->adjSize[n] > H->adjSize[m]) {
+        STAT_INC(STAT_PRUNE_DEGREE);
+        return false;
+    }
+
+    // Adjacency consistency check
+    for (int g2 = 0; g2 < G->n; g2++) {
+        if (map[g2] == -1) continue;
+        int h2 = map[g2];
+
+        if (G->matrix[n][g2] && !H->matrix[m][h2]) {
+            STAT_INC(STAT_PRUNE_CONSISTENCY);
+            return false;
+        }
+    }
+
+    // Neighborhood feasibility check
+    for (int i = 0; i < G->adjSize[n]; i++) {
+        int nu = G->adj[n][i];
+        if (map[nu] != -1) continue;
+
+        bool hasCandidate = false;
+        for (int j = 0; j < H->adjSize[m]; j++) {
+            int mu = H->adj[m][j];
+            if (!usedH[mu] && H->adjSize[mu] >= G->adjSize[nu]) {
+                hasCandidate = true;
+                break;
+            }
+        }
+
+        if (!hasCandidate) {
+            STAT_INC(STAT_PRUNE_FEASIBILITY);
+            return false;
+        }
+    }
+    return true;
+}
+
 static int chooseVertex(bool* adj, int n, int* map) {
     for (int i = 0; i < n; i++)
         if (adj[i] && map[i] == -1)
@@ -75,6 +118,7 @@ static bool subgraphRec(
     bool* adjH,
     int mapped
 ) {
+    STAT_INC(STAT_SUBISO_NODES);
     if (mapped == G->n)
         return true;
 
@@ -102,46 +146,8 @@ static bool subgraphRec(
 
         if (usedH[m]) continue;
         if (hasAdjH && !adjH[m]) continue;
-
-        // Degree check
-        if (G->adjSize[n] > H->adjSize[m])
-            continue;
-
-        // Adjacency consistency check
-        bool consistent = true;
-        for (int g2 = 0; g2 < G->n; g2++) {
-            if (map[g2] == -1) continue;
-            int h2 = map[g2];
-
-            if (G->matrix[n][g2] && !H->matrix[m][h2]) {
-                consistent = false;
-                break;
-            }
-        }
-        if (!consistent) continue;
-
-        // Neighborhood feasibility check
-        bool feasible = true;
-
-        for (int i = 0; i < G->adjSize[n]; i++) {
-            int nu = G->adj[n][i];
-            if (map[nu] != -1) continue;
-
-            bool hasCandidate = false;
-            for (int j = 0; j < H->adjSize[m]; j++) {
-                int mu = H->adj[m][j];
-                if (!usedH[mu] && H->adjSize[mu] >= G->adjSize[nu]) {
-                    hasCandidate = true;
-                    break;
-                }
-            }
-
-            if (!hasCandidate) {
-                feasible = false;
-                break;
-            }
-        }
-        if (!feasible) continue;
+        STAT_INC(STAT_SUBISO_CANDIDATES);
+        if (!subisoCandidateFeasible(G, H, map, usedH, n, m)) continue;
 
         // --- Accept mapping ---
         map[n] = m;
@@ -6,4 +6,14 @@
 
 bool isSubgraphIsomorphic(const Graph* G, const Graph* H);
 
+/**
+ * The per-candidate checks of the search: may G vertex v map to the unused
+ * H vertex m, given the partial mapping `map` (G -> H, -1 = unmapped) and
+ * the H vertices in use? Checks the degrees, the edges to already-mapped
+ * vertices, and that every unmapped neighbour of v still has a candidate
+ * among m's neighbours. Exposed for the kernel benchmark.
+ */
+bool subisoCandidateFeasible(const Graph* G, const Graph* H, const int* map,
+                             const bool* usedH, int v, int m);
+
 #endif
@@ -0,0 +1,8 @@
+#include <time.h>
+#include "timing.h"
+
+double wallSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,10 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+/**
+ * Monotonic wall-clock time in seconds since an arbitrary origin.
+ * Only differences between two calls are meaningful.
+ */
+double wallSeconds(void);
+
+#endif
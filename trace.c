@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "timing.h"
+#include "trace.h"
+
+#define TRACE_BLOCK_EVENTS 1024
+
+typedef struct {
+    const char* name;
+    double start;
+    double end;
+    const char* key[2];
+    long long value[2];
+} TraceEvent;
+
+typedef struct TraceBlock {
+    struct TraceBlock* next;
+    int count;
+    TraceEvent events[TRACE_BLOCK_EVENTS];
+} TraceBlock;
+
+// One per recording thread. Only its thread appends; the writer reads it
+// after the threads are done.
+typedef struct TraceBuffer {
+    struct TraceBuffer* next;
+    int tid;
+    const char* threadName;
+    TraceBlock* first;
+    TraceBlock* last;
+} TraceBuffer;
+
+static atomic_int traceOn;
+static _Atomic(TraceBuffer*) buffers;
+static atomic_int nextTid;
+static FILE* traceFile;
+static int traceOpened;     // a closed trace is not reopened: buffers are gone
+static double origin;
+static _Thread_local TraceBuffer* localBuffer;
+
+static TraceBuffer* threadBuffer(void) {
+    TraceBuffer* b = localBuffer;
+    if (b) return b;
+    b = calloc(1, sizeof(TraceBuffer));
+    if (!b) return NULL;
+    b->tid = atomic_fetch_add(&nextTid, 1) + 1;
+    TraceBuffer* head = atomic_load(&buffers);
+    do {
+        b->next = head;
+    } while (!atomic_compare_exchange_weak(&buffers, &head, b));
+    localBuffer = b;
+    return b;
+}
+
+int traceOpen(const char* path) {
+    if (traceOpened) return traceFile ? 0 : -1;
+    traceFile = fopen(path, "w");
+    if (!traceFile) return -1;
+    traceOpened = 1;
+    origin = wallSeconds();
+    atomic_store(&traceOn, 1);
+    traceThreadName("main");
+    atexit(traceClose);
+    return 0;
+}
+
+double traceBegin(void) {
+    if (!atomic_load_explicit(&traceOn, memory_order_relaxed)) return 0.0;
+    return wallSeconds();
+}
+
+void traceEnd(double start, const char* name) {
+    traceEndArgs(start, name, NULL, 0, NULL, 0);
+}
+
+void traceEndArgs(double start, const char* name,
+                  const char* key1, long long value1,
+                  const char* key2, long long value2) {
+    if (start == 0.0 || !atomic_load_explicit(&traceOn, memory_order_relaxed)) return;
+    double end = wallSeconds();
+    TraceBuffer* b = threadBuffer();
+    if (!b) return;
+    if (!b->last || b->last->count == TRACE_BLOCK_EVENTS) {
+        TraceBlock* block = malloc(sizeof(TraceBlock));
+        if (!block) return;
+        block->next = NULL;
+        block->count = 0;
+        if (b->last) b->last->next = block;
+        else b->first = block;
+        b->last = block;
+    }
+    TraceEvent* e = &b->last->events[b->last->count++];
+    e->name = name;
+    e->start = start;
+    e->end = end;
+    e->key[0] = key1;
+    e->value[0] = value1;
+    e->key[1] = key2;
+    e->value[1] = value2;
+}
+
+void traceThreadName(const char* name) {
+    if (!atomic_load_explicit(&traceOn, memory_order_relaxed)) return;
+    TraceBuffer* b = threadBuffer();
+    if (b) b->threadName = name;
+}
+
+static void writeEvent(FILE* f, int tid, const TraceEvent* e) {
+    // Chrome "complete" events; times are microseconds since traceOpen
+    fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+            e->name, tid, (e->start - origin) * 1e6, (e->end - e->start) * 1e6);
+    if (e->key[0] || e->key[1]) {
+        fprintf(f, ",\"args\":{");
+        int first = 1;
+        for (int i = 0; i < 2; i++) {
+            if (!e->key[i]) continue;
+            fprintf(f, "%s\"%s\":%lld", first ? "" : ",", e->key[i], e->value[i]);
+            first = 0;
+        }
+        fputc('}', f);
+    }
+    fputc('}', f);
+}
+
+void traceClose(void) {
+    if (!traceFile) return;
+    atomic_store(&traceOn, 0);
+    FILE* f = traceFile;
+    traceFile = NULL;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"aac\"}}");
+    TraceBuffer* b = atomic_exchange(&buffers, NULL);
+    while (b) {
+        if (b->threadName) {
+            fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                       "\"args\":{\"name\":\"%s\"}}", b->tid, b->threadName);
+        }
+        for (TraceBlock* block = b->first; block; ) {
+            for (int i = 0; i < block->count; i++) writeEvent(f, b->tid, &block->events[i]);
+            TraceBlock* next = block->next;
+            free(block);
+            block = next;
+        }
+        TraceBuffer* next = b->next;
+        free(b);
+        b = next;
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+}
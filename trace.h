@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * =============================================================================
+ * TIMELINE TRACING
+ * =============================================================================
+ * Records when each solver phase ran, on which thread, and writes the
+ * spans as Chrome trace JSON (load it in chrome://tracing or
+ * ui.perfetto.dev). Spans cover loading, prefiltering, every exact level
+ * k and (kv, ke) split, every greedy strategy and restart, and the tasks
+ * of the parallel workers.
+ *
+ * A span is timed by its caller:
+ *
+ *     double t = traceBegin();
+ *     ...
+ *     traceEndArgs(t, "exact level", "k", k, NULL, 0);
+ *
+ * Each thread appends to its own buffer; a buffer is linked into a global
+ * list with one compare-and-swap on the thread's first event, so recording
+ * never takes a lock. Names and argument keys must be string literals (only
+ * the pointers are stored).
+ *
+ * Nothing is recorded until traceOpen. Afterwards the buffers are written
+ * at process exit (or by traceClose), which must not race with threads
+ * that are still recording. When tracing is off traceBegin returns 0 and
+ * traceEnd ignores a start of 0, so a disabled span costs one atomic load.
+ * =============================================================================
+ */
+
+/**
+ * Starts recording; the trace is written to `path` at exit. Returns 0, or
+ * -1 if the file cannot be created. A process records at most one trace.
+ */
+int traceOpen(const char* path);
+
+/** Writes the recorded spans and stops recording. Safe to call twice. */
+void traceClose(void);
+
+/** Current time for a span start, or 0 when tracing is off. */
+double traceBegin(void);
+
+/**
+ * Records a span from `start` to now. `start` is a traceBegin value, or a
+ * wallSeconds value the caller already took for its own timing.
+ */
+void traceEnd(double start, const char* name);
+
+/** traceEnd with up to two integer arguments (a NULL key is skipped). */
+void traceEndArgs(double start, const char* name,
+                  const char* key1, long long value1,
+                  const char* key2, long long value2);
+
+/** Names the calling thread in the trace viewer. */
+void traceThreadName(const char* name);
+
+#endif // TRACE_H